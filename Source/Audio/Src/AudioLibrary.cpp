@@ -153,7 +153,7 @@ Sample* LoadSample( MemChunk* LoadChunk, const TCHAR* SampleName )
 	if (LoadChunk == NULL)
 		return NULL;
 
-	Sample* lSample = (Sample*) appMalloc( sizeof(Sample), SampleName );
+	Sample* lSample = (Sample*) appMalloc( sizeof(Sample), TEXT("Sample") );
 	if (lSample == NULL)
 		return NULL;
 
@@ -302,10 +302,15 @@ CORE_API extern FTransactionBase*		GUndo;
 CORE_API extern FOutputDevice*			GLogHook;
 CORE_API extern FExec*					GExec;
 CORE_API extern FMalloc*				GMalloc;
+CORE_API extern class FMallocTracker*	GMallocTracker;
 CORE_API extern FFileManager*			GFileManager;
 CORE_API extern USystem*				GSys;
 CORE_API extern UProperty*				GProperty;
 CORE_API extern BYTE*					GPropAddr;
+CORE_API extern INT						GCallCacheEpoch;
+CORE_API extern DWORD					GCallCacheHits;
+CORE_API extern DWORD					GCallCacheMisses;
+CORE_API extern class FScriptProfiler*	GScriptProfiler;
 CORE_API extern USubsystem*				GWindowManager;
 CORE_API extern TCHAR				    GErrorHist[4096];
 CORE_API extern TCHAR                   GTrue[64], GFalse[64], GYes[64], GNo[64], GNone[64];
@@ -13,6 +13,7 @@ Revision history:
 class FCodec
 {
 public:
+	virtual ~FCodec() {}
 	virtual UBOOL Encode( FArchive& In, FArchive& Out )=0;
 	virtual UBOOL Decode( FArchive& In, FArchive& Out )=0;
 };
@@ -75,14 +76,16 @@ public:
 	UBOOL Decode( FArchive& In, FArchive& Out )
 	{
 		guard(FCodecBWT::Decode);
-		TArray<BYTE> DecompressBuffer(MAX_BUFFER_SIZE+1);
-		TArray<INT>  Temp(MAX_BUFFER_SIZE+1);
+		// A run can't be longer than the input, so small inputs need less.
+		INT BufferSize = Min<INT>( In.TotalSize(), MAX_BUFFER_SIZE )+1;
+		TArray<BYTE> DecompressBuffer(BufferSize);
+		TArray<INT>  Temp(BufferSize);
 		INT DecompressLength, DecompressCount[256+1], RunningTotal[256+1], i, j;
 		while( !In.AtEnd() )
 		{
 			INT First, Last;
 			In << DecompressLength << First << Last;
-			check(DecompressLength<=MAX_BUFFER_SIZE+1);
+			check(DecompressLength<BufferSize);
 			check(DecompressLength<=In.TotalSize()-In.Tell());
 			In.Serialize( &DecompressBuffer(0), ++DecompressLength );
 			for( i=0; i<257; i++ )
@@ -101,8 +104,11 @@ public:
 				INT Index = i!=Last ? DecompressBuffer(i) : 256;
 				Temp(RunningTotal[Index] + DecompressCount[Index]++) = i;
 			}
+			TArray<BYTE> OutBuffer( DecompressLength-1 );
 			for( i=First,j=0 ; j<DecompressLength-1; i=Temp(i),j++ )
-				Out << DecompressBuffer(i);
+				OutBuffer(j) = DecompressBuffer(i);
+			if( OutBuffer.Num() )
+				Out.Serialize( &OutBuffer(0), OutBuffer.Num() );
 		}
 		return 1;
 		unguard;
@@ -119,7 +125,7 @@ class FCodecRLE : public FCodec
 {
 private:
 	enum {RLE_LEAD=5};
-	UBOOL EncodeEmitRun( FArchive& Out, BYTE Char, BYTE Count )
+	void EncodeEmitRun( FArchive& Out, BYTE Char, BYTE Count )
 	{
 		for( INT Down=Min<INT>(Count,RLE_LEAD); Down>0; Down-- )
 			Out << Char;
@@ -149,12 +155,16 @@ public:
 	UBOOL Decode( FArchive& In, FArchive& Out )
 	{
 		guard(FCodecRLE::Decode);
+		TArray<BYTE> InBuffer( In.TotalSize()-In.Tell() ), OutBuffer;
+		if( InBuffer.Num() )
+			In.Serialize( &InBuffer(0), InBuffer.Num() );
+		OutBuffer.Empty( InBuffer.Num()*2 );
 		INT Count=0;
 		BYTE PrevChar=0, B, C;
-		while( !In.AtEnd() )
+		for( INT i=0; i<InBuffer.Num(); )
 		{
-			In << B;
-			Out << B;
+			B = InBuffer(i++);
+			OutBuffer.AddItem( B );
 			if( B!=PrevChar )
 			{
 				PrevChar = B;
@@ -162,13 +172,16 @@ public:
 			}
 			else if( ++Count==RLE_LEAD )
 			{
-				In << C;
+				check(i<InBuffer.Num());
+				C = InBuffer(i++);
 				check(C>=2);
 				while( C-->RLE_LEAD )
-					Out << B;
+					OutBuffer.AddItem( B );
 				Count = 0;
 			}
 		}
+		if( OutBuffer.Num() )
+			Out.Serialize( &OutBuffer(0), OutBuffer.Num() );
 		return 1;
 		unguard;
 	}
@@ -302,19 +315,29 @@ public:
 		INT Total;
 		In << Total;
 		TArray<BYTE> InArray( In.TotalSize()-In.Tell() );
-		In.Serialize( &InArray(0), InArray.Num() );
-		FBitReader Reader( &InArray(0), InArray.Num()*8 );
+		BYTE* Data = InArray.Num() ? &InArray(0) : NULL;
+		if( Data )
+			In.Serialize( Data, InArray.Num() );
+		FBitReader Reader( Data, InArray.Num()*8 );
 		FHuffman Root(-1);
 		Root.ReadTable( Reader );
-		while( Total-- > 0 )
+
+		// Walk the tree straight off the bytes, ReadBit is too slow per bit.
+		TArray<BYTE> OutArray( Total );
+		INT Bit = Reader.GetPosBits(), NumBits = InArray.Num()*8;
+		for( INT i=0; i<Total; i++ )
 		{
-			check(!Reader.AtEnd());
 			FHuffman* Node = &Root;
 			while( Node->Ch==-1 )
-				Node = Node->Child( Reader.ReadBit() );
-			BYTE B = Node->Ch;
-			Out << B;
+			{
+				check(Bit<NumBits);
+				Node = Node->Child( (Data[Bit>>3]>>(Bit&7))&1 );
+				Bit++;
+			}
+			OutArray(i) = Node->Ch;
 		}
+		if( OutArray.Num() )
+			Out.Serialize( &OutArray(0), OutArray.Num() );
 		return 1;
 		unguard;
 	}
@@ -344,7 +367,7 @@ public:
 			C = i;
 			Out << C;
 			INT NewPos=0;
-			for( i; i>NewPos; i-- )
+			for( ; i>NewPos; i-- )
 				List[i]=List[i-1];
 			List[NewPos] = B;
 		}
@@ -358,16 +381,21 @@ public:
 		INT i;
 		for( i=0; i<256; i++ )
 			List[i] = i;
-		while( !In.AtEnd() )
+		TArray<BYTE> Buffer( In.TotalSize()-In.Tell() );
+		if( Buffer.Num() )
+			In.Serialize( &Buffer(0), Buffer.Num() );
+		for( INT j=0; j<Buffer.Num(); j++ )
 		{
-			In << B;
+			B = Buffer(j);
 			C = List[B];
-			Out << C;
+			Buffer(j) = C;
 			INT NewPos=0;
 			for( i=B; i>NewPos; i-- )
 				List[i]=List[i-1];
 			List[NewPos] = C;
 		}
+		if( Buffer.Num() )
+			Out.Serialize( &Buffer(0), Buffer.Num() );
 		return 1;
 		unguard;
 	}
@@ -402,14 +430,14 @@ public:
 	UBOOL Encode( FArchive& In, FArchive& Out )
 	{
 		guard(FCodecFull::Encode);
-		Code( In, Out, 1, 0, FCodec::Encode );
+		Code( In, Out, 1, 0, &FCodec::Encode );
 		return 0;
 		unguard;
 	}
 	UBOOL Decode( FArchive& In, FArchive& Out )
 	{
 		guard(FCodecFull::Decode);
-		Code( In, Out, -1, Codecs.Num()-1, FCodec::Decode );
+		Code( In, Out, -1, Codecs.Num()-1, &FCodec::Decode );
 		return 1;
 		unguard;
 	}
@@ -10,6 +10,10 @@
 #include <unistd.h>
 #include <sys/stat.h>
 #include <cerrno>
+#ifndef PLATFORM_DREAMCAST
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
 #include "FFileManagerGeneric.h"
 
 /*-----------------------------------------------------------------------------
@@ -131,6 +135,83 @@ protected:
 	INT				BufferCount;
 	BYTE			Buffer[1024];
 };
+#ifndef PLATFORM_DREAMCAST
+// Reader for a file mapped into memory as a whole. Reads are plain copies
+// out of the mapping and the kernel pages the file in as it is touched.
+class FArchiveFileMapping : public FArchive
+{
+public:
+	FArchiveFileMapping( BYTE* InData, FOutputDevice* InError, INT InSize )
+	:	Data			( InData )
+	,	Error			( InError )
+	,	Size			( InSize )
+	,	Pos				( 0 )
+	{
+		ArIsLoading = ArIsPersistent = 1;
+	}
+	~FArchiveFileMapping()
+	{
+		guard(FArchiveFileMapping::~FArchiveFileMapping);
+		if( Data )
+			Close();
+		unguard;
+	}
+	void Precache( INT HintCount )
+	{
+		guardSlow(FArchiveFileMapping::Precache);
+		// Ask for the pages about to be read so the fault-ins are batched.
+		INT   Count = Min( HintCount, Size-Pos );
+		DWORD Page  = (DWORD)getpagesize();
+		DWORD Start = (DWORD)Pos & ~(Page-1);
+		if( Count>0 )
+			madvise( Data+Start, Pos+Count-Start, MADV_WILLNEED );
+		unguardSlow;
+	}
+	void Seek( INT InPos )
+	{
+		guard(FArchiveFileMapping::Seek);
+		check(InPos>=0);
+		check(InPos<=Size);
+		Pos = InPos;
+		unguard;
+	}
+	INT Tell()
+	{
+		return Pos;
+	}
+	INT TotalSize()
+	{
+		return Size;
+	}
+	UBOOL Close()
+	{
+		guardSlow(FArchiveFileMapping::Close);
+		if( Data )
+			munmap( Data, Size );
+		Data = NULL;
+		return !ArIsError;
+		unguardSlow;
+	}
+	void Serialize( void* V, INT Length )
+	{
+		guardSlow(FArchiveFileMapping::Serialize);
+		if( Length>Size-Pos )
+		{
+			ArIsError = 1;
+			Error->Logf( TEXT("ReadFile beyond EOF %i+%i/%i"), Pos, Length, Size );
+			return;
+		}
+		appMemcpy( V, Data+Pos, Length );
+		Pos += Length;
+		unguardSlow;
+	}
+protected:
+	BYTE*			Data;
+	FOutputDevice*	Error;
+	INT				Size;
+	INT				Pos;
+};
+#endif
 class FArchiveFileWriter : public FArchive
 {
 public:
@@ -213,9 +294,38 @@ protected:
 class FFileManagerLinux : public FFileManagerGeneric
 {
 public:
+	// Files at least this big are mapped rather than read through a buffer.
+	enum {MAP_MIN_SIZE = 65536};
+
+	FFileManagerLinux()
+	:	MapFiles( -1 )
+	{}
 	FArchive* CreateFileReader( const TCHAR* Filename, DWORD Flags, FOutputDevice* Error )
 	{
 		guard(FFileManagerLinux::CreateFileReader);
+#ifndef PLATFORM_DREAMCAST
+		if( MapFiles<0 )
+			MapFiles = !ParseParam( appCmdLine(), TEXT("NOMMAP") );
+		if( MapFiles )
+		{
+			INT Handle = open( TCHAR_TO_ANSI(Filename), O_RDONLY );
+			if( Handle<0 )
+			{
+				if( Flags & FILEREAD_NoFail )
+					appErrorf(TEXT("Failed to read file: %s"),Filename);
+				return NULL;
+			}
+			struct stat Info;
+			if( fstat( Handle, &Info )==0 && Info.st_size>=MAP_MIN_SIZE && Info.st_size<=MAXINT )
+			{
+				void* Data = mmap( NULL, Info.st_size, PROT_READ, MAP_PRIVATE, Handle, 0 );
+				close( Handle );
+				if( Data!=MAP_FAILED )
+					return new(TEXT("LinuxFileMapping"))FArchiveFileMapping((BYTE*)Data,Error,Info.st_size);
+			}
+			else close( Handle );
+		}
+#endif
 		FILE* File = fopen(TCHAR_TO_ANSI(Filename), TCHAR_TO_ANSI(TEXT("rb")));
 		if( !File )
 		{
@@ -427,6 +537,8 @@ public:
 		}
 		unguard;
 	}
+protected:
+	INT MapFiles; // Whether to map big files, -1 until the command line is checked.
 };
 
 /*-----------------------------------------------------------------------------
@@ -0,0 +1,544 @@
+/*=============================================================================
+	FMallocPool.h: Portable pooled memory allocator.
+	Copyright 1997-1999 Epic Games, Inc. All Rights Reserved.
+
+	Small blocks come from fixed size chunks carved into one size class each,
+	so TArray, FString and UObject churn doesn't fragment the libc heap over
+	a long session. Anything bigger than the largest class goes to libc.
+
+	Revision history:
+		* Created from FMallocWindows for Linux and Dreamcast.
+=============================================================================*/
+
+#include "FMallocTags.h"
+
+//
+// Pooled allocator with per-tag accounting.
+//
+class FMallocPool : public FMalloc
+{
+private:
+	// Counts.
+	enum {POOL_COUNT = 28    };
+	enum {POOL_MAX   = 4096+1};
+#ifdef PLATFORM_DREAMCAST
+	enum {CHUNK_SIZE = 16384 };
+#else
+	enum {CHUNK_SIZE = 65536 };
+#endif
+
+	// Forward declares.
+	struct FFreeMem;
+	struct FPoolTable;
+
+	// Chunk header, stored at the start of each chunk.
+	struct FPoolInfoBase
+	{
+		FPoolTable* Table;		// Size class of this chunk.
+		FFreeMem*   FirstMem;	// First freed block.
+		BYTE*       Unused;		// First block never handed out.
+		BYTE*       Blocks;		// First block.
+		DWORD       Taken;		// Number of allocated blocks, chunk is freed when counts down to zero.
+		BYTE*       Tags;		// Tag index of each block.
+	};
+	typedef TDoubleLinkedList<FPoolInfoBase> FPoolInfo;
+
+	// A freed block.
+	struct FFreeMem
+	{
+		FFreeMem*	Next;
+	};
+
+	// Size class.
+	struct FPoolTable
+	{
+		FPoolInfo*  FirstPool;		// Chunks with free blocks.
+		FPoolInfo*  ExaustedPool;	// Full chunks.
+		DWORD       BlockSize;
+		DWORD       BlockCount;		// Blocks per chunk.
+		DWORD       HeaderSize;		// Chunk bytes before the first block.
+		INT         ChunkCount;
+		INT         TotalAllocs;
+		DWORD       Requested;		// Bytes the callers asked for, to measure rounding waste.
+	};
+
+	// Header in front of each allocation too large to pool. 16 bytes.
+	struct FLargeHeader
+	{
+		DWORD       Size;
+		DWORD       Tag;
+		DWORD       Magic;
+		DWORD       Pad;
+	};
+	enum {LARGE_MAGIC = 0x4c726745};
+
+	// Variables.
+	FPoolTable   PoolTable[POOL_COUNT];
+	FPoolTable*  MemSizeToPoolTable[(POOL_MAX+15)>>4];
+	FPoolInfo**  ChunkHash;
+	DWORD        ChunkHashSize;
+	DWORD        ChunkHashCount;
+	FMallocTagStats TagStats[FMallocTags::TAG_COUNT];
+	FMallocLock  Lock;
+	INT          MemInit;
+
+	// Stats.
+	SIZE_T       OsCurrent,OsPeak,UsedCurrent,UsedPeak;
+	SIZE_T       LargeCurrent,LargeCount;
+	INT          CurrentAllocs,TotalAllocs;
+
+	// Chunk lookup. Chunks are aligned to CHUNK_SIZE, so any block address
+	// masks down to its chunk, which is found in an open addressed table.
+	static SIZE_T ChunkBase( void* Ptr )
+	{
+		return (SIZE_T)Ptr & ~(SIZE_T)(CHUNK_SIZE-1);
+	}
+	DWORD ChunkSlot( SIZE_T Base )
+	{
+		return (DWORD)((Base / CHUNK_SIZE) * 2654435761u) & (ChunkHashSize-1);
+	}
+	FPoolInfo* FindChunk( void* Ptr )
+	{
+		if( !ChunkHashCount )
+			return NULL;
+		SIZE_T Base = ChunkBase( Ptr );
+		for( DWORD i=ChunkSlot(Base); ChunkHash[i]; i=(i+1)&(ChunkHashSize-1) )
+			if( (SIZE_T)ChunkHash[i]==Base )
+				return ChunkHash[i];
+		return NULL;
+	}
+	void InsertChunk( FPoolInfo* Pool )
+	{
+		if( (ChunkHashCount+1)*2 > ChunkHashSize )
+		{
+			FPoolInfo** OldHash     = ChunkHash;
+			DWORD       OldHashSize = ChunkHashSize;
+			ChunkHashSize = Max<DWORD>( 64, OldHashSize*2 );
+			ChunkHash     = (FPoolInfo**)calloc( ChunkHashSize, sizeof(FPoolInfo*) );
+			check(ChunkHash);
+			ChunkHashCount = 0;
+			for( DWORD i=0; i<OldHashSize; i++ )
+				if( OldHash[i] )
+					InsertChunk( OldHash[i] );
+			free( OldHash );
+		}
+		DWORD i = ChunkSlot( (SIZE_T)Pool );
+		while( ChunkHash[i] )
+			i = (i+1)&(ChunkHashSize-1);
+		ChunkHash[i] = Pool;
+		ChunkHashCount++;
+	}
+	void RemoveChunk( FPoolInfo* Pool )
+	{
+		DWORD Mask = ChunkHashSize-1;
+		DWORD i    = ChunkSlot( (SIZE_T)Pool );
+		while( ChunkHash[i]!=Pool )
+			i = (i+1)&Mask;
+		ChunkHash[i] = NULL;
+		ChunkHashCount--;
+
+		// Shift later entries of the same run back so lookups never stop early.
+		for( DWORD j=(i+1)&Mask; ChunkHash[j]; j=(j+1)&Mask )
+		{
+			DWORD k = ChunkSlot( (SIZE_T)ChunkHash[j] );
+			if( i<=j ? (k<=i || k>j) : (k<=i && k>j) )
+			{
+				ChunkHash[i] = ChunkHash[j];
+				ChunkHash[j] = NULL;
+				i            = j;
+			}
+		}
+	}
+
+	// Tag accounting, by the index GMallocTags gives each tag.
+	BYTE FindTag( const TCHAR* Tag )
+	{
+#if STATS
+		return GMallocTags.FindTag( Tag );
+#else
+		return 0;
+#endif
+	}
+	void TagAlloc( BYTE Tag, SIZE_T Bytes )
+	{
+		STAT(TagStats[Tag].Alloc( Bytes ));
+	}
+	void TagFree( BYTE Tag, SIZE_T Bytes )
+	{
+		STAT(TagStats[Tag].Free( Bytes ));
+	}
+
+	// Chunk management.
+	FPoolInfo* AllocateChunk( FPoolTable* Table )
+	{
+		FPoolInfo* Pool = (FPoolInfo*)memalign( CHUNK_SIZE, CHUNK_SIZE );
+		if( !Pool )
+			appErrorf( NAME_FriendlyError, TEXT("Ran out of memory allocating %i bytes"), (INT)CHUNK_SIZE );
+		Pool->Table    = Table;
+		Pool->FirstMem = NULL;
+		Pool->Tags     = (BYTE*)(Pool+1);
+		Pool->Blocks   = (BYTE*)Pool + Table->HeaderSize;
+		Pool->Unused   = Pool->Blocks;
+		Pool->Taken    = 0;
+		Pool->Link( Table->FirstPool );
+		InsertChunk( Pool );
+		Table->ChunkCount++;
+		STAT(OsCurrent += CHUNK_SIZE);
+		STAT(OsPeak = Max(OsPeak,OsCurrent));
+		return Pool;
+	}
+	void FreeChunk( FPoolInfo* Pool )
+	{
+		Pool->Unlink();
+		RemoveChunk( Pool );
+		Pool->Table->ChunkCount--;
+		STAT(OsCurrent -= CHUNK_SIZE);
+		free( Pool );
+	}
+	DWORD BlockIndex( FPoolInfo* Pool, void* Ptr )
+	{
+		return ((BYTE*)Ptr - Pool->Blocks) / Pool->Table->BlockSize;
+	}
+
+	// Unlocked allocation and freeing.
+	void* MallocInternal( DWORD Size, BYTE Tag )
+	{
+		STAT(CurrentAllocs++);
+		STAT(TotalAllocs++);
+		void* Result;
+		if( Size<POOL_MAX )
+		{
+			FPoolTable* Table = MemSizeToPoolTable[(Size+15)>>4];
+			checkSlow(Size<=Table->BlockSize);
+			FPoolInfo* Pool = Table->FirstPool;
+			if( !Pool )
+				Pool = AllocateChunk( Table );
+			if( Pool->FirstMem )
+			{
+				Result         = Pool->FirstMem;
+				Pool->FirstMem = Pool->FirstMem->Next;
+			}
+			else
+			{
+				Result        = Pool->Unused;
+				Pool->Unused += Table->BlockSize;
+			}
+			if( ++Pool->Taken==Table->BlockCount )
+			{
+				// Move to exausted list.
+				Pool->Unlink();
+				Pool->Link( Table->ExaustedPool );
+			}
+			Pool->Tags[BlockIndex(Pool,Result)] = Tag;
+			STAT(Table->TotalAllocs++);
+			STAT(Table->Requested += Size);
+			STAT(UsedCurrent += Table->BlockSize);
+			TagAlloc( Tag, Table->BlockSize );
+		}
+		else
+		{
+			FLargeHeader* Header = (FLargeHeader*)malloc( sizeof(FLargeHeader) + Size );
+			if( !Header )
+				appErrorf( NAME_FriendlyError, TEXT("Ran out of memory allocating %u bytes"), Size );
+			Header->Size  = Size;
+			Header->Tag   = Tag;
+			Header->Magic = LARGE_MAGIC;
+			Result        = Header+1;
+			STAT(LargeCount++);
+			STAT(LargeCurrent += Size);
+			STAT(OsCurrent += Size);
+			STAT(OsPeak = Max(OsPeak,OsCurrent));
+			STAT(UsedCurrent += Size);
+			TagAlloc( Tag, Size );
+		}
+		STAT(UsedPeak = Max(UsedPeak,UsedCurrent));
+		return Result;
+	}
+	void FreeInternal( void* Ptr )
+	{
+		STAT(CurrentAllocs--);
+		if( FPoolInfo* Pool=FindChunk(Ptr) )
+		{
+			FPoolTable* Table = Pool->Table;
+			checkSlow(((BYTE*)Ptr-Pool->Blocks)%Table->BlockSize==0);
+			if( Pool->Taken==Table->BlockCount )
+			{
+				// Move from exausted list back to free list.
+				Pool->Unlink();
+				Pool->Link( Table->FirstPool );
+			}
+			FFreeMem* Free = (FFreeMem*)Ptr;
+			Free->Next     = Pool->FirstMem;
+			Pool->FirstMem = Free;
+			STAT(UsedCurrent -= Table->BlockSize);
+			TagFree( Pool->Tags[BlockIndex(Pool,Ptr)], Table->BlockSize );
+
+			// Free the chunk once empty, but keep the last one of each class
+			// around so a single block allocated and freed in a loop doesn't
+			// go back to libc every time.
+			if( --Pool->Taken==0 && (Table->FirstPool!=Pool || Pool->Next) )
+				FreeChunk( Pool );
+		}
+		else
+		{
+			FLargeHeader* Header = (FLargeHeader*)Ptr - 1;
+			check(Header->Magic==LARGE_MAGIC);
+			Header->Magic = 0;
+			STAT(LargeCount--);
+			STAT(LargeCurrent -= Header->Size);
+			STAT(OsCurrent -= Header->Size);
+			STAT(UsedCurrent -= Header->Size);
+			TagFree( Header->Tag, Header->Size );
+			free( Header );
+		}
+	}
+	// Whether Ptr came from this allocator. Blocks libc handed out before
+	// the pool was installed, or that a driver got from memalign, don't.
+	UBOOL Owns( void* Ptr )
+	{
+		return FindChunk(Ptr) || ((FLargeHeader*)Ptr - 1)->Magic==LARGE_MAGIC;
+	}
+	DWORD AllocationSize( void* Ptr )
+	{
+		if( FPoolInfo* Pool=FindChunk(Ptr) )
+			return Pool->Table->BlockSize;
+		return ((FLargeHeader*)Ptr - 1)->Size;
+	}
+
+public:
+	// FMalloc interface.
+	FMallocPool()
+	:	ChunkHash		( NULL )
+	,	ChunkHashSize	( 0 )
+	,	ChunkHashCount	( 0 )
+	,	MemInit			( 0 )
+	,	OsCurrent		( 0 )
+	,	OsPeak			( 0 )
+	,	UsedCurrent		( 0 )
+	,	UsedPeak		( 0 )
+	,	LargeCurrent	( 0 )
+	,	LargeCount		( 0 )
+	,	CurrentAllocs	( 0 )
+	,	TotalAllocs		( 0 )
+	{}
+	void* Malloc( DWORD Size, const TCHAR* Tag )
+	{
+		guard(FMallocPool::Malloc);
+		checkSlow(Size>=0);
+		checkSlow(MemInit);
+		FMallocLock::FScope Scope( Lock );
+		return MallocInternal( Max<DWORD>(Size,1), FindTag(Tag) );
+		unguard;
+	}
+	void* Realloc( void* Ptr, DWORD NewSize, const TCHAR* Tag )
+	{
+		guard(FMallocPool::Realloc);
+		checkSlow(MemInit);
+		FMallocLock::FScope Scope( Lock );
+		if( Ptr && !Owns(Ptr) )
+		{
+			// Not ours, leave it with libc.
+			if( NewSize )
+				return realloc( Ptr, NewSize );
+			free( Ptr );
+			return NULL;
+		}
+		void* NewPtr = Ptr;
+		if( Ptr && NewSize )
+		{
+			// Stay in place while the new size falls in the same class.
+			DWORD OldSize = AllocationSize( Ptr );
+			if( NewSize>=POOL_MAX || OldSize>=POOL_MAX || MemSizeToPoolTable[(NewSize+15)>>4]->BlockSize!=OldSize )
+			{
+				NewPtr = MallocInternal( NewSize, FindTag(Tag) );
+				appMemcpy( NewPtr, Ptr, Min(NewSize,OldSize) );
+				FreeInternal( Ptr );
+			}
+		}
+		else if( Ptr == NULL )
+		{
+			NewPtr = NewSize ? MallocInternal( NewSize, FindTag(Tag) ) : NULL;
+		}
+		else
+		{
+			FreeInternal( Ptr );
+			NewPtr = NULL;
+		}
+		return NewPtr;
+		unguardf(( TEXT("%08X %i %s"), (INT)(SIZE_T)Ptr, NewSize, Tag ));
+	}
+	void Free( void* Ptr )
+	{
+		guard(FMallocPool::Free);
+		checkSlow(MemInit);
+		if( !Ptr )
+			return;
+		FMallocLock::FScope Scope( Lock );
+		if( Owns(Ptr) )
+			FreeInternal( Ptr );
+		else
+			free( Ptr );
+		unguard;
+	}
+	void DumpAllocs()
+	{
+		guard(FMallocPool::DumpAllocs);
+		FMallocPool::HeapCheck();
+		FMallocLock::FScope Scope( Lock );
+
+		STAT(debugf( TEXT("Memory Allocation Status") ));
+		STAT(debugf( TEXT("Curr Memory % 5.3fM / % 5.3fM"), UsedCurrent/1024.0/1024.0, OsCurrent/1024.0/1024.0 ));
+		STAT(debugf( TEXT("Peak Memory % 5.3fM / % 5.3fM"), UsedPeak   /1024.0/1024.0, OsPeak   /1024.0/1024.0 ));
+		STAT(debugf( TEXT("Allocs      % 6i Current / % 6i Total"), CurrentAllocs, TotalAllocs ));
+
+#if STATS
+		// Size classes. Mem Free is space inside chunks no allocation holds,
+		// which is what fragmentation costs; Mem Round is what rounding
+		// requests up to the block size costs.
+		debugf( TEXT("Block Size Num Chunks Cur Allocs Total Allocs Mem Used Mem Free Mem Round Efficiency") );
+		debugf( TEXT("---------- ---------- ---------- ------------ -------- -------- --------- ----------") );
+		SIZE_T TotalChunkMem=0, TotalUsed=0, TotalFree=0;
+		INT    TotalChunks=0, TotalCurAllocs=0, TotalClassAllocs=0;
+		for( INT i=0; i<POOL_COUNT; i++ )
+		{
+			FPoolTable* Table = &PoolTable[i];
+			INT AllocCount=0;
+			for( INT j=0; j<2; j++ )
+				for( FPoolInfo* Pool=(j?Table->FirstPool:Table->ExaustedPool); Pool; Pool=Pool->Next )
+					AllocCount += Pool->Taken;
+			SIZE_T ChunkMem = (SIZE_T)Table->ChunkCount * CHUNK_SIZE;
+			SIZE_T MemUsed  = (SIZE_T)AllocCount * Table->BlockSize;
+			SIZE_T MemFree  = ChunkMem - MemUsed;
+			DWORD  Round    = Table->TotalAllocs ? Table->BlockSize - (DWORD)((QWORD)Table->Requested / Table->TotalAllocs) : 0;
+			debugf
+			(
+				TEXT("% 10i % 10i % 10i % 12i % 7iK % 7iK % 8iB % 9.2f%%"),
+				Table->BlockSize,
+				Table->ChunkCount,
+				AllocCount,
+				Table->TotalAllocs,
+				(INT)(MemUsed/1024),
+				(INT)(MemFree/1024),
+				Round,
+				ChunkMem ? 100.0 * MemUsed / ChunkMem : 100.0
+			);
+			TotalChunkMem    += ChunkMem;
+			TotalUsed        += MemUsed;
+			TotalFree        += MemFree;
+			TotalChunks      += Table->ChunkCount;
+			TotalCurAllocs   += AllocCount;
+			TotalClassAllocs += Table->TotalAllocs;
+		}
+		debugf
+		(
+			TEXT("BlkOverall % 10i % 10i % 12i % 7iK % 7iK % 8s % 9.2f%%"),
+			TotalChunks,
+			TotalCurAllocs,
+			TotalClassAllocs,
+			(INT)(TotalUsed/1024),
+			(INT)(TotalFree/1024),
+			TEXT(""),
+			TotalChunkMem ? 100.0 * TotalUsed / TotalChunkMem : 100.0
+		);
+		debugf( TEXT("Large       % 6i Allocs / % 5.3fM"), (INT)LargeCount, LargeCurrent/1024.0/1024.0 );
+
+		// Tags.
+		GMallocTags.Dump( *GLog, TagStats, 0.0 );
+#endif
+		unguard;
+	}
+	void HeapCheck()
+	{
+		guard(FMallocPool::HeapCheck);
+		FMallocLock::FScope Scope( Lock );
+		for( INT i=0; i<POOL_COUNT; i++ )
+		{
+			FPoolTable* Table = &PoolTable[i];
+			INT ChunkCount = 0;
+			for( FPoolInfo** PoolPtr=&Table->FirstPool; *PoolPtr; PoolPtr=&(*PoolPtr)->Next )
+			{
+				FPoolInfo* Pool=*PoolPtr;
+				check(Pool->PrevLink==PoolPtr);
+				check(Pool->Table==Table);
+				check(Pool->Taken<Table->BlockCount);
+				check(FindChunk(Pool)==Pool);
+				DWORD FreeCount = 0;
+				for( FFreeMem* Free=Pool->FirstMem; Free; Free=Free->Next )
+				{
+					check(ChunkBase(Free)==(SIZE_T)Pool);
+					check((BYTE*)Free<Pool->Unused);
+					FreeCount++;
+				}
+				check(Pool->Taken+FreeCount==BlockIndex(Pool,Pool->Unused));
+				ChunkCount++;
+			}
+			for( FPoolInfo** PoolPtr=&Table->ExaustedPool; *PoolPtr; PoolPtr=&(*PoolPtr)->Next )
+			{
+				FPoolInfo* Pool=*PoolPtr;
+				check(Pool->PrevLink==PoolPtr);
+				check(Pool->Table==Table);
+				check(Pool->Taken==Table->BlockCount);
+				check(!Pool->FirstMem);
+				check(FindChunk(Pool)==Pool);
+				ChunkCount++;
+			}
+			check(ChunkCount==Table->ChunkCount);
+		}
+		unguard;
+	}
+	void Init()
+	{
+		guard(FMallocPool::Init);
+		check(!MemInit);
+		MemInit = 1;
+
+		// Init tables. Classes step by 16 bytes while small, then by a
+		// quarter of each power of two, so rounding waste stays under 25%.
+		static const DWORD BlockSizes[POOL_COUNT] =
+		{
+			  16,   32,   48,   64,   80,   96,  112,  128,
+			 160,  192,  224,  256,  320,  384,  448,  512,
+			 640,  768,  896, 1024, 1280, 1536, 1792, 2048,
+			2560, 3072, 3584, 4096
+		};
+		for( INT Index=0; Index<POOL_COUNT; Index++ )
+		{
+			DWORD       Size   = BlockSizes[Index];
+			FPoolTable& Table  = PoolTable[Index];
+			Table.FirstPool    = NULL;
+			Table.ExaustedPool = NULL;
+			Table.BlockSize    = Size;
+			Table.ChunkCount   = 0;
+			Table.TotalAllocs  = 0;
+			Table.Requested    = 0;
+
+			// Header is the chunk info plus one tag byte per block.
+			DWORD Fixed        = Align( sizeof(FPoolInfo), 16 );
+			Table.BlockCount   = (CHUNK_SIZE - Fixed) / (Size + 1);
+			Table.HeaderSize   = Align( sizeof(FPoolInfo) + Table.BlockCount, 16 );
+			while( Table.HeaderSize + Table.BlockCount*Size > CHUNK_SIZE )
+				Table.HeaderSize = Align( sizeof(FPoolInfo) + --Table.BlockCount, 16 );
+			check(Table.BlockCount>=1);
+		}
+
+		for( DWORD i=0, j=0; i<ARRAY_COUNT(MemSizeToPoolTable); i++ )
+		{
+			while( PoolTable[j].BlockSize < i*16 )
+				j++;
+			MemSizeToPoolTable[i] = &PoolTable[j];
+		}
+
+		appMemzero( TagStats, sizeof(TagStats) );
+		unguard;
+	}
+	void Exit()
+	{
+		guard(FMallocPool::Exit);
+		// Static destructors still free after this, so the pools stay.
+		unguard;
+	}
+};
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
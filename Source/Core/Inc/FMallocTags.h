@@ -0,0 +1,203 @@
+/*=============================================================================
+	FMallocTags.h: Allocation tag registry shared by the allocators.
+	Copyright 1997-1999 Epic Games, Inc. All Rights Reserved.
+
+	Maps the Tag passed to appMalloc to a small index. FMallocPool and
+	FMallocTracker both look tags up here, so a tag has the same index and
+	name in both, and each keeps only its own counts per index.
+
+	Revision history:
+		* Split out of FMallocPool and FMallocTracker.
+=============================================================================*/
+
+#ifndef _INC_FMALLOCTAGS
+#define _INC_FMALLOCTAGS
+
+//
+// Recursive allocator lock, as failing checks may log and allocate with
+// the lock held.
+//
+class FMallocLock
+{
+public:
+	FMallocLock()
+	{
+#ifdef PLATFORM_POSIX
+		pthread_mutexattr_t Attr;
+		pthread_mutexattr_init( &Attr );
+		pthread_mutexattr_settype( &Attr, PTHREAD_MUTEX_RECURSIVE );
+		pthread_mutex_init( &Mutex, &Attr );
+		pthread_mutexattr_destroy( &Attr );
+#endif
+	}
+
+	// Holds the lock for a scope.
+	struct FScope
+	{
+#ifdef PLATFORM_POSIX
+		FMallocLock& Lock;
+		FScope( FMallocLock& InLock ) : Lock( InLock ) { pthread_mutex_lock( &Lock.Mutex ); }
+		~FScope() { pthread_mutex_unlock( &Lock.Mutex ); }
+#else
+		FScope( FMallocLock& InLock ) {}
+#endif
+	};
+
+private:
+#ifdef PLATFORM_POSIX
+	pthread_mutex_t Mutex;
+#endif
+};
+
+//
+// Per tag counts, kept by each allocator for the indices it gets here.
+//
+struct FMallocTagStats
+{
+	INT			Allocs;			// Live allocations.
+	INT			Count;			// Allocations ever made.
+	SIZE_T		Bytes;			// Live bytes.
+	SIZE_T		Peak;
+	QWORD		TotalBytes;		// Bytes ever allocated.
+	INT			LastCount;		// Count at the last dump, for rates.
+	QWORD		LastBytes;
+
+	void Alloc( SIZE_T Size )
+	{
+		Allocs++;
+		Count++;
+		Bytes      += Size;
+		TotalBytes += Size;
+		Peak        = Max( Peak, Bytes );
+	}
+	void Free( SIZE_T Size )
+	{
+		Allocs--;
+		Bytes -= Size;
+	}
+};
+
+//
+// Tag registry.
+//
+class FMallocTags
+{
+public:
+	// Counts. Tag indices fit in a byte.
+	enum {TAG_COUNT = 256 };
+	enum {TAG_HASH  = 2048};
+
+	FMallocTags()
+	:	TagCount		( 1 )
+	,	TagHashCount	( 0 )
+	{
+		appMemzero( Names, sizeof(Names) );
+		appMemzero( TagHashKeys, sizeof(TagHashKeys) );
+		Names[0] = TEXT("Other");
+	}
+
+	// Tags are almost always string literals or class names, so the pointer
+	// is hashed first and names are only compared on a miss. Pointers to tags
+	// that didn't fit are cached too, as "Other". Both the name and the
+	// pointer are kept, so a tag must never be a temporary string.
+	BYTE FindTag( const TCHAR* Tag )
+	{
+		if( !Tag )
+			return 0;
+		FMallocLock::FScope Scope( Lock );
+		DWORD i = (DWORD)(((SIZE_T)Tag>>2) * 2654435761u) & (TAG_HASH-1);
+		for( ; TagHashKeys[i]; i=(i+1)&(TAG_HASH-1) )
+			if( TagHashKeys[i]==Tag )
+				return TagHashValues[i];
+		INT Index;
+		for( Index=1; Index<TagCount; Index++ )
+			if( appStrcmp(Names[Index],Tag)==0 )
+				break;
+		if( Index==TagCount )
+		{
+			if( TagCount<TAG_COUNT )
+				Names[TagCount++] = Tag;
+			else
+				Index = 0;
+		}
+		// Leave room in the hash so probes always end.
+		if( 2*(TagHashCount+1) < TAG_HASH )
+		{
+			TagHashKeys  [i] = Tag;
+			TagHashValues[i] = Index;
+			TagHashCount++;
+		}
+		return Index;
+	}
+	const TCHAR* GetName( INT Index )
+	{
+		return Names[Index];
+	}
+
+	// Log one allocator's counts, largest live tags first. Rates are
+	// since the last dump, and left out when Interval is zero.
+	void Dump( FOutputDevice& Ar, FMallocTagStats* Stats, DOUBLE Interval )
+	{
+		INT Count;
+		BYTE Order[TAG_COUNT];
+		{
+			FMallocLock::FScope Scope( Lock );
+			Count = TagCount;
+		}
+		for( INT i=0; i<Count; i++ )
+			Order[i] = i;
+		for( INT i=1; i<Count; i++ )
+			for( INT j=i; j>0 && Stats[Order[j]].Bytes>Stats[Order[j-1]].Bytes; j-- )
+				Exchange( Order[j], Order[j-1] );
+		if( Interval>0.0 )
+			Ar.Logf( TEXT("  Live Allocs   Live KB   Peak KB  Allocs/s  KB/s Total Allocs Tag") );
+		else
+			Ar.Logf( TEXT("  Live Allocs   Live KB   Peak KB Total Allocs Tag") );
+		for( INT i=0; i<Count; i++ )
+		{
+			FMallocTagStats& Info = Stats[Order[i]];
+			if( !Info.Count )
+				continue;
+			if( Interval>0.0 )
+				Ar.Logf
+				(
+					TEXT("  % 11i % 9i % 9i % 9.1f % 5.1f % 12i %s"),
+					Info.Allocs,
+					(INT)(Info.Bytes/1024),
+					(INT)(Info.Peak/1024),
+					(Info.Count-Info.LastCount) / Interval,
+					(Info.TotalBytes-Info.LastBytes) / 1024.0 / Interval,
+					Info.Count,
+					Names[Order[i]]
+				);
+			else
+				Ar.Logf
+				(
+					TEXT("  % 11i % 9i % 9i % 12i %s"),
+					Info.Allocs,
+					(INT)(Info.Bytes/1024),
+					(INT)(Info.Peak/1024),
+					Info.Count,
+					Names[Order[i]]
+				);
+			Info.LastCount = Info.Count;
+			Info.LastBytes = Info.TotalBytes;
+		}
+	}
+
+private:
+	const TCHAR*	Names[TAG_COUNT];
+	INT				TagCount;
+	const TCHAR*	TagHashKeys[TAG_HASH];
+	BYTE			TagHashValues[TAG_HASH];
+	INT				TagHashCount;
+	FMallocLock		Lock;
+};
+
+CORE_API extern FMallocTags GMallocTags;
+
+#endif
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
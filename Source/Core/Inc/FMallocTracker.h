@@ -0,0 +1,284 @@
+/*=============================================================================
+	FMallocTracker.h: Allocation tag tracking layer.
+	Copyright 1997-1999 Epic Games, Inc. All Rights Reserved.
+
+	Sits in front of the real allocator when the game is run with -MEMTRACK
+	and charges every allocation to the Tag its caller passed to appMalloc.
+	About one in MEMSAMPLE= allocations (default 1024) also records its
+	callstack, so the sites behind a growing tag can be found.
+
+	Revision history:
+		* Created for Linux and Dreamcast memory profiling.
+=============================================================================*/
+
+#include "FMallocTags.h"
+
+#if defined(__GLIBC__)
+#include <execinfo.h>
+#endif
+
+#if defined(__GNUC__)
+#define RETURN_ADDRESS __builtin_return_address(0)
+#else
+#define RETURN_ADDRESS NULL
+#endif
+
+//
+// Allocation tracking allocator.
+//
+class FMallocTracker : public FMalloc
+{
+private:
+	// Counts.
+	enum {STACK_COUNT = 256 };
+	enum {STACK_DEPTH = 8   };
+	enum {STACK_SKIP  = 1   };
+
+	// Header in front of every allocation. 16 bytes, so the inner
+	// allocator's alignment is kept.
+	struct FHeader
+	{
+		DWORD		Size;
+		_WORD		Tag;
+		_WORD		Stack;		// Sampled callstack index plus one, or zero.
+		DWORD		Magic;
+		DWORD		Pad;
+	};
+	enum {HEADER_MAGIC = 0x6b617254};
+
+	// A sampled callstack.
+	struct FStackInfo
+	{
+		void*		Frames[STACK_DEPTH];
+		INT			Depth;
+		_WORD		Tag;
+		INT			Samples;
+		INT			Allocs;			// Sampled allocations still live.
+		SIZE_T		Bytes;			// Sampled bytes still live.
+	};
+
+	// Variables.
+	FMalloc*		Inner;
+	FMallocTagStats* TagStats;
+	FStackInfo*		Stacks;
+	INT				StackCount;
+	INT				SampleRate;
+	INT				SampleCountdown;
+	DWORD			SampleSeed;
+	DOUBLE			StartTime;
+	DOUBLE			LastTime;
+	FMallocLock		Lock;
+
+	// Decide whether to sample this allocation. The interval is jittered
+	// so allocation patterns that repeat with a fixed period are still seen.
+	UBOOL ShouldSample()
+	{
+		if( --SampleCountdown > 0 )
+			return 0;
+		SampleSeed      = SampleSeed * 196314165 + 907633515;
+		SampleCountdown = SampleRate/2 + (SampleSeed>>8) % SampleRate + 1;
+		return 1;
+	}
+
+	// Record the current callstack, returning its index plus one or zero.
+	// Without backtrace only the caller of the allocator is known.
+	_WORD SampleStack( _WORD Tag, DWORD Size, void* Caller )
+	{
+		void* Frames[STACK_DEPTH+STACK_SKIP];
+		INT Depth = 0;
+#if defined(__GLIBC__)
+		Depth = Max( backtrace( Frames, STACK_DEPTH+STACK_SKIP ) - STACK_SKIP, 0 );
+		appMemmove( Frames, Frames+STACK_SKIP, Depth*sizeof(void*) );
+#else
+		Frames[Depth++] = Caller;
+#endif
+		if( !Depth )
+			return 0;
+
+		INT i;
+		for( i=0; i<StackCount; i++ )
+			if( Stacks[i].Tag==Tag && Stacks[i].Depth==Depth && appMemcmp(Stacks[i].Frames,Frames,Depth*sizeof(void*))==0 )
+				break;
+		if( i==StackCount )
+		{
+			if( StackCount==STACK_COUNT )
+				return 0;
+			FStackInfo& New = Stacks[StackCount++];
+			appMemcpy( New.Frames, Frames, Depth*sizeof(void*) );
+			New.Depth = Depth;
+			New.Tag   = Tag;
+		}
+		FStackInfo& Stack = Stacks[i];
+		Stack.Samples++;
+		Stack.Allocs++;
+		Stack.Bytes += Size;
+		return i+1;
+	}
+
+	// Accounting.
+	void Track( FHeader* Header, DWORD Size, const TCHAR* Tag, void* Caller )
+	{
+		Header->Size  = Size;
+		Header->Tag   = GMallocTags.FindTag( Tag );
+		Header->Stack = ShouldSample() ? SampleStack( Header->Tag, Size, Caller ) : 0;
+		Header->Magic = HEADER_MAGIC;
+		TagStats[Header->Tag].Alloc( Size );
+	}
+	void Untrack( FHeader* Header )
+	{
+		check(Header->Magic==HEADER_MAGIC);
+		TagStats[Header->Tag].Free( Header->Size );
+		if( Header->Stack )
+		{
+			FStackInfo& Stack = Stacks[Header->Stack-1];
+			Stack.Allocs--;
+			Stack.Bytes -= Header->Size;
+		}
+	}
+
+public:
+	// Constructor. Nothing is allocated until Enable, so an unused tracker
+	// costs nothing.
+	FMallocTracker()
+	:	Inner			( NULL )
+	,	TagStats		( NULL )
+	,	Stacks			( NULL )
+	,	StackCount		( 0 )
+	,	SampleRate		( 1024 )
+	,	SampleCountdown	( 1024 )
+	,	SampleSeed		( 1 )
+	,	StartTime		( 0.0 )
+	,	LastTime		( 0.0 )
+	{}
+
+	// Start tracking in front of InInner. Must be called before any
+	// allocation is made through InInner.
+	void Enable( FMalloc* InInner, INT InSampleRate )
+	{
+		Inner           = InInner;
+		SampleRate      = Max( InSampleRate, 1 );
+		SampleCountdown = SampleRate;
+		TagStats        = (FMallocTagStats*)calloc( FMallocTags::TAG_COUNT, sizeof(FMallocTagStats) );
+		Stacks          = (FStackInfo*)calloc( STACK_COUNT, sizeof(FStackInfo) );
+		check(TagStats && Stacks);
+	}
+
+	// Start the clock allocation rates are measured against, once the
+	// platform timer is calibrated.
+	void StartTimer()
+	{
+		StartTime = LastTime = appSeconds();
+	}
+
+	// Log live bytes, peak bytes and allocation rates per tag, then the
+	// sampled callstacks holding the most live memory.
+	void DumpTags( FOutputDevice& Ar )
+	{
+		guard(FMallocTracker::DumpTags);
+		FMallocLock::FScope Scope( Lock );
+
+		DOUBLE Now      = appSeconds();
+		DOUBLE Elapsed  = Max( Now-StartTime, 0.001 );
+		DOUBLE Interval = Max( Now-LastTime,  0.001 );
+		Ar.Logf( TEXT("Allocations by tag, %.1f seconds tracked, %.1f since last dump:"), Elapsed, Interval );
+		GMallocTags.Dump( Ar, TagStats, Interval );
+		LastTime = Now;
+
+		// Sampled stacks, scaled up by the sample rate to estimate totals.
+		INT StackOrder[STACK_COUNT];
+		for( INT i=0; i<StackCount; i++ )
+			StackOrder[i] = i;
+		for( INT i=1; i<StackCount; i++ )
+			for( INT j=i; j>0 && Stacks[StackOrder[j]].Bytes>Stacks[StackOrder[j-1]].Bytes; j-- )
+				Exchange( StackOrder[j], StackOrder[j-1] );
+		Ar.Logf( TEXT("Sampled callstacks, 1 in %i allocations, estimated live KB:"), SampleRate );
+		for( INT i=0; i<Min(StackCount,16); i++ )
+		{
+			FStackInfo& Stack = Stacks[StackOrder[i]];
+			if( !Stack.Allocs )
+				break;
+			Ar.Logf( TEXT("  % 9i KB in % 6i allocs, %s"), (INT)((QWORD)Stack.Bytes*SampleRate/1024), Stack.Allocs*SampleRate, GMallocTags.GetName( Stack.Tag ) );
+#if defined(__GLIBC__)
+			char** Symbols = backtrace_symbols( Stack.Frames, Stack.Depth );
+			for( INT j=0; j<Stack.Depth; j++ )
+				Ar.Logf( TEXT("      %s"), Symbols ? appFromAnsi(Symbols[j]) : TEXT("?") );
+			free( Symbols );
+#else
+			for( INT j=0; j<Stack.Depth; j++ )
+				Ar.Logf( TEXT("      %p"), Stack.Frames[j] );
+#endif
+		}
+		unguard;
+	}
+
+	// FMalloc interface.
+	void* Malloc( DWORD Size, const TCHAR* Tag )
+	{
+		guard(FMallocTracker::Malloc);
+		FMallocLock::FScope Scope( Lock );
+		FHeader* Header = (FHeader*)Inner->Malloc( sizeof(FHeader) + Size, Tag );
+		Track( Header, Size, Tag, RETURN_ADDRESS );
+		return Header+1;
+		unguard;
+	}
+	void* Realloc( void* Ptr, DWORD NewSize, const TCHAR* Tag )
+	{
+		guard(FMallocTracker::Realloc);
+		FMallocLock::FScope Scope( Lock );
+		if( !Ptr && !NewSize )
+			return NULL;
+		FHeader* Header = Ptr ? (FHeader*)Ptr - 1 : NULL;
+		if( Header )
+			Untrack( Header );
+		if( !NewSize )
+		{
+			Inner->Free( Header );
+			return NULL;
+		}
+		Header = (FHeader*)Inner->Realloc( Header, sizeof(FHeader) + NewSize, Tag );
+		Track( Header, NewSize, Tag, RETURN_ADDRESS );
+		return Header+1;
+		unguardf(( TEXT("%08X %i %s"), (INT)(SIZE_T)Ptr, NewSize, Tag ));
+	}
+	void Free( void* Ptr )
+	{
+		guard(FMallocTracker::Free);
+		if( !Ptr )
+			return;
+		FMallocLock::FScope Scope( Lock );
+		FHeader* Header = (FHeader*)Ptr - 1;
+		Untrack( Header );
+		Header->Magic = 0;
+		Inner->Free( Header );
+		unguard;
+	}
+	void DumpAllocs()
+	{
+		guard(FMallocTracker::DumpAllocs);
+		DumpTags( *GLog );
+		Inner->DumpAllocs();
+		unguard;
+	}
+	void HeapCheck()
+	{
+		guard(FMallocTracker::HeapCheck);
+		Inner->HeapCheck();
+		unguard;
+	}
+	void Init()
+	{
+		guard(FMallocTracker::Init);
+		Inner->Init();
+		unguard;
+	}
+	void Exit()
+	{
+		guard(FMallocTracker::Exit);
+		Inner->Exit();
+		unguard;
+	}
+};
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
@@ -117,6 +117,7 @@ public:
 	,	ArForEdit		(1)
 	,	ArForClient		(1)
 	,	ArForServer		(1)
+	,	ArRefsOnly		(0)
 	{}
 
 	// Status accessors.
@@ -131,6 +132,7 @@ public:
 	UBOOL ForEdit()			{return ArForEdit;}
 	UBOOL ForClient()		{return ArForClient;}
 	UBOOL ForServer()		{return ArForServer;}
+	UBOOL RefsOnly()		{return ArRefsOnly;}
 
 	// Friend archivers.
 	friend FArchive& operator<<( FArchive& Ar, ANSICHAR& C )
@@ -201,6 +203,7 @@ protected:
 	UBOOL ArForClient;
 	UBOOL ArForServer;
 	UBOOL ArIsError;
+	UBOOL ArRefsOnly;		// Only object references and names matter.
 };
 
 /*-----------------------------------------------------------------------------
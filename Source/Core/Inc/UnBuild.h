@@ -47,6 +47,17 @@
 #define DO_CLOCK_SLOW 0
 #endif
 
+// Whether to dispatch script through pre-decoded computed-goto handlers.
+// Off on low memory builds until ScriptBench shows it pays for its table
+// there; build with DO_THREADED_SCRIPT=1 to measure.
+#ifndef DO_THREADED_SCRIPT
+#if defined(__GNUC__) && !defined(PLATFORM_LOW_MEMORY)
+#define DO_THREADED_SCRIPT 1
+#else
+#define DO_THREADED_SCRIPT 0
+#endif
+#endif
+
 // Whether to gather performance statistics.
 #ifndef STATS
 #define STATS 1
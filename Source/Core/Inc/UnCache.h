@@ -16,7 +16,7 @@
 class CORE_API FMemCache
 {
 public:
-	// Information about a cache item (32 bytes).
+	// Information about a cache item (40 bytes).
 	enum {COST_INFINITE=0x1000000};
 	class CORE_API FCacheItem
 	{
@@ -72,11 +72,23 @@ public:
 		INT			Cost;			// Cost to flush this item.
 		FCacheItem*	LinearNext;		// Next cache item in linear list, or NULL if last.
 		FCacheItem*	LinearPrev;		// Previous cache item in linear list, or NULL if first.
-		FCacheItem*	HashNext;		// Next cache item in hash table, or NULL if last.
+		FCacheItem*	FreeNext;		// Next free space item of the same size class.
+		FCacheItem** FreePrevLink;	// Link to this free space item, or NULL if not free space.
+		INT			HeapIndex;		// Index in the eviction heap, or INDEX_NONE.
 	};
 
+	// Operations written by CACHERECORD, for replaying the cache's traffic.
+	enum ECacheOp
+	{
+		CACHEOP_Get		= 0,	// Id.
+		CACHEOP_Create	= 1,	// Id, size, alignment, safety pad.
+		CACHEOP_Tick	= 2,
+		CACHEOP_Flush	= 3,	// Id, mask.
+	};
+	enum {RECORD_MAGIC=0x52434d46};
+
 	// FMemCache interface.
-	FMemCache() {Initialized=0;}
+	FMemCache() {Initialized=0; Recorder=NULL;}
     void Init( INT BytesToAllocate, INT MaxItems, void* Start=NULL, INT SegSize=0 );
 	void Exit( INT FreeMemory );
 	void Flush( QWORD Id=0, DWORD Mask=~0, UBOOL IgnoreLocked=0 );
@@ -100,9 +112,16 @@ public:
 	{
 		return Item->LinearNext;
 	}
-	DWORD GHash( DWORD Val )
+	DWORD HashSlot( QWORD Id )
 	{
-		return (Val ^ (Val>>12) ^ (Val>>24)) & (HASH_COUNT-1);
+		// Mix both halves, lightmap ids differ mostly in the high one.
+		DWORD Val = (DWORD)Id * 0x9E3779B1 ^ (DWORD)(Id>>32) * 0x85EBCA77;
+		Val ^= Val >> 15;
+		return (DWORD)(((QWORD)Val * HashSize) >> 32);
+	}
+	DWORD HashNext( DWORD Slot )
+	{
+		return Slot+1<HashSize ? Slot+1 : 0;
 	}
 	BYTE* Get( QWORD Id, FCacheItem*& Item, INT Alignment=DEFAULT_ALIGNMENT )
 	{	
@@ -111,17 +130,22 @@ public:
 #if DO_SLOW_CLOCK
 		NumGets++;
 #endif
+		if( Recorder )
+			Record( CACHEOP_Get, Id );
 		if( Id==MruId )
 		{
+			NumHits++;
 			Item = MruItem;
 			MruItem->Cost += COST_INFINITE;
 			return Align( MruItem->Data, Alignment );
 		}
-		for( FCacheItem* HashItem=HashItems[GHash(Id)]; HashItem; HashItem=HashItem->HashNext )
+		for( DWORD Slot=HashSlot(Id); HashIds[Slot]; Slot=HashNext(Slot) )
 		{
-			if( HashItem->Id == Id )
+			if( HashIds[Slot] == Id )
 			{
 				// Set the item, lock it, and return its data.
+				FCacheItem* HashItem = &ItemMemory[HashItems[Slot]];
+				NumHits++;
 				MruId			= Id;
 				MruItem			= HashItem;
 				Item            = HashItem;
@@ -131,6 +155,7 @@ public:
 				return Align( HashItem->Data, Alignment );
 			}
 		}
+		NumMisses++;
 		unclockSlow(GetCycles);
 		return NULL;
 		unguardSlow;
@@ -138,12 +163,9 @@ public:
 
 private:
 	// Constants.
-#ifdef PLATFORM_LOW_MEMORY
-	enum {HASH_COUNT=8192};
-#else
-	enum {HASH_COUNT=16384};
-#endif
 	enum {IGNORE_SIZE=256};
+	enum {FREE_LIST_COUNT=32};
+	enum {EVICT_SEEDS=4};
 
 	// Variables.
 	UBOOL		Initialized;
@@ -154,29 +176,80 @@ private:
 	FCacheItem* CacheItems;
 	FCacheItem* LastItem;
 	FCacheItem* UnusedItems;
-	FCacheItem* HashItems[HASH_COUNT];
+	QWORD*		HashIds;		// Open addressed by HashSlot, 0=empty.
+	_WORD*		HashItems;		// Index in ItemMemory of each HashIds entry.
+	DWORD		HashSize;
+	FCacheItem* FreeLists[FREE_LIST_COUNT];
+	FCacheItem** Heap;
+	INT			HeapNum;
 	BYTE*       CacheMemory;
+	FArchive*	Recorder;
 
 	// Stats.
 	INT			NumGets, NumCreates, CreateCycles, GetCycles, TickCycles;
 	INT			ItemsFresh, ItemsStale, ItemsTotal, ItemGaps;
 	INT			MemFresh, MemStale, MemTotal;
+	INT			NumHits, NumMisses, NumEvicted;
+	INT			EvictedBytes, LastEvictedBytes, PeakEvictedBytes;
 
 	// Internal functions.
 	void CreateNewFreeSpace( BYTE* Start, BYTE* End, FCacheItem* Prev, FCacheItem* Next, INT Segment );
+	INT FindSlot( QWORD Id )
+	{
+		for( DWORD Slot=HashSlot(Id); HashIds[Slot]; Slot=HashNext(Slot) )
+			if( HashIds[Slot] == Id )
+				return Slot;
+		return INDEX_NONE;
+	}
+	void Hash( FCacheItem* Item );
+	void RemoveSlot( DWORD Slot );
 	void Unhash( QWORD Id )
 	{
-		for( FCacheItem** PrevLink=&HashItems[GHash(Id)]; *PrevLink; PrevLink=&(*PrevLink)->HashNext )
-		{
-			if( (*PrevLink)->Id == Id )
-			{
-				*PrevLink = (*PrevLink)->HashNext;
-				return;
-			}
-		}
-		appErrorf( TEXT("Unhashed item") );
+		INT Slot = FindSlot( Id );
+		if( Slot == INDEX_NONE )
+			appErrorf( TEXT("Unhashed item") );
+		RemoveSlot( Slot );
 	}
+	void Record( BYTE Op, QWORD Id, INT A=0, INT B=0, INT C=0 );
 	FCacheItem* MergeWithNext( FCacheItem* First );
+	UBOOL Fits( FCacheItem* First, FCacheItem* Last, INT Size, INT Alignment )
+	{
+		return Last->LinearNext->Data - Align(First->Data,Alignment) >= Size;
+	}
+
+	// Free space lists, segregated by the log2 of the item's size.
+	void LinkFree( FCacheItem* Item )
+	{
+		checkSlow( Item->Id==0 && Item!=LastItem );
+		FCacheItem** Link  = &FreeLists[appCeilLogTwo(Item->GetSize()+1)-1];
+		Item->FreeNext     = *Link;
+		Item->FreePrevLink = Link;
+		if( *Link )
+			(*Link)->FreePrevLink = &Item->FreeNext;
+		*Link              = Item;
+	}
+	void UnlinkFree( FCacheItem* Item )
+	{
+		checkSlow( Item->FreePrevLink );
+		if( Item->FreeNext )
+			Item->FreeNext->FreePrevLink = Item->FreePrevLink;
+		*Item->FreePrevLink = Item->FreeNext;
+		Item->FreePrevLink  = NULL;
+	}
+	FCacheItem* FindFree( INT Size, INT Alignment );
+
+	// Eviction heap of used items, cheapest per byte on top, which is the
+	// stalest since Cost starts out as the item's size. Lock counts are
+	// ignored so Get and Unlock leave the order alone.
+	static DWORD HeapCost( FCacheItem* Item )
+	{
+		return (DWORD)(((QWORD)(Item->Cost & (COST_INFINITE-1)) << 8) / Item->GetSize());
+	}
+	void HeapUp( INT Index );
+	void HeapDown( INT Index );
+	void HeapInsert( FCacheItem* Item );
+	void HeapRemove( FCacheItem* Item );
+	UBOOL FindEvictable( INT Size, INT Alignment, FCacheItem*& BestFirst, FCacheItem*& BestLast );
 	FCacheItem* FlushItem( FCacheItem* Item, UBOOL IgnoreLocked=0 );
 	void ConditionalCheckState()
 	{
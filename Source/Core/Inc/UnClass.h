@@ -13,6 +13,39 @@
 // Boundary to align class properties on.
 enum {PROPERTY_ALIGNMENT=4 };
 
+/*-----------------------------------------------------------------------------
+	FPropertyOp.
+-----------------------------------------------------------------------------*/
+
+//
+// Property plan step types.
+//
+enum EPropertyOp
+{
+	POP_Bytes,			// Size bytes of plain data.
+	POP_Floats,			// Size floats.
+	POP_Bool,			// Bools in one bitfield, Size is their bit mask.
+	POP_Object,			// One object pointer.
+	POP_String,			// One FString.
+	POP_Property,		// One value of Property, through its virtual functions.
+};
+
+//
+// One step of a struct's copy or compare plan. Runs of plain data share
+// a step so they're copied or compared as one block; strings, arrays and
+// anything else with storage of its own keep a step per value.
+//
+struct FPropertyOp
+{
+	INT			Type;
+	INT			Offset;
+	INT			Size;
+	UProperty*	Property;
+
+	// Functions.
+	UBOOL Identical( const BYTE* A, const BYTE* B ) const;
+};
+
 /*-----------------------------------------------------------------------------
 	FRepRecord.
 -----------------------------------------------------------------------------*/
@@ -24,6 +57,7 @@ struct FRepRecord
 {
 	UProperty* Property;
 	INT Index;
+	FPropertyOp Op;		// Compares this element of Property.
 	FRepRecord(UProperty* InProperty,INT InIndex)
 	: Property(InProperty), Index(InIndex)
 	{}
@@ -69,6 +103,53 @@ public:
 	{}
 };
 
+/*-----------------------------------------------------------------------------
+	FCallCache.
+-----------------------------------------------------------------------------*/
+
+//
+// The function a virtual call site last resolved to, and the receiver's
+// class and state it was resolved for.
+//
+struct FCallCache
+{
+	UClass*		Class;
+	UState*		State;
+	UFunction*	Function;
+};
+
+/*-----------------------------------------------------------------------------
+	FRefToken.
+-----------------------------------------------------------------------------*/
+
+//
+// Reference token types.
+//
+enum ERefToken
+{
+	REF_End,			// End of stream.
+	REF_Object,			// Count object pointers.
+	REF_Name,			// Count names.
+	REF_ObjectArray,	// TArray of object pointers.
+	REF_NameArray,		// TArray of names.
+	REF_StructArray,	// TArray of Stride byte structs, laid out by the Count tokens that follow.
+	REF_Property,		// Anything else, serialized through Property.
+};
+
+//
+// One entry in a struct's reference token stream: where the object
+// references and names in an instance live, so reference-only archives
+// can find them without serializing every property.
+//
+struct FRefToken
+{
+	INT			Type;
+	INT			Offset;
+	INT			Count;
+	INT			Stride;
+	UProperty*	Property;
+};
+
 /*-----------------------------------------------------------------------------
 	FLabelEntry.
 -----------------------------------------------------------------------------*/
@@ -153,6 +234,15 @@ class CORE_API UStruct : public UField
 	UProperty*			PropertyLink;
 	UProperty*			ConfigLink;
 	UProperty*			ConstructorLink;
+	TArray<FRefToken>	RefTokens;
+	TArray<FPropertyOp>	CopyPlan;
+	TArray<FPropertyOp>	ComparePlan;
+#if DO_THREADED_SCRIPT
+	TArray<BYTE>		Threaded;
+	TArray<FCallCache>	CallCache;
+	INT					CallSites;
+	INT					CallCacheEpoch;
+#endif
 
 	// Constructors.
 	UStruct( ENativeConstructor, INT InSize, const TCHAR* InName, const TCHAR* InPackageName, DWORD InFlags, UStruct* InSuperStruct );
@@ -166,14 +256,19 @@ class CORE_API UStruct : public UField
 
 	// UField interface.
 	void AddCppProperty( UProperty* Property );
+	void Bind();
 
 	// UStruct interface.
 	virtual UStruct* GetInheritanceSuper() {return GetSuperStruct();}
 	virtual void Link( FArchive& Ar, UBOOL Props );
 	virtual void SerializeBin( FArchive& Ar, BYTE* Data );
+	void SerializeRefs( FArchive& Ar, BYTE* Data );
+	void RunCopyPlan( BYTE* Dest, BYTE* Src, INT Start, UBOOL Construct );
+	UBOOL RunComparePlan( const BYTE* A, const BYTE* B );
 	virtual void SerializeTaggedProperties( FArchive& Ar, BYTE* Data, UClass* DefaultsClass );
 	virtual void CleanupDestroyed( BYTE* Data );
 	virtual EExprToken SerializeExpr( INT& iCode, FArchive& Ar );
+	void ThreadScript( UBOOL Enable );
 	INT GetPropertiesSize()
 	{
 		return PropertiesSize;
@@ -306,6 +401,7 @@ class CORE_API UFunction : public UStruct
 	// UObject interface.
 	void Serialize( FArchive& Ar );
 	void PostLoad();
+	void Destroy();
 
 	// UField interface.
 	void Bind();
@@ -428,6 +524,7 @@ class CORE_API UClass : public UState
 
 	// In memory only.
 	FString				DefaultPropText;
+	UObject*			FirstObject;		// First object of exactly this class.
 
 	// Constructors.
 	UClass();
@@ -538,6 +635,137 @@ class CORE_API UConst : public UField
 	}
 };
 
+/*-----------------------------------------------------------------------------
+	Class and package object iterators.
+-----------------------------------------------------------------------------*/
+
+//
+// Class for iterating through all objects which inherit from a specified
+// base class. Unlike FObjectIterator this walks the object list of each
+// matching class rather than the whole object table. The next object is
+// fetched in advance, so the current one may be destroyed.
+//
+class FClassObjectIterator
+{
+public:
+	FClassObjectIterator( UClass* InClass=UObject::StaticClass() )
+	:	Class( InClass ), Object( NULL ), NextObject( NULL ), NextClass( UClass::StaticClass()->FirstObject )
+	{
+		check(Class);
+		++*this;
+	}
+	void operator++()
+	{
+		Object = NextObject;
+		while( !Object && NextClass )
+		{
+			UClass* Test = (UClass*)NextClass;
+			NextClass = UObject::GObjLinks(NextClass->Index).ClassNext;
+			if( Test->IsChildOf(Class) )
+				Object = Test->FirstObject;
+		}
+		NextObject = Object ? UObject::GObjLinks(Object->Index).ClassNext : NULL;
+	}
+	UObject* operator*()
+	{
+		return Object;
+	}
+	UObject* operator->()
+	{
+		return Object;
+	}
+	operator UBOOL()
+	{
+		return Object!=NULL;
+	}
+protected:
+	UClass* Class;
+	UObject* Object;
+	UObject* NextObject;
+	UObject* NextClass;
+};
+
+//
+// Class for iterating through all objects inside a package or any other
+// outer which inherit from a specified base class, by walking the object
+// list of the outermost package.
+//
+class FPackageObjectIterator
+{
+public:
+	FPackageObjectIterator( UObject* InOuter, UClass* InClass=UObject::StaticClass() )
+	:	Outer( InOuter ), Class( InClass ), Object( NULL ), NextObject( NULL )
+	{
+		check(Outer);
+		check(Class);
+		UObject* Top;
+		for( Top=Outer; Top->GetOuter(); Top=Top->GetOuter() );
+		NextObject = ((UPackage*)Top)->FirstObject;
+		if( Top==Outer )
+			Outer = NULL;
+		++*this;
+	}
+	void operator++()
+	{
+		do
+		{
+			Object     = NextObject;
+			NextObject = Object ? UObject::GObjLinks(Object->Index).PackageNext : NULL;
+		} while( Object && (!Object->IsA(Class) || (Outer && !Object->IsIn(Outer))) );
+	}
+	UObject* operator*()
+	{
+		return Object;
+	}
+	UObject* operator->()
+	{
+		return Object;
+	}
+	operator UBOOL()
+	{
+		return Object!=NULL;
+	}
+protected:
+	UObject* Outer;
+	UClass* Class;
+	UObject* Object;
+	UObject* NextObject;
+};
+
+//
+// Typed versions of the above.
+//
+template< class T > class TClassObjectIterator : public FClassObjectIterator
+{
+public:
+	TClassObjectIterator()
+	:	FClassObjectIterator( T::StaticClass() )
+	{}
+	T* operator* ()
+	{
+		return (T*)FClassObjectIterator::operator*();
+	}
+	T* operator-> ()
+	{
+		return (T*)FClassObjectIterator::operator->();
+	}
+};
+template< class T > class TPackageObjectIterator : public FPackageObjectIterator
+{
+public:
+	TPackageObjectIterator( UObject* InOuter )
+	:	FPackageObjectIterator( InOuter, T::StaticClass() )
+	{}
+	T* operator* ()
+	{
+		return (T*)FPackageObjectIterator::operator*();
+	}
+	T* operator-> ()
+	{
+		return (T*)FPackageObjectIterator::operator->();
+	}
+};
+
 /*-----------------------------------------------------------------------------
 	The End.
 -----------------------------------------------------------------------------*/
@@ -19,6 +19,9 @@ class CORE_API UPackage : public UObject
 	UBOOL AttemptedBind;
 	DWORD PackageFlags;
 
+	// In memory only.
+	UObject* FirstObject; // First object inside this package, if outermost.
+
 	// Constructors.
 	UPackage();
 
@@ -27,6 +27,9 @@
 #include <ctype.h>
 #include <malloc.h>
 #include <dirent.h>
+#ifdef PLATFORM_POSIX
+#include <pthread.h>
+#endif
 #ifdef PLATFORM_WIN32
 #include <minwindef.h>
 #endif
@@ -29,21 +29,21 @@ enum EFindName
 ----------------------------------------------------------------------------*/
 
 //
-// A global name, as stored in the global name table.
+// A global name, as stored in the global name table. Entries in the
+// table are packed into shared blocks and only as long as their name.
 //
 struct FNameEntry
 {
 	// Variables.
 	NAME_INDEX	Index;				// Index of name in hash.
 	DWORD		Flags;				// RF_TagImp, RF_TagExp, RF_Native.
-	FNameEntry*	HashNext;			// Pointer to the next entry in this hash bin's linked list.
 
 	// The name string.
 	TCHAR		Name[NAME_SIZE];	// Name, variable-sized.
 
 	// Functions.
 	CORE_API friend FArchive& operator<<( FArchive& Ar, FNameEntry& E );
-	CORE_API friend FNameEntry* AllocateNameEntry( const TCHAR* Name, DWORD Index, DWORD Flags, FNameEntry* HashNext );
+	CORE_API friend FNameEntry* AllocateNameEntry( const TCHAR* Name, DWORD Index, DWORD Flags );
 };
 template <> struct TTypeInfo<FNameEntry*> : public TTypeInfoBase<FNameEntry*>
 {
@@ -151,8 +151,15 @@ private:
 	// Static subsystem variables.
 	static TArray<FNameEntry*>	Names;			 // Table of all names.
 	static TArray<INT>          Available;       // Indices of available names.
-	static FNameEntry*			NameHash[4096];  // Hashed names.
+	static DWORD*				NameHash;		 // Open addressed name hash.
+	static INT					NameHashSize;	 // Slots in NameHash, a power of two.
+	static INT					NameHashCount;	 // Used slots in NameHash.
 	static UBOOL				Initialized;	 // Subsystem initialized.
+
+	// Name hash maintenance.
+	static void HashName( INT Index, DWORD Hash );
+	static void UnhashName( INT Index, DWORD Hash );
+	static void ResizeHash( INT NewSize );
 };
 inline DWORD GetTypeHash( const FName N )
 {
@@ -347,6 +347,21 @@ public: \
 	UObject.
 -----------------------------------------------------------------------------*/
 
+//
+// An object's links in the list of objects of its class and in the list
+// of objects inside its outermost package. Kept in UObject::GObjLinks,
+// parallel to UObject::GObjObjects, because the UObject layout is fixed
+// by Object.uc. Prev of the first object points to the last one; an
+// object that isn't linked has a NULL Prev.
+//
+struct FObjectLinks
+{
+	UObject* ClassNext;
+	UObject* ClassPrev;
+	UObject* PackageNext;
+	UObject* PackagePrev;
+};
+
 //
 // The base class of all objects.
 //
@@ -360,6 +375,8 @@ class CORE_API UObject : public FUnknown
 
 	// Friends.
 	friend class FObjectIterator;
+	friend class FClassObjectIterator;
+	friend class FPackageObjectIterator;
 	friend class ULinkerLoad;
 	friend class ULinkerSave;
 	friend class UPackageMap;
@@ -385,12 +402,14 @@ private:
 	static INT				GObjBeginLoadCount;	// Count for BeginLoad multiple loads.
 	static INT				GObjRegisterCount;  // ProcessRegistrants entry counter.
 	static INT				GImportCount;		// Imports for EndLoad optimization.
-	static UObject*			GObjHash[4096];		// Object hash.
+	static UObject**		GObjHash;			// Object hash, 1<<GObjHashBits chains.
+	static INT				GObjHashBits;		// Log2 of the object hash size.
 	static UObject*			GAutoRegister;		// Objects to automatically register.
 	static TArray<UObject*> GObjLoaded;			// Objects that might need preloading.
 	static TArray<UObject*>	GObjRoot;			// Top of active object graph.
 	static TArray<UObject*>	GObjObjects;		// List of all objects.
 	static TArray<INT>      GObjAvailable;		// Available object indices.
+	static TArray<FObjectLinks> GObjLinks;		// Per-class and per-package list links.
 	static TArray<UObject*>	GObjLoaders;		// Array of loaders.
 	static UPackage*		GObjTransientPkg;	// Transient package.
 	static TCHAR			GObjCachedLanguage[32]; // Language;
@@ -404,6 +423,9 @@ private:
 	void AddObject( INT Index );
 	void HashObject();
 	void UnhashObject( INT OuterIndex );
+	static void ResizeHash( INT NewBits );
+	void LinkObject();
+	void UnlinkObject();
 	void SetLinker( ULinkerLoad* L, INT I );
 
 	// Private systemwide functions.
@@ -494,7 +516,11 @@ public:
 	static void SetLanguage( const TCHAR* LanguageExt );
 	static INT GetObjectHash( FName ObjName, INT Outer )
 	{
-		return (ObjName.GetIndex() ^ Outer) & (ARRAY_COUNT(GObjHash)-1);
+		// Name and outer indices are both small and dense, so mix them
+		// before taking the top bits.
+		DWORD Key = (DWORD)ObjName.GetIndex() * 0x9E3779B1 + (DWORD)Outer * 0x85EBCA77;
+		Key ^= Key >> 15;
+		return (Key * 0xC2B2AE3D) >> (32 - GObjHashBits);
 	}
 
 	// Functions.
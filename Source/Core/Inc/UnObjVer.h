@@ -19,6 +19,12 @@
 // Prevents incorrect files from being loaded.
 #define PACKAGE_FILE_TAG 0x9E2A83C1
 
+// Marks a package stored as compressed blocks.
+#define PACKAGE_COMPRESSED_TAG 0x9E2A83C2
+
+// Default raw size of one block of a compressed package.
+#define PACKAGE_COMPRESSED_BLOCK 65536
+
 // The current Unrealfile version.
 #define PACKAGE_FILE_VERSION 68
 
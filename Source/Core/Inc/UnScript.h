@@ -114,8 +114,18 @@ inline FFrame::FFrame( UObject* InObject, UStruct* InNode, INT CodeOffset, void*
 inline void FFrame::Step( UObject* Context, RESULT_DECL )
 {
 	guardSlow(FFrame::Step);
-	INT B = *Code++;
-	(Context->*GNatives[B])( *this, Result );
+#if DO_THREADED_SCRIPT
+	BYTE Op = Node->Threaded.Num() ? Node->Threaded(Code - &Node->Script(0)) : (BYTE)THR_Native;
+	if( Op!=THR_Native )
+	{
+		StepThreaded( Op, Context, Result );
+	}
+	else
+#endif
+	{
+		INT B = *Code++;
+		(Context->*GNatives[B])( *this, Result );
+	}
 	unguardfSlow(( TEXT("(%s @ %s : %04X)"), Object->GetFullName(), Node->GetFullName(), Code - &Node->Script(0) ));
 }
 inline INT FFrame::ReadInt()
@@ -190,6 +200,91 @@ inline const TCHAR* FStateFrame::Describe()
 	return Node ? Node->GetFullName() : TEXT("None");
 }
 
+/*-----------------------------------------------------------------------------
+	FScriptProfiler.
+-----------------------------------------------------------------------------*/
+
+//
+// Per-function script profiler, fed by UObject::CallFunction and
+// UObject::ProcessEvent while GScriptProfiler is set. Inclusive time counts
+// only the outermost of recursive calls; exclusive time leaves out profiled
+// callees. Natives reached straight from a token (operators and most
+// intrinsics) aren't calls and count as their caller's exclusive time.
+//
+class CORE_API FScriptProfiler
+{
+public:
+	// Functions.
+	FScriptProfiler();
+	void Reset();
+	void Stop();
+	void Dump( FOutputDevice& Ar, const TCHAR* Filename );
+	void Forget( UFunction* Function );
+
+	// Call tracking.
+	void Enter( UFunction* Function )
+	{
+		INT* Found = EntryMap.Find( Function );
+		INT iEntry = Found ? *Found : AddEntry( Function );
+		Entries(iEntry).Calls++;
+		Entries(iEntry).Depth++;
+		FCall& Call = Calls(Calls.Add());
+		Call.iEntry      = iEntry;
+		Call.ChildCycles = 0;
+		Call.StartCycles = appCycles();
+	}
+	void Exit( UFunction* Function )
+	{
+		DWORD EndCycles = appCycles();
+		if( !Calls.Num() || Entries(Calls.Last().iEntry).Function!=Function )
+			return;
+		FCall Call = Calls.Pop();
+		FEntry& Entry = Entries(Call.iEntry);
+		DWORD Cycles = EndCycles - Call.StartCycles;
+		if( --Entry.Depth==0 )
+			Entry.Inclusive += Cycles;
+		Entry.Exclusive += Cycles - Min<QWORD>( Cycles, Call.ChildCycles );
+		if( Calls.Num() )
+		{
+			FCall& Parent = Calls.Last();
+			Parent.ChildCycles += Cycles;
+			if( Function->FunctionFlags & FUNC_Native )
+				Entries(Parent.iEntry).NativeCallees += Cycles;
+		}
+	}
+
+private:
+	// One profiled function. Function is only compared, never followed,
+	// since it may have been destroyed; Name is kept for Dump.
+	struct FEntry
+	{
+		UFunction*	Function;
+		FString		Name;
+		UBOOL		Native;
+		UBOOL		Dead;		// Forgotten, no longer in EntryMap.
+		INT			OldIndex;	// Index before Dump last sorted.
+		DWORD		Calls;
+		INT			Depth;
+		QWORD		Inclusive, Exclusive, NativeCallees;
+	};
+
+	// One call in progress.
+	struct FCall
+	{
+		INT			iEntry;
+		DWORD		StartCycles;
+		QWORD		ChildCycles;
+	};
+
+	TMap<UFunction*,INT>	EntryMap;
+	TArray<FEntry>			Entries;
+	TArray<FCall>			Calls;
+	DOUBLE					StartTime, StopTime;
+
+	INT AddEntry( UFunction* Function );
+	static QSORT_RETURN CDECL CompareExclusive( const FEntry* A, const FEntry* B );
+};
+
 /*-----------------------------------------------------------------------------
 	The End.
 -----------------------------------------------------------------------------*/
@@ -176,6 +176,38 @@ enum EExprToken
 	EX_Max					= 0x1000,
 };
 
+//
+// Pre-decoded handlers for threaded script dispatch, one per token
+// start in UStruct::Threaded. THR_Native goes through GNatives. Call
+// tokens keep their call site's index in the two bytes that follow.
+//
+enum EThreadedOp
+{
+	THR_Native				= 0x00,	// Not pre-decoded.
+	THR_LocalInt			= 0x01,	// Local int, float or name.
+	THR_LocalObject			= 0x02,	// Local object reference.
+	THR_LocalByte			= 0x03,	// Local byte.
+	THR_LocalPlain			= 0x04,	// Local with no constructor, such as a vector.
+	THR_InstanceInt			= 0x05,	// Instance int, float or name.
+	THR_InstanceObject		= 0x06,	// Instance object reference.
+	THR_InstanceByte		= 0x07,	// Instance byte.
+	THR_InstancePlain		= 0x08,	// Instance with no constructor.
+	THR_IntConst			= 0x09,	// Int constant.
+	THR_FloatConst			= 0x0A,	// Floating point constant.
+	THR_IntConstByte		= 0x0B,	// Int constant that requires 1 byte.
+	THR_ByteConst			= 0x0C,	// Byte constant.
+	THR_IntZero				= 0x0D,	// Zero or bool False.
+	THR_IntOne				= 0x0E,	// One or bool True.
+	THR_NoObject			= 0x0F,	// NoObject.
+	THR_Self				= 0x10,	// Self object.
+	THR_Nothing				= 0x11,	// No operation.
+	THR_Jump				= 0x12,	// Goto a local address in code.
+	THR_JumpIfNot			= 0x13,	// Goto if not expression.
+	THR_VirtualFunction		= 0x14,	// Function call through the call site's cache.
+	THR_GlobalFunction		= 0x15,	// Non-state function call through the call site's cache.
+	THR_Max					= 0x16,
+};
+
 //
 // Latent functions.
 //
@@ -208,6 +240,7 @@ struct CORE_API FFrame : public FOutputDevice
 
 	// Functions.
 	void Step( UObject* Context, RESULT_DECL );
+	void StepThreaded( BYTE Op, UObject* Context, RESULT_DECL );
 	void Serialize( const TCHAR* V, enum EName Event );
 	INT ReadInt();
 	UObject* ReadObject();
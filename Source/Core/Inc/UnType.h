@@ -575,6 +575,8 @@ inline UBOOL UObject::IsProbing( FName ProbeName )
 inline UBOOL UStruct::StructCompare( const void* A, const void* B )
 {
 	guardSlow(UStruct::StructCompare);
+	if( ComparePlan.Num() )
+		return RunComparePlan( (const BYTE*)A, (const BYTE*)B );
 	for( TFieldIterator<UProperty> It(this); It; ++It )
 		for( INT i=0; i<It->ArrayDim; i++ )
 			if( !It->Matches(A,B,i) )
@@ -583,6 +585,33 @@ inline UBOOL UStruct::StructCompare( const void* A, const void* B )
 	return 1;
 }
 
+//
+// Compare one plan step of A and B.
+//
+inline UBOOL FPropertyOp::Identical( const BYTE* A, const BYTE* B ) const
+{
+	guardSlow(FPropertyOp::Identical);
+	switch( Type )
+	{
+		case POP_Bytes:
+			return appMemcmp( A+Offset, B+Offset, Size )==0;
+		case POP_Floats:
+			for( INT i=0; i<Size; i++ )
+				if( ((FLOAT*)(A+Offset))[i] != ((FLOAT*)(B+Offset))[i] )
+					return 0;
+			return 1;
+		case POP_Bool:
+			return ((*(BITFIELD*)(A+Offset) ^ *(BITFIELD*)(B+Offset)) & Size)==0;
+		case POP_Object:
+			return *(UObject**)(A+Offset) == *(UObject**)(B+Offset);
+		case POP_String:
+			return appStricmp( **(FString*)(A+Offset), **(FString*)(B+Offset) )==0;
+		default:
+			return Property->Identical( A+Offset, B+Offset );
+	}
+	unguardSlow;
+}
+
 /*-----------------------------------------------------------------------------
 	C++ property macros.
 -----------------------------------------------------------------------------*/
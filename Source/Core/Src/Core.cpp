@@ -4,6 +4,7 @@
 =============================================================================*/
 
 #include "CorePrivate.h"
+#include "FMallocTags.h"
 
 /*-----------------------------------------------------------------------------
 	Temporary startup objects.
@@ -126,10 +127,16 @@ CORE_API FTransactionBase*		GUndo=NULL;						/* Transaction tracker, non-NULL wh
 CORE_API FOutputDevice*			GLogHook=NULL;					/* Launch log output hook */
 CORE_API FExec*					GExec=NULL;						/* Launch command-line exec hook */
 CORE_API FMalloc*				GMalloc=&MallocError;			/* Memory allocator */
+CORE_API FMallocTracker*		GMallocTracker=NULL;			/* Allocation tag tracker, if -MEMTRACK */
+CORE_API FMallocTags			GMallocTags;					/* Allocation tag names, shared by the allocators */
 CORE_API FFileManager*			GFileManager=&FileError;		/* File manager */
 CORE_API USystem*				GSys=NULL;						/* System control code */
 CORE_API UProperty*				GProperty;						/* Property for UnrealScript interpretter */
 CORE_API BYTE*					GPropAddr;						/* Property address for UnrealScript interpreter */
+CORE_API INT					GCallCacheEpoch=1;				/* Bumped whenever virtual call caches go stale */
+CORE_API DWORD					GCallCacheHits=0;				/* Virtual calls resolved from the call cache */
+CORE_API DWORD					GCallCacheMisses=0;				/* Virtual calls that had to look the function up */
+CORE_API FScriptProfiler*		GScriptProfiler=NULL;			/* Script profiler, non-NULL while SCRIPTPROF is running */
 CORE_API USubsystem*			GWindowManager=NULL;			/* Window update routine called once per tick */
 CORE_API TCHAR					GErrorHist[4096]=TEXT("");		/* For building call stack text dump in guard/unguard mechanism */
 CORE_API TCHAR					GYes[64]=TEXT("Yes");			/* Localized "yes" text */
@@ -0,0 +1,104 @@
+/*=============================================================================
+	UScriptBenchCommandlet.cpp: Script interpreter microbenchmarks.
+	Copyright 1997-1999 Epic Games, Inc. All Rights Reserved.
+
+	Times the tests in ScriptBench.ScriptBench with plain GNatives dispatch
+	and with threaded dispatch:
+
+		ucc Core.ScriptBench [COUNT=<iterations>]
+
+	The tests live in their own package so the stock Core.u stays as is;
+	add ScriptBench to EditPackages and run ucc make to build it.
+=============================================================================*/
+
+#include "CorePrivate.h"
+
+/*-----------------------------------------------------------------------------
+	UScriptBenchCommandlet.
+-----------------------------------------------------------------------------*/
+
+class UScriptBenchCommandlet : public UCommandlet
+{
+	DECLARE_CLASS(UScriptBenchCommandlet,UCommandlet,CLASS_Transient);
+	void StaticConstructor()
+	{
+		guard(UScriptBenchCommandlet::StaticConstructor);
+
+		LogToStdout     = 0;
+		IsClient        = 0;
+		IsEditor        = 0;
+		IsServer        = 0;
+		LazyLoad        = 1;
+		ShowErrorCount  = 0;
+
+		unguard;
+	}
+	void SetThreaded( UClass* Class, UBOOL Threaded )
+	{
+		guard(UScriptBenchCommandlet::SetThreaded);
+		for( TFieldIterator<UFunction> It(Class); It; ++It )
+			It->ThreadScript( Threaded );
+		unguard;
+	}
+	DOUBLE Run( UObject* Bench, UFunction* Function, INT Count )
+	{
+		guard(UScriptBenchCommandlet::Run);
+		BYTE Parms[64];
+		check(Function->ParmsSize<=sizeof(Parms));
+		appMemzero( Parms, sizeof(Parms) );
+		*(INT*)Parms = Count;
+		DOUBLE StartTime = appSeconds();
+		Bench->ProcessEvent( Function, Parms );
+		return appSeconds() - StartTime;
+		unguard;
+	}
+	INT Main( const TCHAR* Parms )
+	{
+		guard(UScriptBenchCommandlet::Main);
+
+		static const TCHAR* Tests[] = { TEXT("Loops"), TEXT("VectorMath"), TEXT("VirtualCalls") };
+		INT Count = 100000;
+		Parse( Parms, TEXT("COUNT="), Count );
+
+		UClass* Class = StaticLoadClass( UObject::StaticClass(), NULL, TEXT("ScriptBench.ScriptBench"), NULL, LOAD_NoWarn, NULL );
+		if( !Class )
+		{
+			GWarn->Logf( TEXT("ScriptBench.u not found, add ScriptBench to EditPackages and run ucc make") );
+			GIsRequestingExit = 1;
+			return 1;
+		}
+		UObject* Bench = StaticConstructObject( Class );
+		GWarn->Logf( TEXT("Script benchmarks, %i iterations each"), Count );
+		for( INT i=0; i<(INT)ARRAY_COUNT(Tests); i++ )
+		{
+			UFunction* Function = Bench->FindFunctionChecked( FName(Tests[i]) );
+			DOUBLE Seconds[2];
+			for( INT Threaded=0; Threaded<2; Threaded++ )
+			{
+				SetThreaded( Class, Threaded );
+				Run( Bench, Function, Count/10 );
+				GCallCacheHits = GCallCacheMisses = 0;
+				Seconds[Threaded] = Run( Bench, Function, Count );
+			}
+			GWarn->Logf
+			(
+				TEXT("%-12s %8.2f ms plain, %8.2f ms threaded (%.2fx), %u call cache hits, %u misses"),
+				Tests[i],
+				Seconds[0] * 1000.0,
+				Seconds[1] * 1000.0,
+				Seconds[1]>0.0 ? Seconds[0]/Seconds[1] : 0.0,
+				GCallCacheHits,
+				GCallCacheMisses
+			);
+		}
+
+		GIsRequestingExit = 1;
+		return 0;
+		unguard;
+	}
+};
+IMPLEMENT_CLASS(UScriptBenchCommandlet)
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
@@ -29,16 +29,28 @@ void FMemCache::Init
 {
 	guard(FMemCache::Init);
 	check( Initialized==0 );
+	check( MaxItems<=65536 );
 
 	// Remember totals.
 	MemTotal   = BytesToAllocate;
 	ItemsTotal = MaxItems;
 	MruId      = 0;
 	MruItem    = NULL;
+	HeapNum    = 0;
+	NumHits    = NumMisses = NumEvicted = 0;
+	EvictedBytes = LastEvictedBytes = PeakEvictedBytes = 0;
+	{for( INT i=0; i<FREE_LIST_COUNT; i++ )
+		FreeLists[i] = NULL;}
 
 	// Allocate memory.
 	CacheMemory		 = Start ? (BYTE*)Start : new(TEXT("CacheMemory"))BYTE[BytesToAllocate];
 	ItemMemory       = new(TEXT("CacheItems"))FCacheItem[MaxItems];
+	Heap             = (FCacheItem**)appMalloc( MaxItems * sizeof(FCacheItem*), TEXT("CacheHeap") );
+
+	// Size the hash from the items that can ever be in it, at most 2/3 full.
+	HashSize         = Max( MaxItems + MaxItems/2, 16 );
+	HashIds          = (QWORD*)appMalloc( HashSize * sizeof(QWORD), TEXT("CacheHashIds") );
+	HashItems        = (_WORD*)appMalloc( HashSize * sizeof(_WORD), TEXT("CacheHashItems") );
 
 	// Build linked list of items not associated with cache memory.
 	FCacheItem** PrevLink = &UnusedItems;
@@ -46,6 +58,8 @@ void FMemCache::Init
 	{
 		*PrevLink = &ItemMemory[i];
 		PrevLink  = &ItemMemory[i].LinearNext;
+		ItemMemory[i].FreePrevLink = NULL;
+		ItemMemory[i].HeapIndex    = INDEX_NONE;
 	}}
 	*PrevLink = NULL;
 
@@ -94,9 +108,12 @@ void FMemCache::Init
 		Segment
 	);
 
+	// Put the segments' free space on the free lists.
+	{for( FCacheItem* Item=CacheItems; Item!=LastItem; Item=Item->LinearNext )
+		LinkFree( Item );}
+
 	// Init the hash table to empty since no items are used.
-	{for( INT i=0; i<HASH_COUNT; i++ )
-		HashItems[i] = NULL;}
+	appMemzero( HashIds, HashSize * sizeof(QWORD) );
 
 	// Success.
 	Initialized=1;
@@ -113,9 +130,13 @@ void FMemCache::Exit( UBOOL FreeMemory )
 	if( Initialized )
 	{
 		CheckState();
+		Exec( TEXT("CACHERECORD STOP") );
 
 		// Release all memory.
 		delete ItemMemory;
+		appFree( Heap );
+		appFree( HashIds );
+		appFree( HashItems );
 		if( FreeMemory )
 			appFree( CacheMemory );
 
@@ -174,16 +195,24 @@ FMemCache::FCacheItem* FMemCache::FlushItem( FCacheItem* Item, UBOOL IgnoreLocke
 	if( Item->Cost < COST_INFINITE ) 
 	{
 		// Flush this one item.
+		HeapRemove( Item );
 		Item->Id	= 0;
 		Item->Cost	= 0;
 
 		// If previous item is free space, merge with it.
 		if( Item->LinearPrev && Item->LinearPrev->Id==0 && Item->Segment==Item->LinearPrev->Segment )
+		{
+			UnlinkFree( Item->LinearPrev );
 			Item = MergeWithNext( Item->LinearPrev );
+		}
 
 		// If next item is free space, merge with it.
-		if( Item->LinearNext && Item->LinearNext->Id==0 && Item->Segment==Item->LinearNext->Segment )
+		if( Item->LinearNext && Item->LinearNext!=LastItem && Item->LinearNext->Id==0 && Item->Segment==Item->LinearNext->Segment )
+		{
+			UnlinkFree( Item->LinearNext );
 			Item = MergeWithNext( Item );
+		}
+		LinkFree( Item );
 	}
 	else if( !IgnoreLocked )
 	{
@@ -242,15 +271,19 @@ void FMemCache::CheckState()
 			check( Item->LinearPrev->LinearNext == Item );
 		}
 
+		// Free space must be on a free list, used items in the heap.
+		check( (Item->Id==0) == (Item->FreePrevLink!=NULL) );
+		check( (Item->Id!=0) == (Item->HeapIndex!=INDEX_NONE) );
+		if( Item->HeapIndex!=INDEX_NONE )
+			check( Heap[Item->HeapIndex]==Item );
+
 		// If used, make sure this item is hashed exactly once.
 		if( Item->Id )
 		{
 			UsedItemCount++;
-			INT HashedCount=0;
-			for( FCacheItem* HashItem=HashItems[GHash(Item->Id)]; HashItem; HashItem=HashItem->HashNext )
-				HashedCount += (HashItem == Item);
-			check(HashedCount!=0);
-			check(HashedCount==1);
+			INT Slot = FindSlot( Item->Id );
+			check(Slot!=INDEX_NONE);
+			check(&ItemMemory[HashItems[Slot]]==Item);
 		}
 	}
 	check( ExpectedPointer == CacheMemory + MemTotal );
@@ -265,26 +298,35 @@ void FMemCache::CheckState()
 	// Make sure all items are accounted for.
 	check( ItemCount+1==ItemsTotal );
 
-	// Make sure all hashed items are used, and there are no duplicate Id's.
+	// Make sure all hashed items are used, and every one can be found from
+	// its home slot, which also rules out duplicate Id's.
 	guard(3);
-	for( DWORD i=0; i<HASH_COUNT; i++ )
+	for( DWORD i=0; i<HashSize; i++ )
 	{
-		for( FCacheItem* Item=HashItems[i]; Item; Item=Item->HashNext )
+		if( HashIds[i] )
 		{
 			// Count this hash item.
 			HashCount++;
 
 			// Make sure this Id belongs here.
-			check( GHash(Item->Id) == i );
-
-			// Make sure this Id is not duplicated.
-			for( FCacheItem* Other=Item->HashNext; Other; Other=Other->HashNext )
-				check( Other->Id != Item->Id );
+			check( ItemMemory[HashItems[i]].Id == HashIds[i] );
+			check( FindSlot(HashIds[i]) == (INT)i );
 		}
 	}
 	check( HashCount == UsedItemCount );
 	unguard;
 
+	// Make sure the heap holds only used items, in order, and the free
+	// lists only free space of their size class.
+	guard(4);
+	check( HeapNum == UsedItemCount );
+	for( INT i=1; i<HeapNum; i++ )
+		check( HeapCost(Heap[(i-1)/2]) <= HeapCost(Heap[i]) );
+	for( INT i=0; i<FREE_LIST_COUNT; i++ )
+		for( FCacheItem* Item=FreeLists[i]; Item; Item=Item->FreeNext )
+			check( Item->Id==0 && appCeilLogTwo(Item->GetSize()+1)-1==i );
+	unguard;
+
 	// Success.
 	unguard;
 }
@@ -314,10 +356,12 @@ void FMemCache::CreateNewFreeSpace
 	{
 		// The previous item is free space, so automatically merge with it.
 	}
-	else if( Next && Next->Id==0 && Next->Segment==Segment )
+	else if( Next && Next!=LastItem && Next->Id==0 && Next->Segment==Segment )
 	{
 		// The next item is free space, so merge with it.
+		UnlinkFree( Next );
 		Next->Data = Start;
+		LinkFree( Next );
 	}
 	else
 	{
@@ -336,7 +380,6 @@ void FMemCache::CreateNewFreeSpace
 		Item->Cost			= 0;
 		Item->LinearNext	= Next;
 		Item->LinearPrev	= Prev;
-		Item->HashNext		= NULL;
 
 		// Link it in.
 		if( Prev )
@@ -344,12 +387,110 @@ void FMemCache::CreateNewFreeSpace
 		else
 			CacheItems = Item;
 
+		// Free space can only be sized once its successor is linked, so
+		// Init puts the segments on the free lists itself.
 		if( Next )
+		{
 			Next->LinearPrev = Item;
+			LinkFree( Item );
+		}
 	}
 	unguard;
 }
 
+/*-----------------------------------------------------------------------------
+	Hash.
+-----------------------------------------------------------------------------*/
+
+//
+// Add a used item to the hash.
+//
+void FMemCache::Hash( FCacheItem* Item )
+{
+	DWORD Slot = HashSlot( Item->Id );
+	while( HashIds[Slot] )
+		Slot = HashNext( Slot );
+	HashIds  [Slot] = Item->Id;
+	HashItems[Slot] = Item - ItemMemory;
+}
+
+//
+// Empty a hash slot, moving later entries of its run back into the gap
+// so every entry stays reachable from its home slot.
+//
+void FMemCache::RemoveSlot( DWORD Slot )
+{
+	for( DWORD Next=HashNext(Slot); HashIds[Next]; Next=HashNext(Next) )
+	{
+		DWORD Home = HashSlot( HashIds[Next] );
+		if( (Next-Home+HashSize) % HashSize >= (Next-Slot+HashSize) % HashSize )
+		{
+			HashIds  [Slot] = HashIds  [Next];
+			HashItems[Slot] = HashItems[Next];
+			Slot            = Next;
+		}
+	}
+	HashIds[Slot] = 0;
+}
+
+/*-----------------------------------------------------------------------------
+	Eviction heap.
+-----------------------------------------------------------------------------*/
+
+void FMemCache::HeapUp( INT Index )
+{
+	FCacheItem* Item = Heap[Index];
+	while( Index>0 && HeapCost(Heap[(Index-1)/2])>HeapCost(Item) )
+	{
+		Heap[Index]            = Heap[(Index-1)/2];
+		Heap[Index]->HeapIndex = Index;
+		Index                  = (Index-1)/2;
+	}
+	Heap[Index]     = Item;
+	Item->HeapIndex = Index;
+}
+
+void FMemCache::HeapDown( INT Index )
+{
+	FCacheItem* Item = Heap[Index];
+	for( ; ; )
+	{
+		INT Child = Index*2+1;
+		if( Child>=HeapNum )
+			break;
+		if( Child+1<HeapNum && HeapCost(Heap[Child+1])<HeapCost(Heap[Child]) )
+			Child++;
+		if( HeapCost(Heap[Child])>=HeapCost(Item) )
+			break;
+		Heap[Index]            = Heap[Child];
+		Heap[Index]->HeapIndex = Index;
+		Index                  = Child;
+	}
+	Heap[Index]     = Item;
+	Item->HeapIndex = Index;
+}
+
+void FMemCache::HeapInsert( FCacheItem* Item )
+{
+	checkSlow( Item->HeapIndex==INDEX_NONE );
+	checkSlow( HeapNum<ItemsTotal );
+	Heap[HeapNum] = Item;
+	HeapUp( HeapNum++ );
+}
+
+void FMemCache::HeapRemove( FCacheItem* Item )
+{
+	INT Index = Item->HeapIndex;
+	checkSlow( Index!=INDEX_NONE && Heap[Index]==Item );
+	Item->HeapIndex = INDEX_NONE;
+	if( Index != --HeapNum )
+	{
+		Heap[Index] = Heap[HeapNum];
+		HeapDown( Index );
+		HeapUp( Heap[Index]->HeapIndex );
+	}
+}
+
 /*-----------------------------------------------------------------------------
 	Flushing.
 -----------------------------------------------------------------------------*/
@@ -366,6 +507,8 @@ void FMemCache::Flush( QWORD Id, DWORD Mask, UBOOL IgnoreLocked )
 	MruItem   = NULL;
 	if( !Initialized )
 		return;
+	if( Recorder )
+		Record( CACHEOP_Flush, Id, Mask );
 
 	// Special case for flushing all items.
 	if( Id == 0 )
@@ -373,22 +516,15 @@ void FMemCache::Flush( QWORD Id, DWORD Mask, UBOOL IgnoreLocked )
 	if( Mask == ~0 )
 	{
 		// Quickly flush a single element.
-		FCacheItem** PrevLink = &HashItems[GHash(Id)];
-		while( *PrevLink != NULL )
+		INT Slot = FindSlot( Id );
+		if( Slot != INDEX_NONE )
 		{
-			FCacheItem *Item = *PrevLink;			
-			if( Item->Id == Id )
-			{
-				// Remove item from hash.
-				*PrevLink = Item->HashNext;
-
-				// Flush the item.
-				FlushItem( Item, IgnoreLocked );
-				
-				// Successfully flushed.
-				break;
-			}
-			PrevLink = &Item->HashNext;
+			// Remove item from hash.
+			FCacheItem* Item = &ItemMemory[HashItems[Slot]];
+			RemoveSlot( Slot );
+
+			// Flush the item.
+			FlushItem( Item, IgnoreLocked );
 		}
 	}
 	else
@@ -429,13 +565,91 @@ void FMemCache::Flush( QWORD Id, DWORD Mask, UBOOL IgnoreLocked )
 	Creating.
 -----------------------------------------------------------------------------*/
 
+//
+// Find free space that can hold an item by itself, from the free list of
+// its size class up.
+//
+FMemCache::FCacheItem* FMemCache::FindFree( INT Size, INT Alignment )
+{
+	guardSlow(FMemCache::FindFree);
+	for( INT i=appCeilLogTwo(Size+1)-1; i<FREE_LIST_COUNT; i++ )
+		for( FCacheItem* Item=FreeLists[i]; Item; Item=Item->FreeNext )
+			if( Fits( Item, Item, Size, Alignment ) )
+				return Item;
+	return NULL;
+	unguardSlow;
+}
+
+//
+// Find a contiguous run of items to evict for a new item. Each of the
+// cheapest few items in the eviction heap seeds a run, which grows
+// towards its cheaper unlocked neighbor until it is big enough, and the
+// cheapest run found wins. Locked items are set aside and put back.
+//
+UBOOL FMemCache::FindEvictable( INT Size, INT Alignment, FCacheItem*& BestFirst, FCacheItem*& BestLast )
+{
+	guardSlow(FMemCache::FindEvictable);
+	FCacheItem* Popped[EVICT_SEEDS*4];
+	INT NumPopped=0, NumSeeds=0;
+	SQWORD BestCost = COST_INFINITE;
+	BestFirst = BestLast = NULL;
+	while( HeapNum && NumSeeds<EVICT_SEEDS && NumPopped<(INT)ARRAY_COUNT(Popped) )
+	{
+		FCacheItem* Seed = Heap[0];
+		HeapRemove( Seed );
+		Popped[NumPopped++] = Seed;
+		if( Seed->Cost >= COST_INFINITE )
+			continue;
+		NumSeeds++;
+
+		// Grow the run around the seed.
+		FCacheItem* First = Seed;
+		FCacheItem* Last  = Seed;
+		SQWORD      Cost  = Seed->Cost;
+		while( !Fits( First, Last, Size, Alignment ) && Cost<BestCost )
+		{
+			FCacheItem* Prev = First->LinearPrev;
+			FCacheItem* Next = Last->LinearNext;
+			if( Prev && (Prev->Segment!=Seed->Segment || Prev->Cost>=COST_INFINITE) )
+				Prev = NULL;
+			if( Next==LastItem || Next->Segment!=Seed->Segment || Next->Cost>=COST_INFINITE )
+				Next = NULL;
+			if( Prev && (!Next || Prev->Cost<=Next->Cost) )
+			{
+				First = Prev;
+				Cost += Prev->Cost;
+			}
+			else if( Next )
+			{
+				Last  = Next;
+				Cost += Next->Cost;
+			}
+			else break;
+		}
+		if( Cost<BestCost && Fits( First, Last, Size, Alignment ) )
+		{
+			BestCost  = Cost;
+			BestFirst = First;
+			BestLast  = Last;
+		}
+		else if( !BestFirst )
+		{
+			// Keep looking until something fits.
+			NumSeeds--;
+		}
+	}
+	for( INT i=0; i<NumPopped; i++ )
+		HeapInsert( Popped[i] );
+	return BestFirst!=NULL;
+	unguardSlow;
+}
+
 //
 // Create an element in the cache.
 //
-// This is O(num_items_in_cache), sacrificing some speed in the
-// name of better cache efficiency. However there aren't any really
-// good algorithms for priority queues where most priorities change
-// every iteration this that I'm aware of.
+// Free space big enough for the item comes off the segregated free lists.
+// Otherwise the cheapest items in the eviction heap seed runs of items to
+// evict. Only when none of those fit is the whole cache scanned.
 //
 BYTE* FMemCache::Create
 (
@@ -452,43 +666,35 @@ BYTE* FMemCache::Create
 	check(CreateSize > 0);
 	check(Id != 0);
 	NumCreates++;
+	if( Recorder )
+		Record( CACHEOP_Create, Id, CreateSize, Alignment, SafetyPad );
 
-	// Best cost and starting element found thus far.
-	SQWORD	    BestCost  = COST_INFINITE;
-	FCacheItem* BestFirst = NULL;
-	FCacheItem* BestLast  = NULL;
-
-	// Iterate through items. Find shortest contiguous sets of items
-	// which contain enough space for this entry. Evaluate the sum cost
-	// for each set, remembering the best cost.
-	SQWORD Cost=0;
-	FCacheItem* First=CacheItems;
-	{for( FCacheItem* Last=CacheItems; Last!=LastItem; Last=Last->LinearNext )
+	// Free space costs nothing, so it is always the best choice.
+	FCacheItem* BestFirst = FindFree( CreateSize+SafetyPad, Alignment );
+	FCacheItem* BestLast  = BestFirst;
+	if( BestFirst == NULL && !FindEvictable( CreateSize+SafetyPad, Alignment, BestFirst, BestLast ) )
 	{
-		// Add the cost and size of new Last element to our accumulator.
-		Cost += Last->Cost;
-
-		// While the interval from First to Last (inclusive) contains
-		// enough space for the item we're creating, consider it as a
-		// candidate, and go to the next First.
-		while( First && (Last->LinearNext->Data - Align(First->Data,Alignment) >= (CreateSize+SafetyPad)) )
+		// Nothing near the cheapest items fits, so fall back to checking
+		// every contiguous run of items, remembering the cheapest.
+		SQWORD BestCost=COST_INFINITE, Cost=0;
+		FCacheItem* First=CacheItems;
+		for( FCacheItem* Last=CacheItems; Last!=LastItem; Last=Last->LinearNext )
 		{
-			// Is this the best solution so far?
-			if( Cost<BestCost && First->Segment==Last->Segment )
+			Cost += Last->Cost;
+			while( First && Fits( First, Last, CreateSize+SafetyPad, Alignment ) )
 			{
-				BestCost  = Cost;
-				BestFirst = First;
-				BestLast  = Last;
+				if( Cost<BestCost && First->Segment==Last->Segment )
+				{
+					BestCost  = Cost;
+					BestFirst = First;
+					BestLast  = Last;
+				}
+				Cost -= First->Cost;
+				checkSlow(Cost>=0);
+				First = First->LinearNext;
 			}
-
-			// Subtract the cost and size from the element we're passing:
-			Cost -= First->Cost;
-			checkSlow(Cost>=0);
-
-			// Go to next First.
-			First = First->LinearNext;
 		}
-	}}
+	}
 
 	// See if we found a suitable place to put the item.
 	if( BestFirst == NULL )
@@ -509,6 +715,20 @@ BYTE* FMemCache::Create
 		appErrorf( TEXT("Create %08x.%08X failed: Size=%i Pad=%i Align=%i NumLocked=%i BytesLocked=%i/%i"), (DWORD)(Id>>32), (DWORD)Id, CreateSize, SafetyPad, Alignment, ItemsLocked, BytesLocked, Bytes );
 	}
 
+	// Take everything in the run off the free lists and the heap.
+	for( FCacheItem* Evict=BestFirst; ; Evict=Evict->LinearNext )
+	{
+		if( Evict->Id != 0 )
+		{
+			HeapRemove( Evict );
+			NumEvicted++;
+			EvictedBytes += Evict->GetSize();
+		}
+		else UnlinkFree( Evict );
+		if( Evict==BestLast )
+			break;
+	}
+
 	// Merge all items from Start to End into one bigger item,
 	// while unhashing them all.
 	while( BestLast != BestFirst )
@@ -530,9 +750,7 @@ BYTE* FMemCache::Create
 	BestFirst->Cost = CreateSize + COST_INFINITE;
 
 	// Hash it.
-	FCacheItem** HashPtr	= &HashItems[GHash(Id)];
-	BestFirst->HashNext		= *HashPtr;
-	*HashPtr				= BestFirst;
+	Hash( BestFirst );
 
 	// Create free space past the end of the newly allocated block.
 	if( UnusedItems && (Result + CreateSize < BestFirst->LinearNext->Data ) )
@@ -563,6 +781,9 @@ BYTE* FMemCache::Create
 		BestFirst->Data = Result;
 	}
 
+	// Its size is final now, so it can go in the eviction heap.
+	HeapInsert( BestFirst );
+
 	// Set the resulting Item.
 	MruItem = Item = BestFirst;
 	MruId          = Id;
@@ -586,6 +807,8 @@ void FMemCache::Tick()
 	guard(FMemCache::Tick);
 	clock(TickCycles);
 	ConditionalCheckState();
+	if( Recorder )
+		Record( CACHEOP_Tick, 0 );
 	MruId     = 0;
 	MruItem   = NULL;
 
@@ -629,6 +852,15 @@ void FMemCache::Tick()
 			Item->Cost -= (Item->Cost >> 5);
 #endif
 
+	// Costs changed, so reorder the eviction heap.
+	for( INT i=HeapNum/2-1; i>=0; i-- )
+		HeapDown( i );
+
+	// Per frame eviction stats.
+	LastEvictedBytes = EvictedBytes;
+	PeakEvictedBytes = Max( PeakEvictedBytes, EvictedBytes );
+	EvictedBytes     = 0;
+
 	// Update the cache's time.
 	Time++;
 	unclock(TickCycles);
@@ -661,10 +893,68 @@ UBOOL FMemCache::Exec( const TCHAR* Cmd, FOutputDevice& Ar )
 		}
 		return 1;
 	}
+	else if( ParseCommand(&Cmd,TEXT("CACHERECORD")) )
+	{
+		// CACHERECORD <file> starts writing every Get, Create, Tick and
+		// Flush to a file for DCUtil CACHEBENCH to replay, STOP ends it.
+		if( Recorder )
+		{
+			delete Recorder;
+			Recorder = NULL;
+			Ar.Logf( TEXT("Cache recording stopped") );
+		}
+		TCHAR Filename[256];
+		if( ParseToken( Cmd, Filename, ARRAY_COUNT(Filename), 0 ) && appStricmp(Filename,TEXT("STOP"))!=0 )
+		{
+			Recorder = GFileManager->CreateFileWriter( Filename );
+			if( !Recorder )
+			{
+				Ar.Logf( TEXT("Couldn't open %s"), Filename );
+				return 1;
+			}
+			INT Magic=RECORD_MAGIC;
+			*Recorder << Magic << MemTotal << ItemsTotal;
+			Ar.Logf( TEXT("Recording cache traffic to %s"), Filename );
+		}
+		return 1;
+	}
+	else if( ParseCommand(&Cmd,TEXT("CACHESTATS")) )
+	{
+		INT FreeBytes=0, FreeItems=0, LargestFree=0, LockedBytes=0;
+		for( INT i=0; i<FREE_LIST_COUNT; i++ )
+		{
+			for( FCacheItem* Item=FreeLists[i]; Item; Item=Item->FreeNext )
+			{
+				FreeBytes  += Item->GetSize();
+				LargestFree = Max( LargestFree, Item->GetSize() );
+				FreeItems++;
+			}
+		}
+		for( INT i=0; i<HeapNum; i++ )
+			if( Heap[i]->Cost >= COST_INFINITE )
+				LockedBytes += Heap[i]->GetSize();
+		INT Gets = NumHits + NumMisses;
+		Ar.Logf( TEXT("Cache: %iK total, %i items used, %i free blocks"), MemTotal/1024, HeapNum, FreeItems );
+		Ar.Logf( TEXT("Hits: %i of %i gets (%.1f%%)"), NumHits, Gets, Gets ? 100.0 * NumHits / Gets : 0.0 );
+		Ar.Logf( TEXT("Evicted: %i items, %iK last frame, %iK peak frame"), NumEvicted, LastEvictedBytes/1024, PeakEvictedBytes/1024 );
+		Ar.Logf( TEXT("Free: %iK, largest block %iK, fragmentation %.1f%%"), FreeBytes/1024, LargestFree/1024, FreeBytes ? 100.0 * (FreeBytes-LargestFree) / FreeBytes : 0.0 );
+		Ar.Logf( TEXT("Locked: %iK"), LockedBytes/1024 );
+		if( ParseCommand(&Cmd,TEXT("RESET")) )
+			NumHits = NumMisses = NumEvicted = PeakEvictedBytes = 0;
+		return 1;
+	}
 	else return 0;
 	unguard;
 }
 
+//
+// Write one operation to the CACHERECORD file.
+//
+void FMemCache::Record( BYTE Op, QWORD Id, INT A, INT B, INT C )
+{
+	*Recorder << Op << Id << A << B << C;
+}
+
 /*-----------------------------------------------------------------------------
 	Status.
 -----------------------------------------------------------------------------*/
@@ -324,6 +324,255 @@ void UStruct::Register()
 	unguard;
 }
 
+//
+// Builds a reference token stream. Adjacent object pointers and names
+// share a token.
+//
+class FRefTokenBuilder
+{
+public:
+	FRefTokenBuilder( TArray<FRefToken>& InTokens )
+	:	Tokens		( InTokens )
+	,	MergeFrom	( InTokens.Num() )
+	{}
+	void AddStruct( UStruct* Struct, INT Offset )
+	{
+		guard(FRefTokenBuilder::AddStruct);
+		for( TFieldIterator<UProperty> It(Struct); It; ++It )
+			if( !(It->PropertyFlags & CPF_Native) )
+				for( INT i=0; i<It->ArrayDim; i++ )
+					AddProperty( *It, Offset + It->Offset + i*It->ElementSize );
+		unguard;
+	}
+	void AddProperty( UProperty* Property, INT Offset )
+	{
+		guard(FRefTokenBuilder::AddProperty);
+		if( Property->IsA(UObjectProperty::StaticClass()) )
+		{
+			AddRef( REF_Object, Offset, sizeof(UObject*) );
+		}
+		else if( Property->IsA(UNameProperty::StaticClass()) )
+		{
+			AddRef( REF_Name, Offset, sizeof(FName) );
+		}
+		else if( Property->IsA(UStructProperty::StaticClass()) )
+		{
+			AddStruct( ((UStructProperty*)Property)->Struct, Offset );
+		}
+		else if( Property->IsA(UFixedArrayProperty::StaticClass()) )
+		{
+			UFixedArrayProperty* Fixed = (UFixedArrayProperty*)Property;
+			for( INT i=0; i<Fixed->Count; i++ )
+				AddProperty( Fixed->Inner, Offset + i*Fixed->Inner->ElementSize );
+		}
+		else if( Property->IsA(UArrayProperty::StaticClass()) )
+		{
+			UProperty* Inner = ((UArrayProperty*)Property)->Inner;
+			if( Inner->IsA(UObjectProperty::StaticClass()) )
+				Add( REF_ObjectArray, Offset );
+			else if( Inner->IsA(UNameProperty::StaticClass()) )
+				Add( REF_NameArray, Offset );
+			else if( !HasNoRefs(Inner) )
+			{
+				// Element tokens follow the array token, relative to each element.
+				INT iArray = Add( REF_StructArray, Offset );
+				Tokens(iArray).Stride = Inner->ElementSize;
+				MergeFrom = Tokens.Num();
+				AddProperty( Inner, 0 );
+				Tokens(iArray).Count = Tokens.Num() - iArray - 1;
+				MergeFrom = Tokens.Num();
+				if( Tokens(iArray).Count==0 )
+					Tokens.Remove( iArray );
+			}
+		}
+		else if( !HasNoRefs(Property) )
+		{
+			Tokens(Add( REF_Property, Offset )).Property = Property;
+		}
+		unguard;
+	}
+private:
+	TArray<FRefToken>&	Tokens;
+	INT					MergeFrom;
+
+	static UBOOL HasNoRefs( UProperty* Property )
+	{
+		return
+		(	Property->IsA(UByteProperty::StaticClass())
+		||	Property->IsA(UIntProperty::StaticClass())
+		||	Property->IsA(UBoolProperty::StaticClass())
+		||	Property->IsA(UFloatProperty::StaticClass())
+		||	Property->IsA(UStrProperty::StaticClass()) );
+	}
+	INT Add( INT Type, INT Offset )
+	{
+		INT i = Tokens.AddZeroed();
+		Tokens(i).Type   = Type;
+		Tokens(i).Offset = Offset;
+		Tokens(i).Count  = 1;
+		return i;
+	}
+	void AddRef( INT Type, INT Offset, INT Size )
+	{
+		if( Tokens.Num()>MergeFrom )
+		{
+			FRefToken& Last = Tokens.Last();
+			if( Last.Type==Type && Last.Offset+Last.Count*Size==Offset )
+			{
+				Last.Count++;
+				return;
+			}
+		}
+		Add( Type, Offset );
+	}
+};
+
+//
+// Builds copy and compare plans. Steps are collected per value, sorted
+// by offset and merged where plain data is contiguous.
+//
+class FPropertyPlanBuilder
+{
+public:
+	// Copy plan: every byte is copied, and only values that need
+	// constructing (as listed by ConstructorLink) get steps of their own.
+	static void BuildCopyPlan( UStruct* Struct, TArray<FPropertyOp>& Plan )
+	{
+		guard(FPropertyPlanBuilder::BuildCopyPlan);
+		TArray<FPropertyOp> Ops;
+		AddConstructed( Ops, Struct, 0 );
+		Sort( Ops );
+		Plan.Empty();
+		INT Pos = 0;
+		for( INT i=0; i<Ops.Num(); i++ )
+		{
+			AddBytes( Plan, Pos, Ops(i).Offset-Pos );
+			Plan.AddItem( Ops(i) );
+			Pos = Ops(i).Offset + Ops(i).Size;
+		}
+		AddBytes( Plan, Pos, Struct->GetPropertiesSize()-Pos );
+		Plan.Shrink();
+		unguard;
+	}
+
+	// Compare plan: every property value, as UProperty::Identical would
+	// compare it.
+	static void BuildComparePlan( UStruct* Struct, TArray<FPropertyOp>& Plan )
+	{
+		guard(FPropertyPlanBuilder::BuildComparePlan);
+		TArray<FPropertyOp> Ops;
+		AddCompared( Ops, Struct, 0 );
+		Sort( Ops );
+		Plan.Empty();
+		for( INT i=0; i<Ops.Num(); i++ )
+		{
+			FPropertyOp& Op = Ops(i);
+			if( Plan.Num() )
+			{
+				FPropertyOp& Last = Plan.Last();
+				if( Last.Type==POP_Bytes && Op.Type==POP_Bytes && Last.Offset+Last.Size==Op.Offset )
+				{
+					Last.Size += Op.Size;
+					continue;
+				}
+				if( Last.Type==POP_Floats && Op.Type==POP_Floats && Last.Offset+Last.Size*(INT)sizeof(FLOAT)==Op.Offset )
+				{
+					Last.Size += Op.Size;
+					continue;
+				}
+				if( Last.Type==POP_Bool && Op.Type==POP_Bool && Last.Offset==Op.Offset )
+				{
+					Last.Size |= Op.Size;
+					continue;
+				}
+			}
+			Plan.AddItem( Op );
+		}
+		Plan.Shrink();
+		unguard;
+	}
+
+	// The compare step for one value of a property.
+	static FPropertyOp CompareOp( UProperty* Property, INT Offset )
+	{
+		FPropertyOp Op = { POP_Property, Offset, Property->ElementSize, Property };
+		if( Property->IsA(UBoolProperty::StaticClass()) )
+			{Op.Type = POP_Bool; Op.Size = ((UBoolProperty*)Property)->BitMask;}
+		else if( Property->IsA(UFloatProperty::StaticClass()) )
+			{Op.Type = POP_Floats; Op.Size = 1;}
+		else if( Property->IsA(UObjectProperty::StaticClass()) )
+			Op.Type = POP_Object;
+		else if( Property->IsA(UStrProperty::StaticClass()) )
+			Op.Type = POP_String;
+		else if
+		(	Property->IsA(UByteProperty::StaticClass())
+		||	Property->IsA(UIntProperty::StaticClass())
+		||	Property->IsA(UNameProperty::StaticClass()) )
+			Op.Type = POP_Bytes;
+		return Op;
+	}
+
+private:
+	static void AddConstructed( TArray<FPropertyOp>& Ops, UStruct* Struct, INT Offset )
+	{
+		for( UProperty* P=Struct->ConstructorLink; P; P=P->ConstructorLinkNext )
+		{
+			for( INT i=0; i<P->ArrayDim; i++ )
+			{
+				INT ElementOffset = Offset + P->Offset + i*P->ElementSize;
+				if( P->IsA(UStructProperty::StaticClass()) )
+				{
+					AddConstructed( Ops, ((UStructProperty*)P)->Struct, ElementOffset );
+				}
+				else
+				{
+					FPropertyOp Op = { P->IsA(UStrProperty::StaticClass()) ? POP_String : POP_Property, ElementOffset, P->ElementSize, P };
+					Ops.AddItem( Op );
+				}
+			}
+		}
+	}
+	static void AddCompared( TArray<FPropertyOp>& Ops, UStruct* Struct, INT Offset )
+	{
+		for( TFieldIterator<UProperty> It(Struct); It; ++It )
+		{
+			for( INT i=0; i<It->ArrayDim; i++ )
+			{
+				INT ElementOffset = Offset + It->Offset + i*It->ElementSize;
+				if( It->IsA(UStructProperty::StaticClass()) )
+				{
+					AddCompared( Ops, ((UStructProperty*)*It)->Struct, ElementOffset );
+				}
+				else
+				{
+					// Object pointers compare as plain data here.
+					FPropertyOp Op = CompareOp( *It, ElementOffset );
+					if( Op.Type==POP_Object )
+						Op.Type = POP_Bytes;
+					Ops.AddItem( Op );
+				}
+			}
+		}
+	}
+	static void AddBytes( TArray<FPropertyOp>& Plan, INT Offset, INT Size )
+	{
+		if( Size>0 )
+		{
+			FPropertyOp Op = { POP_Bytes, Offset, Size, NULL };
+			Plan.AddItem( Op );
+		}
+	}
+	static QSORT_RETURN CDECL CompareOffset( const FPropertyOp* A, const FPropertyOp* B )
+	{
+		return A->Offset - B->Offset;
+	}
+	static void Sort( TArray<FPropertyOp>& Ops )
+	{
+		if( Ops.Num() )
+			appQsort( &Ops(0), Ops.Num(), sizeof(FPropertyOp), (QSORT_COMPARE)CompareOffset );
+	}
+};
+
 //
 // Link offsets.
 //
@@ -438,6 +687,23 @@ void UStruct::Link( FArchive& Ar, UBOOL Props )
 	*ConstructorLinkPtr = NULL;
 	unguard;
 
+	// Build the reference token stream and property plans. Only structs
+	// and classes have instances to serialize, copy or compare.
+	guard(LinkRefTokens);
+	RefTokens.Empty();
+	CopyPlan.Empty();
+	ComparePlan.Empty();
+	if( GetClass()==UStruct::StaticClass() || IsA(UClass::StaticClass()) )
+	{
+		FRefTokenBuilder( RefTokens ).AddStruct( this, 0 );
+		RefTokens.AddZeroed();
+		RefTokens.Shrink();
+		FPropertyPlanBuilder::BuildCopyPlan( this, CopyPlan );
+		if( GetClass()==UStruct::StaticClass() )
+			FPropertyPlanBuilder::BuildComparePlan( this, ComparePlan );
+	}
+	unguard;
+
 	unguard;
 }
 
@@ -450,6 +716,11 @@ void UStruct::SerializeBin( FArchive& Ar, BYTE* Data )
 	FName PropertyName(NAME_None);
 	INT Index=0;
 	guard(UStruct::SerializeBin);
+	if( Ar.RefsOnly() && RefTokens.Num() )
+	{
+		SerializeRefs( Ar, Data );
+		return;
+	}
 	for( TFieldIterator<UProperty> It(this); It; ++It )
 	{
 		PropertyName = It->GetFName();
@@ -459,6 +730,113 @@ void UStruct::SerializeBin( FArchive& Ar, BYTE* Data )
 	}
 	unguardf(( TEXT("(%s %s[%i])"), GetFullName(), *PropertyName, Index ));
 }
+
+//
+// Serialize the object references and names in Data by walking
+// RefTokens, for archives that only care about those.
+//
+static void SerializeRefTokens( FArchive& Ar, BYTE* Data, const FRefToken* Token, const FRefToken* End )
+{
+	guardSlow(SerializeRefTokens);
+	while( Token<End )
+	{
+		BYTE* Ptr = Data + Token->Offset;
+		switch( Token->Type )
+		{
+			case REF_Object:
+				for( INT i=0; i<Token->Count; i++ )
+					Ar << ((UObject**)Ptr)[i];
+				break;
+			case REF_Name:
+				for( INT i=0; i<Token->Count; i++ )
+					Ar << ((FName*)Ptr)[i];
+				break;
+			case REF_ObjectArray:
+			{
+				TArray<UObject*>& Array = *(TArray<UObject*>*)Ptr;
+				for( INT i=0; i<Array.Num(); i++ )
+					Ar << Array(i);
+				break;
+			}
+			case REF_NameArray:
+			{
+				TArray<FName>& Array = *(TArray<FName>*)Ptr;
+				for( INT i=0; i<Array.Num(); i++ )
+					Ar << Array(i);
+				break;
+			}
+			case REF_StructArray:
+			{
+				FArray& Array = *(FArray*)Ptr;
+				BYTE* Element = (BYTE*)Array.GetData();
+				for( INT i=0; i<Array.Num(); i++ )
+					SerializeRefTokens( Ar, Element + i*Token->Stride, Token+1, Token+1+Token->Count );
+				Token += Token->Count;
+				break;
+			}
+			case REF_Property:
+				Token->Property->SerializeItem( Ar, Ptr );
+				break;
+			case REF_End:
+				return;
+			default:
+				appErrorf( TEXT("Bad reference token %i"), Token->Type );
+		}
+		Token++;
+	}
+	unguardSlow;
+}
+void UStruct::SerializeRefs( FArchive& Ar, BYTE* Data )
+{
+	guard(UStruct::SerializeRefs);
+	check(RefTokens.Num());
+	SerializeRefTokens( Ar, Data, &RefTokens(0), &RefTokens(0) + RefTokens.Num() );
+	unguardobj;
+}
+
+//
+// Copy Src to Dest by CopyPlan, skipping the first Start bytes. With
+// Construct, Dest's strings and arrays are uninitialized and get built
+// rather than assigned.
+//
+void UStruct::RunCopyPlan( BYTE* Dest, BYTE* Src, INT Start, UBOOL Construct )
+{
+	guardSlow(UStruct::RunCopyPlan);
+	for( INT i=0; i<CopyPlan.Num(); i++ )
+	{
+		const FPropertyOp& Op = CopyPlan(i);
+		BYTE* D = Dest + Op.Offset;
+		BYTE* S = Src  + Op.Offset;
+		if( Op.Offset+Op.Size<=Start )
+			continue;
+		if( Op.Type==POP_Bytes )
+		{
+			INT Skip = Max( Start-Op.Offset, 0 );
+			appMemcpy( D+Skip, S+Skip, Op.Size-Skip );
+			continue;
+		}
+		if( Construct )
+			appMemzero( D, Op.Size );
+		if( Op.Type==POP_String )
+			*(FString*)D = *(FString*)S;
+		else
+			Op.Property->CopySingleValue( D, S );
+	}
+	unguardobjSlow;
+}
+
+//
+// Compare A and B by ComparePlan.
+//
+UBOOL UStruct::RunComparePlan( const BYTE* A, const BYTE* B )
+{
+	guardSlow(UStruct::RunComparePlan);
+	for( INT i=0; i<ComparePlan.Num(); i++ )
+		if( !ComparePlan(i).Identical( A, B ) )
+			return 0;
+	return 1;
+	unguardobjSlow;
+}
 void UStruct::SerializeTaggedProperties( FArchive& Ar, BYTE* Data, UClass* DefaultsClass )
 {
 	FName PropertyName(NAME_None);
@@ -587,6 +965,15 @@ void UStruct::Destroy()
 {
 	guard(UStruct::Destroy);
 	Script.Empty();
+	RefTokens.Empty();
+	CopyPlan.Empty();
+	ComparePlan.Empty();
+#if DO_THREADED_SCRIPT
+	Threaded.Empty();
+	CallCache.Empty();
+	CallCacheEpoch = 0;
+	GCallCacheEpoch++;
+#endif
 	Super::Destroy();
 	unguard;
 }
@@ -610,6 +997,9 @@ void UStruct::Serialize( FArchive& Ar )
 	{
 		Script.Empty();
 		Script.Add( ScriptSize );
+#if DO_THREADED_SCRIPT
+		Threaded.Empty();
+#endif
 	}
 	INT iCode = 0;
 	while( iCode < ScriptSize )
@@ -742,6 +1132,7 @@ void UState::Link( FArchive& Ar, UBOOL Props )
 		It->HashNext       = VfHash[iHash];
 		VfHash[iHash]      = *It;
 	}
+	GCallCacheEpoch++;
 
 	unguard;
 }
@@ -794,6 +1185,7 @@ void UClass::Bind()
 {
 	guard(UClass::Bind);
 	UStruct::Bind();
+	GCallCacheEpoch++;
 	check(GIsEditor || GetSuperClass() || this==UObject::StaticClass());
 	if( !ClassConstructor && (GetFlags() & RF_Native) )
 	{
@@ -897,6 +1289,8 @@ void UClass::Link( FArchive& Ar, UBOOL Props )
 						P->RepIndex = ClassReps.Num();
 						for( INT i=0; i<P->ArrayDim; i++ )
 							new(ClassReps)FRepRecord(P,i);
+						for( INT i=0; i<P->ArrayDim; i++ )
+							ClassReps(P->RepIndex+i).Op = FPropertyPlanBuilder::CompareOp( P, P->Offset + i*P->ElementSize );
 					}
 				}
 			}
@@ -1361,6 +1755,300 @@ void UStruct::PostLoad()
 	Super::PostLoad();
 	unguard;
 }
+void UStruct::Bind()
+{
+	guard(UStruct::Bind);
+	Super::Bind();
+
+	// Script being edited changes under us, so only pre-decode in the game.
+	static INT NoThreadedScript = -1;
+	if( NoThreadedScript<0 )
+		NoThreadedScript = ParseParam( appCmdLine(), TEXT("NOTHREADEDSCRIPT") );
+	ThreadScript( !GIsEditor && !NoThreadedScript );
+
+	unguard;
+}
+
+/*-----------------------------------------------------------------------------
+	Threaded script.
+-----------------------------------------------------------------------------*/
+
+#if DO_THREADED_SCRIPT
+//
+// Pick the threaded handler for a variable token, by the type of the
+// property it reads. Anything that needs more than a plain copy, and
+// properties not linked yet, stay on the native handler.
+//
+static BYTE ThreadVariable( UProperty* Property, BYTE Int, BYTE Object, BYTE Byte, BYTE Plain )
+{
+	if( !Property || Property->ElementSize==0 || (Property->PropertyFlags & CPF_NeedCtorLink) )
+		return THR_Native;
+	UClass* Class = Property->GetClass();
+	if( Property->ArrayDim==1 )
+	{
+		if( Class==UIntProperty::StaticClass() || Class==UFloatProperty::StaticClass() || Class==UNameProperty::StaticClass() )
+			return Int;
+		if( Class==UByteProperty::StaticClass() )
+			return Byte;
+		if( Property->IsA(UObjectProperty::StaticClass()) )
+			return Object;
+	}
+	if( Class==UStructProperty::StaticClass() && !((UStructProperty*)Property)->Struct->ConstructorLink )
+		return Plain;
+	return THR_Native;
+}
+
+//
+// Pre-decode one expression of Node's script into Node->Threaded, walking
+// the tokens the same way UStruct::SerializeExpr does. Clears Ok and stops
+// on anything it doesn't understand.
+//
+static EExprToken ThreadExpr( UStruct* Node, INT& iCode, UBOOL& Ok )
+{
+	#define SKIP(T) {iCode += sizeof(T);}
+	if( !Ok || iCode>=Node->Script.Num() )
+	{
+		Ok = 0;
+		return EX_EndFunctionParms;
+	}
+	INT iToken = iCode;
+	EExprToken Expr = (EExprToken)Node->Script(iCode++);
+	BYTE Op = THR_Native;
+	if( Expr >= EX_MinConversion && Expr < EX_MaxConversion )
+	{
+		ThreadExpr( Node, iCode, Ok );
+	}
+	else if( Expr >= EX_FirstNative )
+	{
+		while( ThreadExpr( Node, iCode, Ok ) != EX_EndFunctionParms );
+	}
+	else if( Expr >= EX_ExtendedNative )
+	{
+		SKIP(BYTE);
+		while( ThreadExpr( Node, iCode, Ok ) != EX_EndFunctionParms );
+	}
+	else switch( Expr )
+	{
+		case EX_Let:
+		case EX_LetBool:
+		case EX_ArrayElement:
+		case EX_DynArrayElement:
+			ThreadExpr( Node, iCode, Ok );
+			ThreadExpr( Node, iCode, Ok );
+			break;
+		case EX_Jump:
+			Op = THR_Jump;
+			SKIP(_WORD);
+			break;
+		case EX_LocalVariable:
+		case EX_InstanceVariable:
+		{
+			UProperty* Property = NULL;
+			if( iCode+(INT)sizeof(Property)<=Node->Script.Num() )
+				appMemcpy( &Property, &Node->Script(iCode), sizeof(Property) );
+			if( Expr==EX_LocalVariable )
+				Op = ThreadVariable( Property, THR_LocalInt, THR_LocalObject, THR_LocalByte, THR_LocalPlain );
+			else
+				Op = ThreadVariable( Property, THR_InstanceInt, THR_InstanceObject, THR_InstanceByte, THR_InstancePlain );
+			SKIP(UProperty*);
+			break;
+		}
+		case EX_DefaultVariable:
+		case EX_NativeParm:
+		case EX_ObjectConst:
+			SKIP(UObject*);
+			break;
+		case EX_IntZero:
+		case EX_False:
+			Op = THR_IntZero;
+			break;
+		case EX_IntOne:
+		case EX_True:
+			Op = THR_IntOne;
+			break;
+		case EX_NoObject:
+			Op = THR_NoObject;
+			break;
+		case EX_Self:
+			Op = THR_Self;
+			break;
+		case EX_Nothing:
+			Op = THR_Nothing;
+			break;
+		case EX_BoolVariable:
+		case EX_EndFunctionParms:
+		case EX_IteratorPop:
+		case EX_Stop:
+		case EX_IteratorNext:
+			break;
+		case EX_EatString:
+		case EX_Return:
+		case EX_GotoLabel:
+			ThreadExpr( Node, iCode, Ok );
+			break;
+		case EX_FinalFunction:
+			SKIP(UStruct*);
+			while( ThreadExpr( Node, iCode, Ok ) != EX_EndFunctionParms );
+			break;
+		case EX_VirtualFunction:
+		case EX_GlobalFunction:
+			if( Node->CallSites<MAXWORD && iCode+(INT)sizeof(FName)<=Node->Script.Num() )
+			{
+				// Number the call site for its cache.
+				Op = Expr==EX_VirtualFunction ? THR_VirtualFunction : THR_GlobalFunction;
+				_WORD iSite = Node->CallSites++;
+				appMemcpy( &Node->Threaded(iCode), &iSite, sizeof(iSite) );
+			}
+			SKIP(FName);
+			while( ThreadExpr( Node, iCode, Ok ) != EX_EndFunctionParms );
+			break;
+		case EX_ClassContext:
+		case EX_Context:
+			ThreadExpr( Node, iCode, Ok );
+			SKIP(_WORD);
+			SKIP(BYTE);
+			ThreadExpr( Node, iCode, Ok );
+			break;
+		case EX_New:
+			ThreadExpr( Node, iCode, Ok );
+			ThreadExpr( Node, iCode, Ok );
+			ThreadExpr( Node, iCode, Ok );
+			ThreadExpr( Node, iCode, Ok );
+			break;
+		case EX_IntConst:
+			Op = THR_IntConst;
+			SKIP(INT);
+			break;
+		case EX_FloatConst:
+			Op = THR_FloatConst;
+			SKIP(FLOAT);
+			break;
+		case EX_StringConst:
+			while( iCode<Node->Script.Num() && Node->Script(iCode++) );
+			break;
+		case EX_UnicodeStringConst:
+			while( iCode+1<Node->Script.Num() && (Node->Script(iCode) || Node->Script(iCode+1)) )
+				SKIP(_WORD);
+			SKIP(_WORD);
+			break;
+		case EX_NameConst:
+			SKIP(FName);
+			break;
+		case EX_RotationConst:
+		case EX_VectorConst:
+			SKIP(INT); SKIP(INT); SKIP(INT);
+			break;
+		case EX_ByteConst:
+			Op = THR_ByteConst;
+			SKIP(BYTE);
+			break;
+		case EX_IntConstByte:
+			Op = THR_IntConstByte;
+			SKIP(BYTE);
+			break;
+		case EX_MetaCast:
+		case EX_DynamicCast:
+		case EX_StructMember:
+			SKIP(UObject*);
+			ThreadExpr( Node, iCode, Ok );
+			break;
+		case EX_JumpIfNot:
+			Op = THR_JumpIfNot;
+			SKIP(_WORD);
+			ThreadExpr( Node, iCode, Ok );
+			break;
+		case EX_Iterator:
+			ThreadExpr( Node, iCode, Ok );
+			SKIP(_WORD);
+			break;
+		case EX_Switch:
+			SKIP(BYTE);
+			ThreadExpr( Node, iCode, Ok );
+			break;
+		case EX_Assert:
+		case EX_Skip:
+			SKIP(_WORD);
+			ThreadExpr( Node, iCode, Ok );
+			break;
+		case EX_Case:
+		{
+			_WORD W = MAXWORD;
+			if( iCode+(INT)sizeof(_WORD)<=Node->Script.Num() )
+				appMemcpy( &W, &Node->Script(iCode), sizeof(W) );
+			SKIP(_WORD);
+			if( W != MAXWORD )
+				ThreadExpr( Node, iCode, Ok );
+			break;
+		}
+		case EX_LabelTable:
+		{
+			for( ; ; )
+			{
+				FLabelEntry E(NAME_None,0);
+				if( iCode+(INT)sizeof(FLabelEntry)>Node->Script.Num() )
+				{
+					Ok = 0;
+					break;
+				}
+				appMemcpy( &E, &Node->Script(iCode), sizeof(E) );
+				SKIP(FLabelEntry);
+				if( E.Name == NAME_None )
+					break;
+			}
+			break;
+		}
+		case EX_StructCmpEq:
+		case EX_StructCmpNe:
+			SKIP(UStruct*);
+			ThreadExpr( Node, iCode, Ok );
+			ThreadExpr( Node, iCode, Ok );
+			break;
+		default:
+			Ok = 0;
+			break;
+	}
+	if( iCode > Node->Script.Num() )
+		Ok = 0;
+	if( Ok )
+		Node->Threaded(iToken) = Op;
+	return Ok ? Expr : EX_EndFunctionParms;
+	#undef SKIP
+}
+#endif
+
+//
+// Build or discard the threaded form of the script. Only functions are
+// threaded, as that's where script spends its time, and state code isn't
+// worth a second copy of its bytecode. Leaves it empty if any of the
+// script can't be pre-decoded, so the whole function falls back to plain
+// GNatives dispatch.
+//
+void UStruct::ThreadScript( UBOOL Enable )
+{
+	guard(UStruct::ThreadScript);
+#if DO_THREADED_SCRIPT
+	if( Enable && Threaded.Num() )
+		return;
+	Threaded.Empty();
+	CallCache.Empty();
+	CallCacheEpoch = 0;
+	CallSites = 0;
+	if( !Enable || !Script.Num() || !IsA(UFunction::StaticClass()) )
+		return;
+	Threaded.AddZeroed( Script.Num() );
+	UBOOL Ok = 1;
+	INT iCode = 0;
+	while( Ok && iCode<Script.Num() )
+		ThreadExpr( this, iCode, Ok );
+	if( !Ok || iCode!=Script.Num() )
+	{
+		debugf( NAME_DevLoad, TEXT("Not threading %s: can't decode at %04X"), GetFullName(), iCode );
+		Threaded.Empty();
+		CallSites = 0;
+	}
+#endif
+	unguardobj;
+}
 
 /*-----------------------------------------------------------------------------
 	UFunction.
@@ -1412,6 +2100,14 @@ void UFunction::PostLoad()
 	Super::PostLoad();
 	unguard;
 }
+void UFunction::Destroy()
+{
+	guard(UFunction::Destroy);
+	if( GScriptProfiler )
+		GScriptProfiler->Forget( this );
+	Super::Destroy();
+	unguard;
+}
 UProperty* UFunction::GetReturnProperty()
 {
 	guard(UFunction::GetReturnProperty);
@@ -1424,6 +2120,7 @@ UProperty* UFunction::GetReturnProperty()
 void UFunction::Bind()
 {
 	guard(UFunction::Bind);
+	Super::Bind();
 	if( !(FunctionFlags & FUNC_Native) )
 	{
 		// Use UnrealScript processing function.
@@ -0,0 +1,323 @@
+/*=============================================================================
+	UnCompress.cpp: Compressed package reading and writing.
+	Copyright 1997-1999 Epic Games, Inc. All Rights Reserved.
+=============================================================================*/
+
+#include "CorePrivate.h"
+#include "FCodec.h"
+
+/*-----------------------------------------------------------------------------
+	Codec.
+-----------------------------------------------------------------------------*/
+
+//
+// The codec every block goes through, the same chain as the .uz files use.
+//
+class FCodecPackage : public FCodecFull
+{
+public:
+	FCodecPackage()
+	{
+		AddCodec( new FCodecRLE );
+		AddCodec( new FCodecBWT );
+		AddCodec( new FCodecMTF );
+		AddCodec( new FCodecRLE );
+		AddCodec( new FCodecHuffman );
+	}
+};
+
+/*-----------------------------------------------------------------------------
+	FArchiveCompressedReader.
+-----------------------------------------------------------------------------*/
+
+//
+// Reader presenting a compressed package as the raw package. Blocks are
+// decoded as reads reach them, and the last few decoded are kept, since
+// loading jumps back and forth between the header tables and the exports.
+//
+class FArchiveCompressedReader : public FArchive
+{
+public:
+	FArchiveCompressedReader( FArchive* InReader, FOutputDevice* InError )
+	:	Reader		( InReader )
+	,	Error		( InError )
+	,	Pos			( 0 )
+	,	Current		( 0 )
+	,	UseCount	( 0 )
+	{
+		guard(FArchiveCompressedReader::FArchiveCompressedReader);
+		ArIsLoading = ArIsPersistent = 1;
+		for( INT i=0; i<CACHE_COUNT; i++ )
+		{
+			CacheBlock[i] = INDEX_NONE;
+			CacheUse  [i] = 0;
+		}
+		DWORD Tag;
+		INT BlockCount;
+		*Reader << Tag << BlockSize << Size << BlockCount;
+		check(Tag==PACKAGE_COMPRESSED_TAG);
+		if( BlockSize<=0 || Size<0 || BlockCount!=(Size+BlockSize-1)/BlockSize )
+		{
+			ArIsError = 1;
+			Size = 0;
+			Error->Logf( TEXT("Bad compressed package header") );
+			return;
+		}
+		Blocks.Add( BlockCount );
+		INT FileSize = Reader->TotalSize();
+		for( INT i=0; i<BlockCount; i++ )
+		{
+			FCompressedBlock& B = Blocks(i);
+			*Reader << B;
+			if( Reader->IsError() || B.Offset<0 || B.Size<=0 || B.Size>FileSize-B.Offset )
+			{
+				ArIsError = 1;
+				Size = 0;
+				Error->Logf( TEXT("Bad compressed package block %i"), i );
+				return;
+			}
+		}
+		unguard;
+	}
+	~FArchiveCompressedReader()
+	{
+		guard(FArchiveCompressedReader::~FArchiveCompressedReader);
+		delete Reader;
+		unguard;
+	}
+	void Seek( INT InPos )
+	{
+		guard(FArchiveCompressedReader::Seek);
+		check(InPos>=0);
+		check(InPos<=Size);
+		Pos = InPos;
+		unguard;
+	}
+	INT Tell()
+	{
+		return Pos;
+	}
+	INT TotalSize()
+	{
+		return Size;
+	}
+	UBOOL Close()
+	{
+		return !ArIsError;
+	}
+	void Serialize( void* V, INT Length )
+	{
+		guardSlow(FArchiveCompressedReader::Serialize);
+		if( Length>Size-Pos )
+		{
+			ArIsError = 1;
+			Error->Logf( TEXT("ReadFile beyond EOF %i+%i/%i"), Pos, Length, Size );
+			return;
+		}
+		while( Length>0 )
+		{
+			INT i = Pos/BlockSize;
+			if( CacheBlock[Current]!=i && !Find(i) )
+				return;
+			INT Offset = Pos - i*BlockSize;
+			INT Copy   = Min( Length, BlockLength(i)-Offset );
+			appMemcpy( V, &Cache[Current](Offset), Copy );
+			Pos    += Copy;
+			Length -= Copy;
+			V       = (BYTE*)V + Copy;
+		}
+		unguardSlow;
+	}
+private:
+	// Decoded blocks kept.
+	enum {CACHE_COUNT = 3};
+
+	FArchive*				Reader;
+	FOutputDevice*			Error;
+	INT						BlockSize, Size, Pos;
+	TArray<FCompressedBlock> Blocks;
+	FCodecPackage			Codec;
+	TArray<BYTE>			Packed;						// Block as stored.
+	TArray<BYTE>			Cache[CACHE_COUNT];			// Decoded blocks.
+	INT						CacheBlock[CACHE_COUNT];	// Block in each, or INDEX_NONE.
+	DWORD					CacheUse[CACHE_COUNT];		// UseCount when last found.
+	INT						Current;					// Cache entry last read from.
+	DWORD					UseCount;
+
+	INT BlockLength( INT i )
+	{
+		return Min( BlockSize, Size-i*BlockSize );
+	}
+	UBOOL Find( INT i )
+	{
+		guardSlow(FArchiveCompressedReader::Find);
+		INT Oldest = 0;
+		for( Current=0; Current<CACHE_COUNT; Current++ )
+		{
+			if( CacheBlock[Current]==i )
+				break;
+			if( CacheUse[Current]<CacheUse[Oldest] )
+				Oldest = Current;
+		}
+		if( Current==CACHE_COUNT )
+		{
+			// Decode over the least recently used block.
+			Current = Oldest;
+			if( !Decode(i) )
+				return 0;
+		}
+		CacheUse[Current] = ++UseCount;
+		return 1;
+		unguardSlow;
+	}
+	UBOOL Decode( INT i )
+	{
+		guard(FArchiveCompressedReader::Decode);
+		FCompressedBlock& B = Blocks(i);
+		TArray<BYTE>& Block = Cache[Current];
+		INT Length = BlockLength( i );
+		CacheBlock[Current] = INDEX_NONE;
+		Reader->Seek( B.Offset );
+		if( B.Size==Length )
+		{
+			// Stored as is.
+			if( Block.Num()<Length )
+				Block.Add( Length-Block.Num() );
+			Reader->Serialize( &Block(0), Length );
+		}
+		else
+		{
+			Packed.Empty( B.Size );
+			Packed.Add( B.Size );
+			Reader->Serialize( &Packed(0), B.Size );
+			if( !Reader->IsError() )
+			{
+				FBufferReader In( Packed );
+				FBufferWriter Out( Block );
+				Codec.Decode( In, Out );
+				if( Out.Tell()!=Length )
+				{
+					ArIsError = 1;
+					Error->Logf( TEXT("Compressed block %i decoded to %i bytes, expected %i"), i, Out.Tell(), Length );
+					return 0;
+				}
+			}
+		}
+		if( Reader->IsError() )
+		{
+			ArIsError = 1;
+			return 0;
+		}
+		CacheBlock[Current] = i;
+		return 1;
+		unguard;
+	}
+};
+
+/*-----------------------------------------------------------------------------
+	Reading and writing.
+-----------------------------------------------------------------------------*/
+
+//
+// Open a package for reading, compressed or not.
+//
+CORE_API FArchive* CreatePackageReader( const TCHAR* Filename, FOutputDevice* Error )
+{
+	guard(CreatePackageReader);
+	FArchive* Reader = GFileManager->CreateFileReader( Filename, 0, Error );
+	if( !Reader || Reader->TotalSize()<4 )
+		return Reader;
+	DWORD Tag;
+	*Reader << Tag;
+	if( Tag!=PACKAGE_COMPRESSED_TAG )
+	{
+		Reader->Seek( 0 );
+		return Reader;
+	}
+	Reader->Seek( 0 );
+	return new(TEXT("CompressedReader"))FArchiveCompressedReader( Reader, Error );
+	unguard;
+}
+
+//
+// Rewrite a package file in compressed form.
+//
+CORE_API UBOOL CompressPackageFile( const TCHAR* Filename, INT BlockSize, FOutputDevice* Error )
+{
+	guard(CompressPackageFile);
+	check(BlockSize>0);
+
+	// Load the raw package.
+	TArray<BYTE> Raw;
+	if( !appLoadFileToArray( Raw, Filename ) )
+	{
+		Error->Logf( NAME_Warning, TEXT("Could not read %s"), Filename );
+		return 0;
+	}
+	DWORD Tag = 0;
+	if( Raw.Num()>=4 )
+	{
+		FBufferReader Ar( Raw );
+		Ar << Tag;
+	}
+	if( Tag==PACKAGE_COMPRESSED_TAG )
+		return 1;
+	if( Tag!=PACKAGE_FILE_TAG )
+	{
+		Error->Logf( NAME_Warning, LocalizeError("BinaryFormat"), Filename );
+		return 0;
+	}
+
+	// Header and placeholder block table.
+	FBufferArchive Out;
+	INT Size = Raw.Num(), BlockCount = (Size+BlockSize-1)/BlockSize;
+	TArray<FCompressedBlock> Blocks( BlockCount );
+	Tag = PACKAGE_COMPRESSED_TAG;
+	Out << Tag << BlockSize << Size << BlockCount;
+	INT TableOffset = Out.Tell();
+	for( INT i=0; i<BlockCount; i++ )
+		Out << Blocks(i);
+
+	// Compress each block on its own, keeping it raw if that's smaller.
+	FCodecPackage Codec;
+	TArray<BYTE> Chunk, Packed;
+	for( INT i=0; i<BlockCount; i++ )
+	{
+		INT Length = Min( BlockSize, Size-i*BlockSize );
+		Chunk.Empty( Length );
+		Chunk.Add( Length );
+		appMemcpy( &Chunk(0), &Raw(i*BlockSize), Length );
+		Packed.Empty();
+		FBufferReader In( Chunk );
+		FBufferWriter Writer( Packed );
+		Codec.Encode( In, Writer );
+		Blocks(i).Offset = Out.Tell();
+		if( Packed.Num()<Length )
+		{
+			Blocks(i).Size = Packed.Num();
+			Out.Serialize( &Packed(0), Packed.Num() );
+		}
+		else
+		{
+			Blocks(i).Size = Length;
+			Out.Serialize( &Chunk(0), Length );
+		}
+	}
+	Out.Seek( TableOffset );
+	for( INT i=0; i<BlockCount; i++ )
+		Out << Blocks(i);
+
+	// Replace the file.
+	if( !appSaveArrayToFile( Out, Filename ) )
+	{
+		Error->Logf( NAME_Warning, LocalizeError("SaveWarning"), Filename );
+		return 0;
+	}
+	debugf( NAME_Log, TEXT("Compressed %s: %i -> %i bytes in %i blocks"), Filename, Size, Out.Num(), BlockCount );
+	return 1;
+	unguard;
+}
+
+/*-----------------------------------------------------------------------------
+	The End.
+-----------------------------------------------------------------------------*/
@@ -62,6 +62,207 @@ void FFrame::Serialize( const TCHAR* V, EName Event )
 	unguard;
 }
 
+#if DO_THREADED_SCRIPT
+//
+// Execute a token pre-decoded by UStruct::ThreadScript, whose handler Op
+// Step has already fetched. Each handler does what its exec function does,
+// without the call through GNatives and, for variables, without the virtual
+// property copy. Virtual calls look in their call site's cache before
+// searching the function hash.
+//
+void FFrame::StepThreaded( BYTE Op, UObject* Context, RESULT_DECL )
+{
+	guardSlow(FFrame::StepThreaded);
+	FFrame& Stack = *this;
+	UBOOL Global;
+	static void* Handlers[THR_Max] =
+	{
+		&&ThrNative,
+		&&ThrLocalInt,
+		&&ThrLocalObject,
+		&&ThrLocalByte,
+		&&ThrLocalPlain,
+		&&ThrInstanceInt,
+		&&ThrInstanceObject,
+		&&ThrInstanceByte,
+		&&ThrInstancePlain,
+		&&ThrIntConst,
+		&&ThrFloatConst,
+		&&ThrIntConstByte,
+		&&ThrByteConst,
+		&&ThrIntZero,
+		&&ThrIntOne,
+		&&ThrNoObject,
+		&&ThrSelf,
+		&&ThrNothing,
+		&&ThrJump,
+		&&ThrJumpIfNot,
+		&&ThrVirtualFunction,
+		&&ThrGlobalFunction,
+	};
+	Code++;
+	goto *Handlers[Op];
+
+ThrNative:
+	(Context->*GNatives[Code[-1]])( *this, Result );
+	return;
+
+ThrLocalInt:
+	GProperty = (UProperty*)ReadObject();
+	GPropAddr = Locals + GProperty->Offset;
+	if( Result )
+		*(INT*)Result = *(INT*)GPropAddr;
+	return;
+
+ThrLocalObject:
+	GProperty = (UProperty*)ReadObject();
+	GPropAddr = Locals + GProperty->Offset;
+	if( Result )
+		*(UObject**)Result = *(UObject**)GPropAddr;
+	return;
+
+ThrLocalByte:
+	GProperty = (UProperty*)ReadObject();
+	GPropAddr = Locals + GProperty->Offset;
+	if( Result )
+		*(BYTE*)Result = *GPropAddr;
+	return;
+
+ThrLocalPlain:
+	GProperty = (UProperty*)ReadObject();
+	GPropAddr = Locals + GProperty->Offset;
+	if( Result )
+		appMemcpy( Result, GPropAddr, GProperty->ElementSize * GProperty->ArrayDim );
+	return;
+
+ThrInstanceInt:
+	GProperty = (UProperty*)ReadObject();
+	GPropAddr = (BYTE*)Context + GProperty->Offset;
+	if( Result )
+		*(INT*)Result = *(INT*)GPropAddr;
+	return;
+
+ThrInstanceObject:
+	GProperty = (UProperty*)ReadObject();
+	GPropAddr = (BYTE*)Context + GProperty->Offset;
+	if( Result )
+		*(UObject**)Result = *(UObject**)GPropAddr;
+	return;
+
+ThrInstanceByte:
+	GProperty = (UProperty*)ReadObject();
+	GPropAddr = (BYTE*)Context + GProperty->Offset;
+	if( Result )
+		*(BYTE*)Result = *GPropAddr;
+	return;
+
+ThrInstancePlain:
+	GProperty = (UProperty*)ReadObject();
+	GPropAddr = (BYTE*)Context + GProperty->Offset;
+	if( Result )
+		appMemcpy( Result, GPropAddr, GProperty->ElementSize * GProperty->ArrayDim );
+	return;
+
+ThrIntConst:
+	*(INT*)Result = ReadInt();
+	return;
+
+ThrFloatConst:
+	*(FLOAT*)Result = ReadFloat();
+	return;
+
+ThrIntConstByte:
+	*(INT*)Result = *Code++;
+	return;
+
+ThrByteConst:
+	*(BYTE*)Result = *Code++;
+	return;
+
+ThrIntZero:
+	*(INT*)Result = 0;
+	return;
+
+ThrIntOne:
+	*(INT*)Result = 1;
+	return;
+
+ThrNoObject:
+	*(UObject**)Result = NULL;
+	return;
+
+ThrSelf:
+	*(UObject**)Result = Context;
+	return;
+
+ThrNothing:
+	return;
+
+ThrJump:
+	CHECK_RUNAWAY;
+	Code = &Node->Script( ReadWord() );
+	return;
+
+ThrJumpIfNot:
+	{
+		CHECK_RUNAWAY;
+		INT wOffset = ReadWord();
+		UBOOL Value = 0;
+		Step( Object, &Value );
+		if( !Value )
+			Code = &Node->Script( wOffset );
+	}
+	return;
+
+ThrVirtualFunction:
+	Global = 0;
+	goto ThrCall;
+
+ThrGlobalFunction:
+	Global = 1;
+
+ThrCall:
+	{
+		// Get the call site, clearing the struct's caches if they've gone stale.
+		// Emptying CallCache zeroes CallCacheEpoch, which GCallCacheEpoch
+		// never is, so an emptied cache is always rebuilt here.
+		_WORD iSite;
+		appMemcpy( &iSite, &Node->Threaded(Code - &Node->Script(0)), sizeof(iSite) );
+		FName Name = ReadName();
+		if( Node->CallCacheEpoch!=GCallCacheEpoch )
+		{
+			if( Node->CallCache.Num()!=Node->CallSites )
+			{
+				Node->CallCache.Empty( Node->CallSites );
+				Node->CallCache.Add( Node->CallSites );
+			}
+			appMemzero( &Node->CallCache(0), Node->CallSites * sizeof(FCallCache) );
+			Node->CallCacheEpoch = GCallCacheEpoch;
+		}
+		FCallCache& Cache = Node->CallCache(iSite);
+
+		// Resolve the function by the receiver's class and state.
+		FStateFrame* StateFrame = Context->GetStateFrame();
+		UState* State = !Global && StateFrame ? StateFrame->StateNode : NULL;
+		if( Cache.Class==Context->GetClass() && Cache.State==State )
+		{
+			GCallCacheHits++;
+		}
+		else
+		{
+			GCallCacheMisses++;
+			Cache.Function = Context->FindFunctionChecked( Name, Global );
+			Cache.Class    = Cache.Function ? Context->GetClass() : NULL;
+			Cache.State    = State;
+		}
+		Context->CallFunction( *this, Result, Cache.Function );
+	}
+	return;
+
+	unguardfSlow(( TEXT("(%s @ %s : %04X)"), Object->GetFullName(), Node->GetFullName(), Code - &Node->Script(0) ));
+}
+#endif
+
 /*-----------------------------------------------------------------------------
 	Global script execution functions.
 -----------------------------------------------------------------------------*/
@@ -3621,12 +3822,17 @@ void UObject::CallFunction( FFrame& Stack, RESULT_DECL, UFunction* Function )
 #if DO_GUARD_SLOW
 	DWORD Cycles=0; clock(Cycles);
 #endif
+
 	// Found it.
 	UBOOL SkipIt = 0;
 	if( Function->iNative )
 	{
 		// Call native final function.
+		if( GScriptProfiler )
+			GScriptProfiler->Enter( Function );
 		(this->*Function->Func)( Stack, Result );
+		if( GScriptProfiler )
+			GScriptProfiler->Exit( Function );
 	}
 	else if( Function->FunctionFlags & FUNC_Native )
 	{
@@ -3635,7 +3841,11 @@ void UObject::CallFunction( FFrame& Stack, RESULT_DECL, UFunction* Function )
 		if( !ProcessRemoteFunction( Function, Buffer, &Stack ) )
 		{
 			// Call regular native function.
+			if( GScriptProfiler )
+				GScriptProfiler->Enter( Function );
 			(this->*Function->Func)( Stack, Result );
+			if( GScriptProfiler )
+				GScriptProfiler->Exit( Function );
 		}
 		else
 		{
@@ -3665,9 +3875,16 @@ void UObject::CallFunction( FFrame& Stack, RESULT_DECL, UFunction* Function )
 		}
 		Stack.Code++;
 
-		// Execute the code.
+		// Execute the code. The profiler times the body only, so arguments
+		// evaluated above are charged to the caller.
 		if( !SkipIt )
+		{
+			if( GScriptProfiler )
+				GScriptProfiler->Enter( Function );
 			ProcessInternal( NewStack, Result );
+			if( GScriptProfiler )
+				GScriptProfiler->Exit( Function );
+		}
 
 		// Copy back outparms.
 		while( --Out >= Outs )
@@ -3744,7 +3961,11 @@ void UObject::ProcessEvent( UFunction* Function, void* Parms, void* UnusedResult
 	appMemzero( NewStack.Locals+Function->ParmsSize, Function->PropertiesSize-Function->ParmsSize );
 
 	// Call native function or UObject::ProcessInternal.
+	if( GScriptProfiler )
+		GScriptProfiler->Enter( Function );
 	(this->*Function->Func)( NewStack, NewStack.Locals+Function->ReturnValueOffset );
+	if( GScriptProfiler )
+		GScriptProfiler->Exit( Function );
 
 	// Copy everything back.
 	appMemcpy( Parms, NewStack.Locals, Function->ParmsSize );
@@ -3775,6 +3996,129 @@ UBOOL UObject::ProcessRemoteFunction( UFunction* Function, void* Parms, FFrame*
 	return 0;
 }
 
+/*-----------------------------------------------------------------------------
+	FScriptProfiler.
+-----------------------------------------------------------------------------*/
+
+FScriptProfiler::FScriptProfiler()
+{
+	Reset();
+}
+
+//
+// Forget everything and start timing again.
+//
+void FScriptProfiler::Reset()
+{
+	guard(FScriptProfiler::Reset);
+	EntryMap.Empty();
+	Entries.Empty();
+	Calls.Empty();
+	StartTime = StopTime = appSeconds();
+	unguard;
+}
+
+//
+// Stop timing. Calls still in progress are dropped.
+//
+void FScriptProfiler::Stop()
+{
+	guard(FScriptProfiler::Stop);
+	Calls.Empty();
+	for( INT i=0; i<Entries.Num(); i++ )
+		Entries(i).Depth = 0;
+	StopTime = appSeconds();
+	unguard;
+}
+
+INT FScriptProfiler::AddEntry( UFunction* Function )
+{
+	guard(FScriptProfiler::AddEntry);
+	INT iEntry = Entries.AddZeroed();
+	FEntry& Entry = Entries(iEntry);
+	Entry.Function = Function;
+	Entry.Name     = Function->GetPathName();
+	Entry.Native   = (Function->FunctionFlags & FUNC_Native)!=0;
+	Entry.OldIndex = iEntry;
+	EntryMap.Set( Function, iEntry );
+	return iEntry;
+	unguard;
+}
+
+//
+// Stop matching calls to a function being destroyed, so one allocated at
+// the same address later starts a fresh entry. Its stats stay for Dump.
+//
+void FScriptProfiler::Forget( UFunction* Function )
+{
+	guard(FScriptProfiler::Forget);
+	if( INT* Found=EntryMap.Find( Function ) )
+	{
+		Entries(*Found).Dead = 1;
+		EntryMap.Remove( Function );
+	}
+	unguard;
+}
+
+QSORT_RETURN CDECL FScriptProfiler::CompareExclusive( const FEntry* A, const FEntry* B )
+{
+	return A->Exclusive<B->Exclusive ? 1 : A->Exclusive>B->Exclusive ? -1 : 0;
+}
+
+//
+// Write the profile to Filename as CSV, most expensive first, and log
+// a short summary.
+//
+void FScriptProfiler::Dump( FOutputDevice& Ar, const TCHAR* Filename )
+{
+	guard(FScriptProfiler::Dump);
+	if( Entries.Num() )
+		appQsort( &Entries(0), Entries.Num(), sizeof(FEntry), (QSORT_COMPARE)CompareExclusive );
+	TArray<INT> NewIndex( Entries.Num() );
+	EntryMap.Empty();
+	for( INT i=0; i<Entries.Num(); i++ )
+	{
+		NewIndex( Entries(i).OldIndex ) = i;
+		if( !Entries(i).Dead )
+			EntryMap.Set( Entries(i).Function, i );
+	}
+	for( INT i=0; i<Entries.Num(); i++ )
+		Entries(i).OldIndex = i;
+	for( INT i=0; i<Calls.Num(); i++ )
+		Calls(i).iEntry = NewIndex( Calls(i).iEntry );
+
+	DOUBLE MsPerCycle = GSecondsPerCycle * 1000.0;
+	QWORD Total = 0;
+	FString Csv = FString(TEXT("Function,Native,Calls,InclusiveMs,ExclusiveMs,NativeCalleeMs,UsecPerCall")) + LINE_TERMINATOR;
+	for( INT i=0; i<Entries.Num(); i++ )
+	{
+		FEntry& E = Entries(i);
+		Total += E.Exclusive;
+		Csv += FString::Printf
+		(
+			TEXT("%s,%i,%u,%.3f,%.3f,%.3f,%.3f") LINE_TERMINATOR,
+			*E.Name,
+			E.Native ? 1 : 0,
+			E.Calls,
+			E.Inclusive * MsPerCycle,
+			E.Exclusive * MsPerCycle,
+			E.NativeCallees * MsPerCycle,
+			E.Calls ? E.Inclusive * MsPerCycle * 1000.0 / E.Calls : 0.0
+		);
+	}
+	if( !appSaveStringToFile( Csv, Filename ) )
+	{
+		Ar.Logf( NAME_Warning, TEXT("Could not write script profile to %s"), Filename );
+		return;
+	}
+
+	DOUBLE Seconds = (GScriptProfiler==this ? appSeconds() : StopTime) - StartTime;
+	Ar.Logf( TEXT("Script profile: %i functions, %.1f ms of script in %.1f s, written to %s"), Entries.Num(), Total * MsPerCycle, Seconds, Filename );
+	for( INT i=0; i<Min(Entries.Num(),10); i++ )
+		Ar.Logf( TEXT("   %8.3f ms %7u calls %s"), Entries(i).Exclusive * MsPerCycle, Entries(i).Calls, *Entries(i).Name );
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	The End.
 -----------------------------------------------------------------------------*/
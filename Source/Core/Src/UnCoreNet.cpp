@@ -19,7 +19,7 @@ FPackageInfo::FPackageInfo( ULinkerLoad* InLinker )
 :	Linker			( InLinker )
 ,	Parent			( InLinker ? InLinker->LinkerRoot : NULL )
 ,	Guid			( InLinker ? InLinker->Summary.Guid : FGuid(0,0,0,0) )
-,	FileSize		( InLinker ? InLinker->Loader->TotalSize() : 0 )
+,	FileSize		( InLinker ? GFileManager->FileSize( *InLinker->Filename ) : 0 )
 ,	PackageFlags	( InLinker ? InLinker->Summary.PackageFlags : 0 )
 ,	ObjectBase		( INDEX_NONE )
 ,	ObjectCount		( INDEX_NONE )
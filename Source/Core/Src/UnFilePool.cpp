@@ -1,6 +1,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <errno.h>
+#include <pthread.h>
 
 #include "Core.h"
 
@@ -28,6 +29,29 @@ static FPoolHandle GFilePool[FPOOL_SIZE];
 static INT GFilePoolSize = 0;
 static INT GFilesOpen = 0;
 
+// Package read-ahead calls in from a second thread, and any call may close
+// another caller's stream to make room, so the whole pool is locked around
+// each call, including the stdio call on the stream it hands out. It's
+// recursive because a failed check logs through here with the lock held,
+// and made on first use because stdio may be used before static init.
+static pthread_mutex_t GFilePoolMutex;
+static pthread_once_t GFilePoolOnce = PTHREAD_ONCE_INIT;
+
+static void InitPoolLock()
+{
+	pthread_mutexattr_t Attr;
+	pthread_mutexattr_init( &Attr );
+	pthread_mutexattr_settype( &Attr, PTHREAD_MUTEX_RECURSIVE );
+	pthread_mutex_init( &GFilePoolMutex, &Attr );
+	pthread_mutexattr_destroy( &Attr );
+}
+
+struct FPoolLock
+{
+	FPoolLock() { pthread_once( &GFilePoolOnce, InitPoolLock ); pthread_mutex_lock( &GFilePoolMutex ); }
+	~FPoolLock() { pthread_mutex_unlock( &GFilePoolMutex ); }
+};
+
 static FILE* TryOpen( const char* Name, const char* Mode )
 {
 	// try opening the file first in case there's another error
@@ -86,6 +110,7 @@ static inline FILE* GetStream( FPoolHandle* PHandle )
 
 extern "C" FPoolHandle* __wrap_fopen( const char* Name, const char* Mode )
 {
+	FPoolLock Lock;
 	FILE* Handle = TryOpen( Name, Mode );
 	if( !Handle )
 		return nullptr;
@@ -118,6 +143,7 @@ extern "C" FPoolHandle* __wrap_fopen( const char* Name, const char* Mode )
 
 extern "C" int __wrap_fclose( FPoolHandle* PHandle )
 {
+	FPoolLock Lock;
 	if( !PHandle )
 		return 0;
 
@@ -139,26 +165,31 @@ extern "C" int __wrap_fclose( FPoolHandle* PHandle )
 
 extern "C" size_t __wrap_fread( void* Ptr, size_t Size, size_t Num, FPoolHandle* Handle )
 {
+	FPoolLock Lock;
 	return __real_fread( Ptr, Size, Num, GetStream( Handle ) );
 }
 
 extern "C" size_t __wrap_fwrite( const void* Ptr, size_t Size, size_t Num, FPoolHandle* Handle )
 {
+	FPoolLock Lock;
 	return __real_fwrite( Ptr, Size, Num, GetStream( Handle ) );
 }
 
 extern "C" int __wrap_fseek( FPoolHandle* Handle, long Ofs, int Mode )
 {
+	FPoolLock Lock;
 	return __real_fseek( GetStream( Handle ), Ofs, Mode );
 }
 
 extern "C" long __wrap_ftell( FPoolHandle* Handle )
 {
+	FPoolLock Lock;
 	return __real_ftell( GetStream( Handle ) );
 }
 
 extern "C" int __wrap_setvbuf( FPoolHandle* PHandle, char* Buffer, int Mode, size_t Size )
 {
+	FPoolLock Lock;
 	if( (uintptr_t)PHandle < (uintptr_t)GFilePool || (uintptr_t)PHandle >= (uintptr_t)( GFilePool + FPOOL_SIZE ) )
 		return __real_setvbuf( (FILE*)PHandle, Buffer, Mode, Size );
 	return 0;
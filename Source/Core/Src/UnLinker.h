@@ -300,6 +300,461 @@ class CORE_API ULinker : public UObject
 	}
 };
 
+/*----------------------------------------------------------------------------
+	Compressed packages.
+----------------------------------------------------------------------------*/
+
+//
+// A compressed package is the raw package cut into blocks of BlockSize
+// bytes, each compressed on its own, so any offset can be read by decoding
+// just the block it falls in. Layout: PACKAGE_COMPRESSED_TAG, BlockSize,
+// raw size and block count, then the block table, then the blocks. A block
+// whose size equals its raw size is stored uncompressed.
+//
+struct FCompressedBlock
+{
+	INT Offset;		// Offset of the block's data in the file.
+	INT Size;		// Size of the block's data in the file.
+	friend FArchive& operator<<( FArchive& Ar, FCompressedBlock& B )
+	{
+		return Ar << B.Offset << B.Size;
+	}
+};
+
+// Open a package for reading, compressed or not.
+CORE_API FArchive* CreatePackageReader( const TCHAR* Filename, FOutputDevice* Error=GNull );
+
+// Rewrite a package file in compressed form.
+CORE_API UBOOL CompressPackageFile( const TCHAR* Filename, INT BlockSize=PACKAGE_COMPRESSED_BLOCK, FOutputDevice* Error=GWarn );
+
+/*----------------------------------------------------------------------------
+	FArchiveReadAhead.
+----------------------------------------------------------------------------*/
+
+#ifdef PLATFORM_POSIX
+	#define DO_READAHEAD 1
+#else
+	#define DO_READAHEAD 0
+#endif
+
+#if DO_READAHEAD
+//
+// Reads a package's export payloads in file order on a second thread into
+// a small ring of buffers, while the linker deserializes the ones that have
+// already arrived. Anything the ring can't serve, such as an export the
+// reader already went past, is read from the linker's own file reader.
+//
+// The reader thread and the ring are started once and shared. Only one
+// linker reads ahead at a time, the first to preload in a BeginLoad/EndLoad
+// batch, starting at the export it asked for.
+//
+class FArchiveReadAhead : public FArchive
+{
+public:
+	// Ring size.
+	enum {BUFFER_COUNT = 4};
+#ifdef PLATFORM_DREAMCAST
+	enum {BUFFER_SIZE  = 32768};
+#else
+	enum {BUFFER_SIZE  = 131072};
+#endif
+
+	// Start the shared reader thread if it isn't running yet. Returns
+	// whether reading ahead is possible at all.
+	static UBOOL StartThread()
+	{
+		guard(FArchiveReadAhead::StartThread);
+		if( ThreadState==0 )
+		{
+			pthread_mutex_init( &Mutex, NULL );
+			pthread_cond_init( &Cond, NULL );
+			Data        = (BYTE*)appMalloc( BUFFER_COUNT*BUFFER_SIZE, TEXT("ReadAheadBuffers") );
+			ThreadState = pthread_create( &Thread, NULL, ThreadEntry, NULL )==0 ? 1 : -1;
+		}
+		return ThreadState==1;
+		unguard;
+	}
+
+	// Whether some linker holds the ring.
+	static UBOOL IsActive()
+	{
+		return Active!=NULL;
+	}
+
+	// Constructor. Takes over the ring from the first chunk at or after
+	// StartOffset; StartThread must have succeeded and no other archive be
+	// active.
+	FArchiveReadAhead( FArchive* InReader, FArchive* InThreadReader, TArray<FObjectExport>& Exports, const TCHAR* InFilename, INT StartOffset )
+	:	Reader			( InReader )
+	,	ThreadReader	( InThreadReader )
+	,	Filename		( InFilename )
+	,	Pos				( InReader->Tell() )
+	,	Size			( InReader->TotalSize() )
+	,	CurData			( NULL )
+	,	CurStart		( 0 )
+	,	CurEnd			( 0 )
+	,	DirectStart		( 0 )
+	,	DirectEnd		( 0 )
+	,	FirstChunk		( 0 )
+	,	Count			( 0 )
+	,	Head			( 0 )
+	,	Generation		( 0 )
+	,	Stopping		( 0 )
+	,	Reading			( 0 )
+	,	Registered		( 0 )
+	,	RingBytes		( 0 )
+	,	DirectBytes		( 0 )
+	,	Restarts		( 0 )
+	,	ReadTime		( 0.0 )
+	,	WaitTime		( 0.0 )
+	{
+		guard(FArchiveReadAhead::FArchiveReadAhead);
+		check(ThreadState==1);
+		check(!Active);
+		ArIsLoading = ArIsPersistent = 1;
+
+		// Gather the payloads in file order.
+		TArray<FChunk> Payloads;
+		for( INT i=0; i<Exports.Num(); i++ )
+		{
+			FObjectExport& Export = Exports(i);
+			if( Export.SerialSize>0 && Export.SerialOffset>=0 && Export.SerialOffset<Size )
+			{
+				FChunk& Payload = Payloads(Payloads.Add());
+				Payload.Offset  = Export.SerialOffset;
+				Payload.Size    = Min( Export.SerialSize, Size-Export.SerialOffset );
+			}
+		}
+		if( Payloads.Num() )
+			Sort( &Payloads(0), Payloads.Num() );
+
+		// Pack back-to-back payloads into buffer-sized chunks.
+		for( INT i=0; i<Payloads.Num(); i++ )
+		{
+			INT Offset = Payloads(i).Offset, End = Offset + Payloads(i).Size;
+			while( Offset<End )
+			{
+				FChunk* Last = Chunks.Num() ? &Chunks(Chunks.Num()-1) : NULL;
+				if( Last && Last->Offset+Last->Size==Offset && Last->Size<BUFFER_SIZE )
+				{
+					INT Grow = Min<INT>( End-Offset, BUFFER_SIZE-Last->Size );
+					Last->Size += Grow;
+					Offset     += Grow;
+				}
+				else
+				{
+					FChunk& Chunk = Chunks(Chunks.Add());
+					Chunk.Offset  = Offset;
+					Chunk.Size    = Min<INT>( End-Offset, BUFFER_SIZE );
+					Offset       += Chunk.Size;
+				}
+			}
+		}
+
+		// Hand the ring to the reader thread, starting where the load did;
+		// anything before that is read directly.
+		FLock Lock;
+		FirstChunk = FindChunk( StartOffset );
+		Active     = this;
+		Registered = 1;
+		pthread_cond_broadcast( &Cond );
+		unguard;
+	}
+
+	// Destructor.
+	~FArchiveReadAhead()
+	{
+		guard(FArchiveReadAhead::~FArchiveReadAhead);
+		Stop();
+		if( Reader )
+			delete Reader;
+		unguard;
+	}
+
+	// Give the ring back and hand back the linker's reader, positioned
+	// where this archive was.
+	FArchive* Detach()
+	{
+		guard(FArchiveReadAhead::Detach);
+		Stop();
+		FArchive* Result = Reader;
+		Reader = NULL;
+		Result->Seek( Pos );
+		return Result;
+		unguard;
+	}
+
+	// FArchive interface.
+	void Precache( INT HintCount )
+	{
+		guardSlow(FArchiveReadAhead::Precache);
+		if( (Pos>=CurStart && Pos<CurEnd) || (!(Pos>=DirectStart && Pos<DirectEnd) && Acquire()) )
+			return;
+		if( Reader->Tell()!=Pos )
+			Reader->Seek( Pos );
+		Reader->Precache( Min( HintCount, DirectEnd-Pos ) );
+		unguardSlow;
+	}
+	void Seek( INT InPos )
+	{
+		Pos = InPos;
+	}
+	INT Tell()
+	{
+		return Pos;
+	}
+	INT TotalSize()
+	{
+		return Size;
+	}
+	void Serialize( void* V, INT Length )
+	{
+		guardSlow(FArchiveReadAhead::Serialize);
+		while( Length>0 )
+		{
+			INT Copy;
+			if( Pos>=CurStart && Pos<CurEnd )
+			{
+				// Copy out of the buffer we hold.
+				Copy = Min( Length, CurEnd-Pos );
+				appMemcpy( V, CurData+Pos-CurStart, Copy );
+				RingBytes += Copy;
+			}
+			else if( (Pos>=DirectStart && Pos<DirectEnd) || !Acquire() )
+			{
+				// Read what the ring won't ever hold ourselves.
+				Copy = Min( Length, DirectEnd-Pos );
+				if( Reader->Tell()!=Pos )
+					Reader->Seek( Pos );
+				Reader->Serialize( V, Copy );
+				ArIsError |= Reader->IsError();
+				DirectBytes += Copy;
+			}
+			else continue;
+			Pos    += Copy;
+			Length -= Copy;
+			V       = (BYTE*)V + Copy;
+		}
+		unguardSlow;
+	}
+
+private:
+	// A stretch of the file read in one go.
+	struct FChunk
+	{
+		INT Offset, Size;
+		friend INT Compare( const FChunk& A, const FChunk& B )
+		{
+			return A.Offset - B.Offset;
+		}
+	};
+
+	// Scoped lock on the shared state.
+	struct FLock
+	{
+		FLock() { pthread_mutex_lock( &Mutex ); }
+		~FLock() { pthread_mutex_unlock( &Mutex ); }
+	};
+
+	// Shared by all archives: the reader thread, the ring's buffers, and
+	// the archive they currently serve.
+	static pthread_t			Thread;
+	static pthread_mutex_t		Mutex;
+	static pthread_cond_t		Cond;
+	static BYTE*				Data;			// BUFFER_COUNT buffers of BUFFER_SIZE.
+	static INT					ThreadState;	// 0 not started, 1 running, -1 failed.
+	static FArchiveReadAhead*	Active;
+
+	// Variables.
+	FArchive*		Reader;			// Linker's reader, used on this thread only.
+	FArchive*		ThreadReader;	// Second handle to the file, used by the reader thread only.
+	FString			Filename;
+	INT				Pos, Size;
+	TArray<FChunk>	Chunks;			// Export payloads in file order.
+	BYTE*			CurData;		// Buffer we hold, covering CurStart..CurEnd.
+	INT				CurStart, CurEnd;
+	INT				DirectStart;	// Range the ring will never hold.
+	INT				DirectEnd;
+
+	// Ring state, shared with the reader thread under Mutex. The ring holds
+	// chunks FirstChunk..FirstChunk+Count-1 in buffers Head onward; the last
+	// may still be being read.
+	INT				FirstChunk, Count, Head;
+	INT				Generation;		// Bumped whenever the ring is thrown away.
+	UBOOL			Ready[BUFFER_COUNT];
+	UBOOL			Stopping;
+	UBOOL			Reading;		// Reader thread is using ThreadReader.
+	UBOOL			Registered;
+
+	// Stats.
+	INT				RingBytes, DirectBytes, Restarts;
+	DOUBLE			ReadTime, WaitTime;
+
+	// Find the chunk covering Pos, or the first one after it.
+	INT FindChunk( INT Offset )
+	{
+		INT Lo=0, Hi=Chunks.Num();
+		while( Lo<Hi )
+		{
+			INT Mid = (Lo+Hi)/2;
+			if( Chunks(Mid).Offset+Chunks(Mid).Size<=Offset )
+				Lo = Mid+1;
+			else
+				Hi = Mid;
+		}
+		return Lo;
+	}
+
+	// Make the buffer holding Pos current, waiting for it if it's still
+	// being read. If the ring won't ever hold Pos, sets up the direct range
+	// instead and returns 0.
+	UBOOL Acquire()
+	{
+		guardSlow(FArchiveReadAhead::Acquire);
+		INT iChunk = FindChunk( Pos );
+		FLock Lock;
+		if( iChunk<Chunks.Num() && Chunks(iChunk).Offset<=Pos && iChunk>=FirstChunk )
+		{
+			if( iChunk>FirstChunk+Count )
+			{
+				// Jumped past the reader, so restart it after this chunk.
+				FirstChunk = iChunk+1;
+				Count      = 0;
+				Generation++;
+				Restarts++;
+				CurStart = CurEnd = 0;
+				pthread_cond_broadcast( &Cond );
+			}
+			else
+			{
+				// Drop what was skipped over, including the buffer we held,
+				// and wait if the chunk is still being read or is next due.
+				INT Skip    = iChunk-FirstChunk;
+				Head        = (Head+Skip) % BUFFER_COUNT;
+				FirstChunk += Skip;
+				Count      -= Skip;
+				if( Skip )
+					pthread_cond_broadcast( &Cond );
+				if( Count==0 || !Ready[Head] )
+				{
+					DOUBLE StartTime = appSeconds();
+					while( (Count==0 || !Ready[Head]) && FirstChunk==iChunk )
+						pthread_cond_wait( &Cond, &Mutex );
+					WaitTime += appSeconds() - StartTime;
+				}
+				if( FirstChunk==iChunk )
+				{
+					CurData  = Data + Head*BUFFER_SIZE;
+					CurStart = Chunks(iChunk).Offset;
+					CurEnd   = CurStart + Chunks(iChunk).Size;
+					return 1;
+				}
+			}
+		}
+
+		// FirstChunk only moves forward, so a chunk before it, or a gap
+		// between chunks, stays direct.
+		DirectStart = Pos;
+		if( iChunk>=Chunks.Num() )
+			DirectEnd = Max( Size, Pos+1 );
+		else if( Chunks(iChunk).Offset<=Pos )
+			DirectEnd = Chunks(iChunk).Offset + Chunks(iChunk).Size;
+		else
+			DirectEnd = Chunks(iChunk).Offset;
+		return 0;
+		unguardSlow;
+	}
+
+	// Reader thread, filling the active archive's ring. Chunks and
+	// ThreadReader are only touched outside the lock while Reading is set,
+	// and Stop waits for it to clear.
+	static void* ThreadEntry( void* Arg )
+	{
+		pthread_mutex_lock( &Mutex );
+		for( ;; )
+		{
+			FArchiveReadAhead* Ar = Active;
+			INT iChunk = Ar ? Ar->FirstChunk + Ar->Count : 0;
+			if( !Ar || Ar->Stopping || Ar->Count==BUFFER_COUNT || iChunk>=Ar->Chunks.Num() )
+			{
+				pthread_cond_wait( &Cond, &Mutex );
+				continue;
+			}
+			INT Slot = (Ar->Head+Ar->Count) % BUFFER_COUNT;
+			INT Gen  = Ar->Generation;
+			Ar->Ready[Slot] = 0;
+			Ar->Count++;
+			Ar->Reading = 1;
+			pthread_mutex_unlock( &Mutex );
+
+			// Read the chunk outside the lock.
+			DOUBLE StartTime = appSeconds();
+			UBOOL Ok;
+			try
+			{
+				Ar->ThreadReader->Seek( Ar->Chunks(iChunk).Offset );
+				Ar->ThreadReader->Serialize( Data + Slot*BUFFER_SIZE, Ar->Chunks(iChunk).Size );
+				Ok = !Ar->ThreadReader->IsError();
+			}
+			catch( ... )
+			{
+				Ok = 0;
+			}
+			DOUBLE Time = appSeconds() - StartTime;
+
+			pthread_mutex_lock( &Mutex );
+			Ar->Reading   = 0;
+			Ar->ReadTime += Time;
+			if( !Ok )
+			{
+				// Give up; everything from here on is read directly.
+				Ar->FirstChunk = Ar->Chunks.Num();
+				Ar->Count      = 0;
+				Ar->Generation++;
+			}
+			else if( Gen==Ar->Generation )
+				Ar->Ready[Slot] = 1;
+			pthread_cond_broadcast( &Cond );
+		}
+		return NULL;
+	}
+
+	// Give the ring back to the reader thread and report how much of its
+	// reading was hidden.
+	void Stop()
+	{
+		guard(FArchiveReadAhead::Stop);
+		if( Registered )
+		{
+			{
+				FLock Lock;
+				Stopping = 1;
+				while( Reading )
+					pthread_cond_wait( &Cond, &Mutex );
+				Active = NULL;
+			}
+			Registered = 0;
+			debugf
+			(
+				NAME_DevLoad,
+				TEXT("Read-ahead %s: %iK buffered, %iK direct, %i restarts, %.1f ms reading, %.1f ms waiting"),
+				*Filename,
+				RingBytes/1024,
+				DirectBytes/1024,
+				Restarts,
+				ReadTime*1000.0,
+				WaitTime*1000.0
+			);
+		}
+		if( ThreadReader )
+			delete ThreadReader;
+		ThreadReader = NULL;
+		CurStart = CurEnd = 0;
+		unguard;
+	}
+};
+#endif
+
 /*----------------------------------------------------------------------------
 	ULinkerLoad.
 ----------------------------------------------------------------------------*/
@@ -322,15 +777,23 @@ class ULinkerLoad : public ULinker, public FArchive
 	INT						ExportHash[256];
 	TArray<FLazyLoader*>	LazyLoaders;
 	FArchive*				Loader;
+#if DO_READAHEAD
+	FArchiveReadAhead*		ReadAhead;
+#endif
+	UBOOL					ReadAheadTried;
 
 	// Constructor; all errors here throw exceptions which are fully recoverable.
 	ULinkerLoad( UObject* InParent, const TCHAR* InFilename, DWORD InLoadFlags )
 	:	ULinker( InParent, InFilename )
 	,	LoadFlags( InLoadFlags )
+#if DO_READAHEAD
+	,	ReadAhead( NULL )
+#endif
+	,	ReadAheadTried( 0 )
 	{
 		guard(ULinkerLoad::ULinkerLoad);
 		debugf( TEXT("Loading: %s"), InParent->GetFullName() );
-		Loader = GFileManager->CreateFileReader( InFilename, 0, GError );
+		Loader = CreatePackageReader( InFilename, GError );
 		if( !Loader )
 			appThrowf( LocalizeError("OpenFailed") );
 
@@ -741,10 +1204,13 @@ class ULinkerLoad : public ULinker, public FArchive
 					if( ((UStruct*)Object)->SuperField )
 						Preload( ((UStruct*)Object)->SuperField );
 
-				// Load the local object now.
+				// Load the local object now, reading payloads ahead from
+				// here on if the load is the first to need this linker.
 				guard(LoadObject);
 				FObjectExport& Export = ExportMap( Object->_LinkerIndex );
 				check(Export._Object==Object);
+				if( !ReadAheadTried && GObjBeginLoadCount )
+					StartReadAhead( Export.SerialOffset );
 				INT SavedPos = Loader->Tell();
 				Loader->Seek( Export.SerialOffset );
 				Loader->Precache( Export.SerialSize );
@@ -909,11 +1375,48 @@ private:
 		if( Loader )
 			delete Loader;
 		Loader = NULL;
+#if DO_READAHEAD
+		ReadAhead = NULL;
+#endif
 
 		Super::Destroy();
 		unguardobj;
 	}
 
+	// Read-ahead, for at most one linker at a time.
+	void StartReadAhead( INT Offset )
+	{
+		guard(ULinkerLoad::StartReadAhead);
+		ReadAheadTried = 1;
+#if DO_READAHEAD
+		if
+		(	!FArchiveReadAhead::IsActive()
+		&&	Loader->TotalSize()>=2*FArchiveReadAhead::BUFFER_SIZE
+		&&	!ParseParam(appCmdLine(),TEXT("NOREADAHEAD"))
+		&&	FArchiveReadAhead::StartThread() )
+		{
+			FArchive* ThreadReader = CreatePackageReader( *Filename, GNull );
+			if( ThreadReader )
+				Loader = ReadAhead = new(TEXT("LinkerReadAhead"))FArchiveReadAhead( Loader, ThreadReader, ExportMap, *Filename, Offset );
+		}
+#endif
+		unguard;
+	}
+	void StopReadAhead()
+	{
+		guard(ULinkerLoad::StopReadAhead);
+#if DO_READAHEAD
+		if( ReadAhead )
+		{
+			Loader = ReadAhead->Detach();
+			delete ReadAhead;
+			ReadAhead = NULL;
+		}
+#endif
+		ReadAheadTried = 0;
+		unguard;
+	}
+
 	// FArchive interface.
 	void AttachLazyLoader( FLazyLoader* LazyLoader )
 	{
@@ -8,6 +8,7 @@
 
 // Core includes.
 #include "CorePrivate.h"
+#include "FMallocTracker.h"
 
 /*-----------------------------------------------------------------------------
 	FOutputDevice implementation.
@@ -1683,8 +1684,16 @@ CORE_API void appInit( const TCHAR* InPackage, const TCHAR* InCmdLine, FMalloc*
 	GWarn        = InWarn;
 	GFileManager = InFileManager;
 
-	// Memory allocator.
+	// Memory allocator, behind the tag tracker if asked for.
 	GMalloc = InMalloc;
+	if( ParseParam( appCmdLine(), TEXT("MEMTRACK") ) )
+	{
+		static FMallocTracker MallocTracker;
+		DWORD SampleRate = 1024;
+		Parse( appCmdLine(), TEXT("MEMSAMPLE="), SampleRate );
+		MallocTracker.Enable( InMalloc, SampleRate );
+		GMalloc = GMallocTracker = &MallocTracker;
+	}
 	GMalloc->Init();
 
 	// Init names.
@@ -1692,6 +1701,8 @@ CORE_API void appInit( const TCHAR* InPackage, const TCHAR* InCmdLine, FMalloc*
 
 	// Platform specific pre-init.
 	appPlatformPreInit();
+	if( GMallocTracker )
+		GMallocTracker->StartTimer();
 
 	// Switch into executable's directory.
 	GFileManager->SetDefaultDirectory( appBaseDir() );
@@ -14,10 +14,58 @@
 
 // Static variables.
 UBOOL				FName::Initialized = 0;
-FNameEntry*			FName::NameHash[4096];
+DWORD*				FName::NameHash = NULL;
+INT					FName::NameHashSize = 0;
+INT					FName::NameHashCount = 0;
 TArray<FNameEntry*>	FName::Names;
 TArray<INT>         FName::Available;
 
+// A name hash slot holds the name index plus one in its low bits and the
+// top bits of the name's hash above that, so nearly every mismatch while
+// probing is rejected without touching the entry. Zero is an empty slot.
+enum {NAME_INDEX_BITS = 20};
+enum {NAME_INDEX_MASK = (1<<NAME_INDEX_BITS)-1};
+#define NAME_TAG_MASK (~(DWORD)NAME_INDEX_MASK)
+
+// Name entries are carved out of large blocks instead of being allocated
+// one by one. A deleted entry goes on the free list for its size. Names too
+// long for a full size entry, as from script casts, are allocated singly.
+#ifdef PLATFORM_DREAMCAST
+enum {NAME_BLOCK_SIZE = 16384};
+#else
+enum {NAME_BLOCK_SIZE = 65536};
+#endif
+enum {NAME_ENTRY_ALIGN = 4};
+static TArray<BYTE*> GNameBlocks;
+static BYTE*		 GNameBlockTop = NULL;
+static BYTE*		 GNameBlockEnd = NULL;
+static FNameEntry*	 GNameFree[sizeof(FNameEntry)/NAME_ENTRY_ALIGN+1];
+
+inline INT NameEntrySize( const TCHAR* Name )
+{
+	return Align( (INT)(sizeof(FNameEntry) - (NAME_SIZE - appStrlen(Name) - 1)*sizeof(TCHAR)), NAME_ENTRY_ALIGN );
+}
+inline UBOOL IsLargeNameEntry( INT Size )
+{
+	return Size/NAME_ENTRY_ALIGN >= (INT)ARRAY_COUNT(GNameFree);
+}
+inline FNameEntry*& NameEntryNextFree( FNameEntry* Entry )
+{
+	return *(FNameEntry**)Entry->Name;
+}
+CORE_API FNameEntry* AllocateNameEntry( const TCHAR* Name, DWORD Index, DWORD Flags );
+static void FreeNameEntry( FNameEntry* Entry )
+{
+	INT Size = NameEntrySize( Entry->Name );
+	if( IsLargeNameEntry( Size ) )
+	{
+		appFree( Entry );
+		return;
+	}
+	NameEntryNextFree( Entry ) = GNameFree[Size/NAME_ENTRY_ALIGN];
+	GNameFree[Size/NAME_ENTRY_ALIGN] = Entry;
+}
+
 /*-----------------------------------------------------------------------------
 	FName implementation.
 -----------------------------------------------------------------------------*/
@@ -29,10 +77,10 @@ void FName::Hardcode( FNameEntry* AutoName )
 {
 	guard(FName::Hardcode);
 
-	// Add name to name hash.
-	INT iHash          = appStrihash(AutoName->Name) & (ARRAY_COUNT(NameHash)-1);
-	AutoName->HashNext = NameHash[iHash];
-	NameHash[iHash]    = AutoName;
+	// Verify no duplicate names.
+	FName Existing( AutoName->Name, FNAME_Find );
+	if( Existing!=NAME_None && Existing.Index!=AutoName->Index )
+		appErrorf( TEXT("Name '%s' was duplicated"), AutoName->Name );
 
 	// Expand the table if needed.
 	for( INT i=Names.Num(); i<=AutoName->Index; i++ )
@@ -42,8 +90,16 @@ void FName::Hardcode( FNameEntry* AutoName )
 	//if( Names(AutoName->Index) )
 	//	appErrorf( TEXT("Hardcoded name %i was duplicated"), AutoName->Index );
 	//maximqad: fix DCUtil 
+	if( Names(AutoName->Index) )
+	{
+		UnhashName( AutoName->Index, appStrihash(Names(AutoName->Index)->Name) );
+		FreeNameEntry( Names(AutoName->Index) );
+	}
 	Names(AutoName->Index) = AutoName;
 
+	// Add name to name hash.
+	HashName( AutoName->Index, appStrihash(AutoName->Name) );
+
 	unguard;
 }
 
@@ -65,13 +121,15 @@ FName::FName( const TCHAR* Name, EFindName FindType )
 	}
 
 	// Try to find the name in the hash.
-	INT iHash = appStrihash(Name) & (ARRAY_COUNT(NameHash)-1);
-	for( FNameEntry* Hash=NameHash[iHash]; Hash; Hash=Hash->HashNext )
+	DWORD Hash = appStrihash(Name);
+	DWORD Tag  = Hash & NAME_TAG_MASK;
+	INT   Mask = NameHashSize-1;
+	for( INT Slot=Hash & Mask; NameHash[Slot]; Slot=(Slot+1) & Mask )
 	{
-		if( appStricmp( Name, Hash->Name )==0 )
+		if( (NameHash[Slot] & NAME_TAG_MASK)==Tag && appStricmp( Name, Names((NameHash[Slot] & NAME_INDEX_MASK) - 1)->Name )==0 )
 		{
 			// Found it in the hash.
-			Index = Hash->Index;
+			Index = (NameHash[Slot] & NAME_INDEX_MASK) - 1;
 			return;
 		}
 	}
@@ -93,22 +151,100 @@ FName::FName( const TCHAR* Name, EFindName FindType )
 	else
 	{
 		Index = Names.Add();
+		if( Index>=NAME_INDEX_MASK )
+			appErrorf( TEXT("Name table is full") );
 	}
 
 	// Allocate and set the name.
-	Names(Index) = NameHash[iHash] = AllocateNameEntry( Name, Index, 0, NameHash[iHash] );
+	Names(Index) = AllocateNameEntry( Name, Index, 0 );
 	if( FindType==FNAME_Intrinsic )
 		Names(Index)->Flags |= RF_Native;
+	HashName( Index, Hash );
 
 	unguard;
 }
 
 /*-----------------------------------------------------------------------------
-	FName subsystem.
+	FName hash.
 -----------------------------------------------------------------------------*/
 
-// Forward declaration.
-CORE_API FNameEntry* AllocateNameEntry( const TCHAR* Name, DWORD Index, DWORD Flags, FNameEntry* HashNext );
+//
+// Add the name at Index, which must already be in the table, to the hash.
+//
+void FName::HashName( INT Index, DWORD Hash )
+{
+	guard(FName::HashName);
+
+	// Keep the load below 3/4; growing rehashes every name including this one.
+	if( (NameHashCount+1)*4 > NameHashSize*3 )
+	{
+		ResizeHash( NameHashSize*2 );
+		return;
+	}
+
+	INT Mask = NameHashSize-1;
+	INT Slot;
+	for( Slot=Hash & Mask; NameHash[Slot]; Slot=(Slot+1) & Mask );
+	NameHash[Slot] = (Hash & NAME_TAG_MASK) | (Index+1);
+	NameHashCount++;
+
+	unguard;
+}
+
+//
+// Remove the name at Index from the hash.
+//
+void FName::UnhashName( INT Index, DWORD Hash )
+{
+	guard(FName::UnhashName);
+
+	INT Mask = NameHashSize-1;
+	INT Slot;
+	for( Slot=Hash & Mask; (NameHash[Slot] & NAME_INDEX_MASK)!=(DWORD)(Index+1); Slot=(Slot+1) & Mask )
+		if( !NameHash[Slot] )
+			appErrorf( TEXT("Unhashed name '%s'"), Names(Index)->Name );
+
+	// Move later names of the run back into the gap unless that would put
+	// them before their home slot, so lookups never stop short.
+	for( INT Next=(Slot+1) & Mask; NameHash[Next]; Next=(Next+1) & Mask )
+	{
+		INT Home = appStrihash( Names((NameHash[Next] & NAME_INDEX_MASK) - 1)->Name ) & Mask;
+		if( ((Next-Home) & Mask) >= ((Next-Slot) & Mask) )
+		{
+			NameHash[Slot] = NameHash[Next];
+			Slot           = Next;
+		}
+	}
+	NameHash[Slot] = 0;
+	NameHashCount--;
+
+	unguard;
+}
+
+//
+// Reallocate the name hash and rehash all names.
+//
+void FName::ResizeHash( INT NewSize )
+{
+	guard(FName::ResizeHash);
+	check((NewSize&(NewSize-1))==0);
+
+	if( NameHash )
+		appFree( NameHash );
+	NameHash      = (DWORD*)appMalloc( NewSize*sizeof(DWORD), TEXT("NameHash") );
+	NameHashSize  = NewSize;
+	NameHashCount = 0;
+	appMemzero( NameHash, NewSize*sizeof(DWORD) );
+	for( INT i=0; i<Names.Num(); i++ )
+		if( Names(i) )
+			HashName( i, appStrihash(Names(i)->Name) );
+
+	unguard;
+}
+
+/*-----------------------------------------------------------------------------
+	FName subsystem.
+-----------------------------------------------------------------------------*/
 
 //
 // Initialize the name subsystem.
@@ -117,27 +253,18 @@ void FName::StaticInit()
 {
 	guard(FName::StaticInit);
 	check(Initialized==0);
-	check((ARRAY_COUNT(NameHash)&(ARRAY_COUNT(NameHash)-1)) == 0);
 	Initialized = 1;
 
 	// Init the name hash.
-	{for( INT i=0; i<ARRAY_COUNT(FName::NameHash); i++ )
-		NameHash[i] = NULL;}
+	ResizeHash( 8192 );
 
 	// Register all hardcoded names.
 	#define REGISTER_NAME(num,namestr) \
-		Hardcode(AllocateNameEntry(TEXT(#namestr),num,RF_Native,NULL));
+		Hardcode(AllocateNameEntry(TEXT(#namestr),num,RF_Native));
 	#define REG_NAME_HIGH(num,namestr) \
-		Hardcode(AllocateNameEntry(TEXT(#namestr),num,RF_Native|RF_HighlightedName,NULL));
+		Hardcode(AllocateNameEntry(TEXT(#namestr),num,RF_Native|RF_HighlightedName));
 	#include "UnNames.h"
 
-	// Verify no duplicate names.
-	{for( INT i=0; i<ARRAY_COUNT(NameHash); i++ )
-		for( FNameEntry* Hash=NameHash[i]; Hash; Hash=Hash->HashNext )
-			for( FNameEntry* Other=Hash->HashNext; Other; Other=Other->HashNext )
-				if( appStricmp(Hash->Name,Other->Name)==0 )
-					appErrorf( TEXT("Name '%s' was duplicated"), Hash->Name );}
-
 	debugf( NAME_Init, TEXT("Name subsystem initialized") );
 	unguard;
 }
@@ -152,8 +279,16 @@ void FName::StaticExit()
 
 	// Kill all names.
 	for( INT i=0; i<Names.Num(); i++ )
-		if( Names(i) )
-			delete Names(i);
+		if( Names(i) && IsLargeNameEntry( NameEntrySize( Names(i)->Name ) ) )
+			appFree( Names(i) );
+	for( INT i=0; i<GNameBlocks.Num(); i++ )
+		appFree( GNameBlocks(i) );
+	GNameBlocks.Empty();
+	GNameBlockTop = GNameBlockEnd = NULL;
+	appMemzero( GNameFree, sizeof(GNameFree) );
+	appFree( NameHash );
+	NameHash     = NULL;
+	NameHashSize = NameHashCount = 0;
 
 	// Empty tables.
 	Names.Empty();
@@ -171,14 +306,19 @@ void FName::DisplayHash( FOutputDevice& Ar )
 {
 	guard(FName::DisplayHash);
 
-	INT UsedBins=0, NameCount=0;
-	for( INT i=0; i<ARRAY_COUNT(NameHash); i++ )
+	INT Mask=NameHashSize-1, Probes=0, MaxProbes=0;
+	for( INT i=0; i<NameHashSize; i++ )
 	{
-		if( NameHash[i] != NULL ) UsedBins++;
-		for( FNameEntry *Hash = NameHash[i]; Hash; Hash=Hash->HashNext )
-			NameCount++;
+		if( NameHash[i] )
+		{
+			INT Home = appStrihash( Names((NameHash[i] & NAME_INDEX_MASK) - 1)->Name ) & Mask;
+			INT Len  = ((i-Home) & Mask) + 1;
+			Probes   += Len;
+			MaxProbes = Max( MaxProbes, Len );
+		}
 	}
-	Ar.Logf( TEXT("Hash: %i names, %i/%i hash bins"), NameCount, UsedBins, ARRAY_COUNT(NameHash) );
+	Ar.Logf( TEXT("Hash: %i names in %i hash slots, %.2f probes average, %i worst"), NameHashCount, NameHashSize, NameHashCount ? (FLOAT)Probes/NameHashCount : 0.f, MaxProbes );
+	Ar.Logf( TEXT("Hash: %i name blocks of %i bytes"), GNameBlocks.Num(), NAME_BLOCK_SIZE );
 
 	unguard;
 }
@@ -194,15 +334,10 @@ void FName::DeleteEntry( int i )
 	FNameEntry* NameEntry = Names(i);
 	check(NameEntry);
 	check(!(NameEntry->Flags & RF_Native));
-	INT iHash = appStrihash(NameEntry->Name) & (ARRAY_COUNT(NameHash)-1);
-	FNameEntry** HashLink;
-	for( HashLink=&NameHash[iHash]; *HashLink && *HashLink!=NameEntry; HashLink=&(*HashLink)->HashNext );
-	if( !*HashLink )
-		appErrorf( TEXT("Unhashed name '%s'"), NameEntry->Name );
-	*HashLink = (*HashLink)->HashNext;
+	UnhashName( i, appStrihash(NameEntry->Name) );
 
 	// Delete it.
-	delete NameEntry;
+	FreeNameEntry( NameEntry );
 	Names(i) = NULL;
 	Available.AddItem( i );
 
@@ -230,23 +365,60 @@ CORE_API FArchive& operator<<( FArchive& Ar, FNameEntry& E )
 		}
 		E.Name[Count] = 0;
 	}
+	else if( Ar.IsLoading() )
+	{
+		// Read the FString layout straight into the entry, no need for a temporary.
+		INT SaveNum;
+		Ar << AR_INDEX(SaveNum);
+		INT Count, Num=Abs(SaveNum);
+		for( Count=0; Count<Num; Count++ )
+		{
+			TCHAR Ch;
+			if( SaveNum>=0 )
+				{ANSICHAR ACh; Ar << *(BYTE*)&ACh; Ch=FromAnsi(ACh);}
+			else
+				{UNICHAR UCh; Ar << UCh; Ch=FromUnicode(UCh);}
+			if( Count<NAME_SIZE-1 )
+				E.Name[Count] = Ch;
+		}
+		E.Name[Min(Count,NAME_SIZE-1)] = 0;
+	}
 	else
 	{
 		FString Str( E.Name );
 		Ar << Str;
-		appStrcpy( E.Name, *Str );
 	}
 	return Ar << E.Flags;
 	unguard;
 }
-CORE_API FNameEntry* AllocateNameEntry( const TCHAR* Name, DWORD Index, DWORD Flags, FNameEntry* HashNext )
+CORE_API FNameEntry* AllocateNameEntry( const TCHAR* Name, DWORD Index, DWORD Flags )
 {
 	guard(AllocateNameEntry);
 
-	FNameEntry* NameEntry = (FNameEntry*)appMalloc( sizeof(FNameEntry) - (NAME_SIZE - appStrlen(Name) - 1)*sizeof(TCHAR), TEXT("NameEntry") );
-	NameEntry->Index      = Index;
-	NameEntry->Flags      = Flags;
-	NameEntry->HashNext   = HashNext;
+	// Reuse a deleted entry of the same size, or take the next one from the block.
+	INT         Size      = NameEntrySize( Name );
+	FNameEntry* NameEntry;
+	if( IsLargeNameEntry( Size ) )
+	{
+		NameEntry = (FNameEntry*)appMalloc( Size, TEXT("NameEntry") );
+	}
+	else if( (NameEntry=GNameFree[Size/NAME_ENTRY_ALIGN])!=NULL )
+	{
+		GNameFree[Size/NAME_ENTRY_ALIGN] = NameEntryNextFree( NameEntry );
+	}
+	else
+	{
+		if( GNameBlockTop+Size > GNameBlockEnd )
+		{
+			GNameBlockTop = (BYTE*)appMalloc( NAME_BLOCK_SIZE, TEXT("NameBlock") );
+			GNameBlockEnd = GNameBlockTop + NAME_BLOCK_SIZE;
+			GNameBlocks.AddItem( GNameBlockTop );
+		}
+		NameEntry      = (FNameEntry*)GNameBlockTop;
+		GNameBlockTop += Size;
+	}
+	NameEntry->Index = Index;
+	NameEntry->Flags = Flags;
 	appStrcpy( NameEntry->Name, Name );
 	return NameEntry;
 
@@ -7,6 +7,7 @@
 =============================================================================*/
 
 #include "CorePrivate.h"
+#include "FMallocTracker.h"
 // maximqad:: remove that when zeroing on actor construct is fixed
 static UProperty* FindRoleProperty( UClass* InClass )
 {
@@ -31,10 +32,12 @@ UObject*					UObject::GAutoRegister			= NULL;
 UPackage*					UObject::GObjTransientPkg		= NULL;
 TCHAR						UObject::GObjCachedLanguage[32] = TEXT("");
 TCHAR						UObject::GLanguage[64]          = TEXT("int");
-UObject*					UObject::GObjHash[4096];
+UObject**					UObject::GObjHash				= NULL;
+INT							UObject::GObjHashBits			= 0;
 TArray<UObject*>			UObject::GObjLoaded;
 TArray<UObject*>			UObject::GObjObjects;
 TArray<INT>					UObject::GObjAvailable;
+TArray<FObjectLinks>		UObject::GObjLinks;
 TArray<UObject*>			UObject::GObjLoaders;
 TArray<UObject*>			UObject::GObjRoot;
 TArray<UObject*>			UObject::GObjRegistrants;
@@ -42,6 +45,7 @@ TArray<FPreferencesInfo>	UObject::GObjPreferences;
 TArray<FRegistryObjectInfo> UObject::GObjDrivers;
 TMultiMap<FName,FName>*		UObject::GObjPackageRemap;
 static INT GGarbageRefCount=0;
+static DWORD GHashFinds=0, GHashProbes=0, GHashLoadFinds=0, GHashLoadProbes=0;
 
 
 /*-----------------------------------------------------------------------------
@@ -223,6 +227,9 @@ void UObject::Destroy()
 	// Unhook from linker.
 	SetLinker( NULL, INDEX_NONE );
 
+	// Unlink from the class and package lists while the outers still exist.
+	UnlinkObject();
+
 	// Remember outer name index.
 	_LinkerIndex = Outer ? Outer->GetIndex() : 0;
 
@@ -1066,12 +1073,16 @@ UObject* UObject::StaticFindObject( UClass* ObjectClass, UObject* InObjectPackag
 
 	// Find in the specified package.
 	INT iHash = GetObjectHash( ObjectName, ObjectPackage ? ObjectPackage->GetIndex() : 0 );
+	GHashFinds++;
 	for( UObject* Hash=GObjHash[iHash]; Hash!=NULL; Hash=Hash->HashNext )
+	{
+		GHashProbes++;
 		if
 		(	(Hash->GetFName()==ObjectName)
 		&&	(Hash->Outer==ObjectPackage)
 		&&	(ObjectClass==NULL || (ExactClass ? Hash->GetClass()==ObjectClass : Hash->IsA(ObjectClass))) )
 			return Hash;
+	}
 
 	// Find in any package.
 	if( InObjectPackage==ANY_PACKAGE )
@@ -1118,6 +1129,19 @@ void UObject::InitProperties( BYTE* Data, INT DataCount, UClass* DefaultsClass,
 	}
 	unguardSlow;
 
+	// Copy defaults by the class's copy plan when they're a whole instance
+	// of it; this constructs strings and arrays as it goes.
+	guardSlow(DefaultsPlan);
+	if( Defaults && DefaultsClass && DefaultsClass->CopyPlan.Num() && DefaultsCount==DefaultsClass->GetPropertiesSize() )
+	{
+		checkSlow(DefaultsCount<=DataCount);
+		DefaultsClass->RunCopyPlan( Data, Defaults, Inited, 1 );
+		if( DefaultsCount < DataCount )
+			appMemzero( Data+DefaultsCount, DataCount-DefaultsCount );
+		return;
+	}
+	unguardSlow;
+
 	// Copy defaults.
 	guardSlow(DefaultsFill);
 	if( Defaults )
@@ -1303,8 +1327,7 @@ void UObject::StaticInit()
 	GNoGC           = ParseParam(appCmdLine(),TEXT("NOGC"));
 
 	// Init hash.
-	for( INT i=0; i<ARRAY_COUNT(GObjHash); i++ )
-		GObjHash[i] = NULL;
+	ResizeHash( 12 );
 
 	// Note initialized.
 	GObjInitialized = 1;
@@ -1409,12 +1432,15 @@ void UObject::StaticExit()
 	GObjLoaded			.Empty();
 	GObjObjects			.Empty();
 	GObjAvailable		.Empty();
+	GObjLinks			.Empty();
 	GObjLoaders			.Empty();
 	GObjRoot			.Empty();
 	GObjRegistrants		.Empty();
 	GObjPreferences		.Empty();
 	GObjDrivers			.Empty();
 	delete GObjPackageRemap;
+	appFree( GObjHash );
+	GObjHash = NULL;
 
 	GObjInitialized = 0;
 	debugf( NAME_Exit, TEXT("Object subsystem successfully closed.") );
@@ -1709,6 +1735,14 @@ UBOOL UObject::StaticExec( const TCHAR* Cmd, FOutputDevice& Ar )
 		GMalloc->DumpAllocs();
 		return 1;
 	}
+	else if( ParseCommand(&Str,TEXT("MEMTAGS")) )
+	{
+		if( GMallocTracker )
+			GMallocTracker->DumpTags( Ar );
+		else
+			Ar.Log( TEXT("Allocation tracking is off, run with -MEMTRACK") );
+		return 1;
+	}
 #if DO_GUARD_SLOW
 	else if( ParseCommand(&Str,TEXT("RESETPROFILE")) )
 	{
@@ -1834,18 +1868,21 @@ UBOOL UObject::StaticExec( const TCHAR* Cmd, FOutputDevice& Ar )
 		{
 			// Hash info.
 			FName::DisplayHash( Ar );
-			INT ObjCount=0, HashCount=0;
-			for( FObjectIterator It; It; ++It )
-				ObjCount++;
-			for( INT i=0; i<ARRAY_COUNT(GObjHash); i++ )
+			INT ObjCount=0, HashCount=0, MaxChain=0;
+			for( INT i=0; i<(1<<GObjHashBits); i++ )
 			{
 				INT c=0;
 				for( UObject* Hash=GObjHash[i]; Hash; Hash=Hash->HashNext )
 					c++;
 				if( c )
 					HashCount++;
-				//debugf( "%i: %i", i, c );
+				ObjCount += c;
+				MaxChain  = Max( MaxChain, c );
 			}
+			Ar.Logf( TEXT("Object hash: %i objects in %i of %i chains, longest %i"), ObjCount, HashCount, 1<<GObjHashBits, MaxChain );
+			Ar.Logf( TEXT("Object hash: %u finds, %.2f probes each"), GHashFinds, GHashFinds ? (FLOAT)GHashProbes/GHashFinds : 0.f );
+			if( ParseCommand(&Str,TEXT("RESET")) )
+				GHashFinds = GHashProbes = 0;
 			return 1;
 		}
 		else if( ParseCommand(&Str,TEXT("CLASSES")) )
@@ -1943,6 +1980,22 @@ UBOOL UObject::StaticExec( const TCHAR* Cmd, FOutputDevice& Ar )
 			}
 			return 1;
 		}
+		else if( ParseCommand(&Str,TEXT("CALLCACHE")) )
+		{
+			INT Sites=0, Cached=0;
+#if DO_THREADED_SCRIPT
+			for( TObjectIterator<UStruct> It; It; ++It )
+			{
+				Sites  += It->CallSites;
+				Cached += It->CallCache.Num();
+			}
+#endif
+			DWORD Calls = GCallCacheHits + GCallCacheMisses;
+			Ar.Logf( TEXT("Virtual call cache: %u hits, %u misses (%.1f%%), %i call sites, %i cached (%iK)"), GCallCacheHits, GCallCacheMisses, Calls ? 100.0*GCallCacheHits/Calls : 0.0, Sites, Cached, Cached*(INT)sizeof(FCallCache)/1024 );
+			if( ParseCommand(&Str,TEXT("RESET")) )
+				GCallCacheHits = GCallCacheMisses = 0;
+			return 1;
+		}
 		else if( ParseCommand(&Str,TEXT("LINKERS")) )
 		{
 			Ar.Logf( TEXT("Linkers:") );
@@ -1973,6 +2026,39 @@ UBOOL UObject::StaticExec( const TCHAR* Cmd, FOutputDevice& Ar )
 		}
 		else return 0;
 	}
+	else if( ParseCommand(&Str,TEXT("SCRIPTPROF")) )
+	{
+		static FScriptProfiler* Profile = NULL;
+		if( ParseCommand(&Str,TEXT("START")) )
+		{
+			if( !Profile )
+				Profile = new FScriptProfiler;
+			Profile->Reset();
+			GScriptProfiler = Profile;
+			Ar.Log( TEXT("Script profiling started") );
+		}
+		else if( ParseCommand(&Str,TEXT("STOP")) )
+		{
+			if( GScriptProfiler )
+			{
+				GScriptProfiler = NULL;
+				Profile->Stop();
+				Ar.Log( TEXT("Script profiling stopped") );
+			}
+		}
+		else if( ParseCommand(&Str,TEXT("DUMP")) )
+		{
+			FString Filename = ParseToken( Str, 0 );
+			if( !Filename.Len() )
+				Filename = TEXT("ScriptProfile.csv");
+			if( Profile )
+				Profile->Dump( Ar, *Filename );
+			else
+				Ar.Log( TEXT("No script profile, use SCRIPTPROF START") );
+		}
+		else Ar.Log( TEXT("SCRIPTPROF START | STOP | DUMP [filename]") );
+		return 1;
+	}
 	else if( ParseCommand(&Str,TEXT("GTIME")) )
 	{
 		debugf( TEXT("GTime = %f"), GTempDouble );
@@ -2316,6 +2402,10 @@ void UObject::BeginLoad()
 	guard(UObject::BeginLoad);
 	if( ++GObjBeginLoadCount == 1 )
 	{
+		// Start counting hash probes for this load.
+		GHashLoadFinds  = GHashFinds;
+		GHashLoadProbes = GHashProbes;
+
 		// Validate clean load state.
 		check(GObjLoaded.Num()==0);
 		check(!GAutoRegister);
@@ -2380,12 +2470,23 @@ void UObject::EndLoad()
 			}
 			GImportCount=0;
 			unguard;
+
+			// Nothing more will be preloaded, so stop reading ahead.
+			guard(StopReadAhead);
+			for( INT i=0; i<GObjLoaders.Num(); i++ )
+				GetLoader(i)->StopReadAhead();
+			unguard;
 		}
 		catch( const TCHAR* Error )
 		{
 			// Any errors here are fatal.
 			appErrorf( Error );
 		}
+
+		// Report how long the hash chains were while loading.
+		DWORD Finds = GHashFinds - GHashLoadFinds;
+		if( Finds )
+			debugf( NAME_DevLoad, TEXT("Object hash: %u finds, %.2f probes each, %i chains"), Finds, (FLOAT)(GHashProbes - GHashLoadProbes) / Finds, 1<<GObjHashBits );
 	}
 	unguard;
 }
@@ -2979,6 +3080,36 @@ void UObject::HashObject()
 	unguard;
 }
 
+//
+// Reallocate the object hash with 1<<NewBits chains and rehash all objects.
+//
+void UObject::ResizeHash( INT NewBits )
+{
+	guard(UObject::ResizeHash);
+
+	UObject** OldHash = GObjHash;
+	GObjHash     = (UObject**)appMalloc( sizeof(UObject*) << NewBits, TEXT("ObjHash") );
+	GObjHashBits = NewBits;
+	appMemzero( GObjHash, sizeof(UObject*) << NewBits );
+	if( OldHash )
+		appFree( OldHash );
+
+	// Destroyed objects stay hashed under the outer index they remembered.
+	for( INT i=0; i<GObjObjects.Num(); i++ )
+	{
+		UObject* Obj = GObjObjects(i);
+		if( Obj )
+		{
+			INT OuterIndex = (Obj->GetFlags() & RF_Destroyed) ? Obj->_LinkerIndex : Obj->Outer ? Obj->Outer->GetIndex() : 0;
+			INT iHash      = GetObjectHash( Obj->Name, OuterIndex );
+			Obj->HashNext  = GObjHash[iHash];
+			GObjHash[iHash] = Obj;
+		}
+	}
+
+	unguard;
+}
+
 //
 // Remove an object from the hash table.
 //
@@ -3016,6 +3147,10 @@ void UObject::AddObject( INT InIndex )
 {
 	guard(UObject::AddObject);
 
+	// Keep about one object per hash chain.
+	if( GObjObjects.Num() >= (1<<GObjHashBits) )
+		ResizeHash( GObjHashBits+1 );
+
 	// Find an available index.
 	if( InIndex==INDEX_NONE )
 	{
@@ -3031,6 +3166,104 @@ void UObject::AddObject( INT InIndex )
 	GObjObjects(InIndex) = this;
 	Index = InIndex;
 	HashObject();
+	LinkObject();
+
+	unguard;
+}
+
+//
+// Append an object to the list of its class and the list of its
+// outermost package.
+//
+void UObject::LinkObject()
+{
+	guard(UObject::LinkObject);
+	if( Index>=GObjLinks.Num() )
+		GObjLinks.AddZeroed( Index+1-GObjLinks.Num() );
+	FObjectLinks& Links = GObjLinks(Index);
+
+	// Class list.
+	UObject*& ClassFirst = Class->FirstObject;
+	Links.ClassNext = NULL;
+	if( ClassFirst )
+	{
+		FObjectLinks& First = GObjLinks(ClassFirst->Index);
+		Links.ClassPrev = First.ClassPrev;
+		GObjLinks(First.ClassPrev->Index).ClassNext = this;
+		First.ClassPrev = this;
+	}
+	else
+	{
+		Links.ClassPrev = this;
+		ClassFirst      = this;
+	}
+
+	// Package list, for everything but top level packages.
+	Links.PackageNext = Links.PackagePrev = NULL;
+	if( Outer )
+	{
+		UObject* Top;
+		for( Top=Outer; Top->Outer; Top=Top->Outer );
+		checkSlow(Top->IsA(UPackage::StaticClass()));
+		UObject*& PackageFirst = ((UPackage*)Top)->FirstObject;
+		if( PackageFirst )
+		{
+			FObjectLinks& First = GObjLinks(PackageFirst->Index);
+			Links.PackagePrev = First.PackagePrev;
+			GObjLinks(First.PackagePrev->Index).PackageNext = this;
+			First.PackagePrev = this;
+		}
+		else
+		{
+			Links.PackagePrev = this;
+			PackageFirst      = this;
+		}
+	}
+
+	unguard;
+}
+
+//
+// Remove an object from its class and package lists, if linked.
+//
+void UObject::UnlinkObject()
+{
+	guard(UObject::UnlinkObject);
+	if( Index==INDEX_NONE || Index>=GObjLinks.Num() )
+		return;
+	FObjectLinks& Links = GObjLinks(Index);
+
+	// Class list.
+	if( Links.ClassPrev )
+	{
+		UObject*& ClassFirst = Class->FirstObject;
+		if( ClassFirst==this )
+			ClassFirst = Links.ClassNext;
+		else
+			GObjLinks(Links.ClassPrev->Index).ClassNext = Links.ClassNext;
+		if( Links.ClassNext )
+			GObjLinks(Links.ClassNext->Index).ClassPrev = Links.ClassPrev;
+		else if( ClassFirst )
+			GObjLinks(ClassFirst->Index).ClassPrev = Links.ClassPrev;
+		Links.ClassNext = Links.ClassPrev = NULL;
+	}
+
+	// Package list.
+	if( Links.PackagePrev )
+	{
+		UObject* Top;
+		for( Top=Outer; Top->Outer; Top=Top->Outer );
+		UObject*& PackageFirst = ((UPackage*)Top)->FirstObject;
+		if( PackageFirst==this )
+			PackageFirst = Links.PackageNext;
+		else
+			GObjLinks(Links.PackagePrev->Index).PackageNext = Links.PackageNext;
+		if( Links.PackageNext )
+			GObjLinks(Links.PackageNext->Index).PackagePrev = Links.PackagePrev;
+		else if( PackageFirst )
+			GObjLinks(PackageFirst->Index).PackagePrev = Links.PackagePrev;
+		Links.PackageNext = Links.PackagePrev = NULL;
+	}
 
 	unguard;
 }
@@ -3102,12 +3335,17 @@ UObject* UObject::StaticAllocateObject
 	UClass*  Cls                        = Cast<UClass>( Obj );
 	INT      Index                      = INDEX_NONE;
 	UClass*  ClassWithin				= NULL;
+	UObject* FirstObject				= NULL;
 	DWORD    ClassFlags                 = 0;
 	void     (*ClassConstructor)(void*) = NULL;
 	if( !Obj )
 	{
-		// Create a new object.
-		Obj = Ptr ? Ptr : (UObject*)appMalloc( InClass->GetPropertiesSize(), *InName );
+		// Create a new object, tagged by its nearest native class. Object
+		// names would flood the allocator's tag table, script classes too.
+		UClass* TagClass = InClass;
+		while( !(TagClass->GetFlags() & RF_Native) && TagClass->GetSuperClass() )
+			TagClass = TagClass->GetSuperClass();
+		Obj = Ptr ? Ptr : (UObject*)appMalloc( InClass->GetPropertiesSize(), TagClass->GetName() );
 	}
 	else
 	{
@@ -3127,7 +3365,10 @@ UObject* UObject::StaticAllocateObject
 			ClassWithin		 = Cls->ClassWithin;
 			ClassFlags       = Cls->ClassFlags & CLASS_Abstract;
 			ClassConstructor = Cls->ClassConstructor;
+			FirstObject      = Cls->FirstObject;
 		}
+		else if( Obj->IsA(UPackage::StaticClass()) )
+			FirstObject = ((UPackage*)Obj)->FirstObject;
 
 		// Destroy the object.
 		Obj->~UObject();
@@ -3153,6 +3394,12 @@ UObject* UObject::StaticAllocateObject
 	// Init the properties.
 	InitProperties( (BYTE*)Obj, InClass->GetPropertiesSize(), InClass, (BYTE*)InTemplate, InClass->GetPropertiesSize() );
 
+	// Keep the object list of a replaced class or package, never a template's.
+	if( InClass->IsChildOf(UClass::StaticClass()) )
+		((UClass*)Obj)->FirstObject = FirstObject;
+	else if( InClass->IsChildOf(UPackage::StaticClass()) )
+		((UPackage*)Obj)->FirstObject = FirstObject;
+
 	// Add to global table.
 	Obj->AddObject( Index );
 	check(Obj->IsValid());
@@ -3289,6 +3536,7 @@ public:
 	{
 		guard(FArchiveTagUsed::FArchiveTagUsed);
 		GGarbageRefCount=0;
+		ArRefsOnly=1;
 
 		// Tag all objects as unreachable.
 		for( FObjectIterator It; It; ++It )
@@ -3438,8 +3686,10 @@ void UObject::CollectGarbage( DWORD KeepFlags )
 	debugf( NAME_Log, TEXT("Collecting garbage") );
 
 	// Tag and purge garbage.
+	DOUBLE StartTime = appSeconds();
 	FArchiveTagUsed TagUsedAr;
 	SerializeRootSet( TagUsedAr, KeepFlags, RF_TagGarbage );
+	debugf( NAME_Log, TEXT("Marked reachable objects in %.1f ms"), (appSeconds()-StartTime)*1000.0 );
 
 	// Purge it.
 	PurgeGarbage();
@@ -3758,6 +4008,15 @@ IMPLEMENT_CLASS(ULinkerLoad);
 IMPLEMENT_CLASS(ULinkerSave);
 IMPLEMENT_CLASS(USubsystem);
 
+#if DO_READAHEAD
+pthread_t			FArchiveReadAhead::Thread;
+pthread_mutex_t		FArchiveReadAhead::Mutex;
+pthread_cond_t		FArchiveReadAhead::Cond;
+BYTE*				FArchiveReadAhead::Data        = NULL;
+INT					FArchiveReadAhead::ThreadState = 0;
+FArchiveReadAhead*	FArchiveReadAhead::Active      = NULL;
+#endif
+
 /*-----------------------------------------------------------------------------
 	UCommandlet.
 -----------------------------------------------------------------------------*/
@@ -1421,6 +1421,8 @@ void UStructProperty::Link( FArchive& Ar, UProperty* Prev )
 UBOOL UStructProperty::Identical( const void* A, const void* B ) const
 {
 	guardSlow(UStructProperty::Identical);
+	if( B && Struct->ComparePlan.Num() )
+		return Struct->RunComparePlan( (const BYTE*)A, (const BYTE*)B );
 	for( TFieldIterator<UProperty> It(Struct); It; ++It )
 		for( INT i=0; i<It->ArrayDim; i++ )
 			if( !It->Matches(A,B,i) )
@@ -1677,9 +1679,13 @@ const TCHAR* UStructProperty::ImportText( const TCHAR* Buffer, BYTE* Data, INT P
 void UStructProperty::CopySingleValue( void* Dest, void* Src ) const
 {
 	guardSlow(UStructProperty::CopySingleValue);
+	if( Struct->CopyPlan.Num() )
+	{
+		Struct->RunCopyPlan( (BYTE*)Dest, (BYTE*)Src, 0, 0 );
+		return;
+	}
 	for( TFieldIterator<UProperty> It(Struct); It; ++It )
 		It->CopyCompleteValue( (BYTE*)Dest + It->Offset, (BYTE*)Src + It->Offset );
-	//could just do memcpy + ReinstanceCompleteValue
 	unguardobjSlow;
 }
 void UStructProperty::DestroyValue( void* Dest ) const
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Engine.h"
+
+//
+// Incremental 64-bit FNV-1a hash over everything that affects a conversion:
+// the source data, the converter options and the converter version.
+//
+class FConvertKey
+{
+public:
+	FConvertKey( const char* Kind, INT Version )
+	:	Hash( 0xCBF29CE484222325ULL )
+	{
+		Update( Kind, appStrlen( Kind ) );
+		Update( &Version, sizeof(Version) );
+	}
+	void Update( const void* Data, INT Length )
+	{
+		const BYTE* Bytes = (const BYTE*)Data;
+		for( INT i = 0; i < Length; ++i )
+			Hash = ( Hash ^ Bytes[i] ) * 0x100000001B3ULL;
+	}
+	template<class T> void Update( const TArray<T>& Array )
+	{
+		const INT Num = Array.Num();
+		Update( &Num, sizeof(Num) );
+		if( Num )
+			Update( &Array(0), Num * sizeof(T) );
+	}
+	QWORD Get() const
+	{
+		return Hash;
+	}
+
+private:
+	QWORD Hash;
+};
+
+//
+// Persistent content-addressed store of converted payloads, one file per key.
+// Load and Store only use stdio, so they are safe to call from worker threads.
+//
+class FConvertCache
+{
+public:
+	static void Init( const char* InDir );
+	static UBOOL IsEnabled() { return Dir[0] != 0; }
+	static UBOOL Load( QWORD Key, TArray<BYTE>& OutPayload );
+	static void Store( QWORD Key, const TArray<BYTE>& Payload );
+
+private:
+	static void GetPath( QWORD Key, char* OutPath, INT MaxLen );
+
+	static char Dir[1024];
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Engine.h"
+
+//
+// A unit of conversion work. The job is created on the main thread, which does
+// everything that touches UObjects up front. Encode() runs on a worker thread and
+// may only touch buffers owned by the job, or the already loaded arrays of the one
+// object it was created for. Commit() runs back on the main thread,
+// in submission order, and applies the result. Jobs that change nothing should
+// leave NewSize equal to OldSize.
+//
+class FConvertJob
+{
+public:
+	DWORD OldSize = 0;
+	DWORD NewSize = 0;
+	UBOOL bFailed = 0;
+	UBOOL bCacheHit = 0;
+
+	virtual ~FConvertJob() {}
+	virtual void Encode() = 0;
+	virtual UBOOL Commit() = 0;
+};
+
+//
+// Totals over a batch of committed jobs.
+//
+struct FConvertStats
+{
+	INT NumChanged = 0;
+	INT NumCached = 0;
+	DWORD OldSize = 0;
+	DWORD NewSize = 0;
+};
+
+//
+// Fixed pool of worker threads running FConvertJob::Encode. With zero threads,
+// jobs are encoded inline on submission, which gives the old serial behaviour.
+//
+class FJobPool
+{
+public:
+	FJobPool( INT InNumThreads );
+	~FJobPool();
+
+	void Submit( FConvertJob* Job );
+	FConvertStats Flush();
+	INT GetNumThreads() const { return NumThreads; }
+
+private:
+	// Threading state lives in JobPool.cpp, pthread.h can't follow Engine.h.
+	struct FState;
+
+	static void* ThreadEntry( void* Arg );
+	void WorkerLoop();
+	static void RunJob( FConvertJob* Job );
+
+	INT NumThreads;
+	FState* State;
+	TArray<FConvertJob*> Jobs;
+	INT NextJob;
+	INT NumPending;
+	UBOOL bExit;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine.h"
+#include "JobPool.h"
 
 struct FMeshReductionStats
 {
@@ -12,6 +13,13 @@ struct FMeshReductionStats
 	INT ReducedTriangles = 0;
 	INT ReducedFrames = 0;
 	UBOOL bChanged = false;
+	FLOAT OriginalACMR = 0.0f;
+	FLOAT ReducedACMR = 0.0f;
+	INT NumStrips = 0;
+	INT StripTriangles = 0;
+	INT StripWedges = 0;
+	UBOOL bPacked = false;
+	FLOAT PackError = 0.0f;
 };
 
 class FMeshReducer
@@ -30,8 +38,60 @@ public:
 		INT UVToleranceBytes = 0;
 		FLOAT NormalAngleToleranceDeg = 5.0f;
 		INT MaxMeshletVertices = 128;
+		INT VertexCacheSize = 16;
+		FLOAT PackTolerance = 0.0f;	// World units a packed vertex may move, 0 keeps Verts as they are.
 	};
 
+	// Bump whenever the reduction, strip or packing output changes, it keys the conversion cache.
+	static constexpr INT Version = 4;
+
 	static UBOOL Reduce( UMesh* Mesh, const FOptions& Options, FMeshReductionStats* OutStats = nullptr );
+
+	// Average cache misses per triangle drawing Tris in order through a FIFO vertex cache.
+	static FLOAT ComputeACMR( const UMesh* Mesh, INT CacheSize );
 };
 
+//
+// Builds UMesh::Strips with tri_stripper, one set of strips per texture and
+// set of flags. ULodMesh strips come from the full detail faces.
+//
+class FMeshStripifier
+{
+public:
+	// Vertex cache the stripper optimizes for.
+	static constexpr INT CacheSize = 16;
+
+	static UBOOL Build( UMesh* Mesh, FMeshReductionStats* OutStats = nullptr );
+};
+
+//
+// Replaces UMesh::Verts with PackedVerts, three bytes per vertex quantized
+// against the bounds of its frame, decoded by UMesh::GetFrame.
+//
+class FMeshPacker
+{
+public:
+	static UBOOL Pack( UMesh* Mesh, FLOAT Tolerance, FMeshReductionStats* OutStats = nullptr );
+};
+
+//
+// Runs FMeshReducer::Reduce, FMeshStripifier::Build and FMeshPacker::Pack for
+// one mesh on a worker thread.
+//
+class FMeshReduceJob : public FConvertJob
+{
+public:
+	FMeshReduceJob( UMesh* InMesh, const FMeshReducer::FOptions& InOptions );
+
+	// FConvertJob interface.
+	void Encode();
+	UBOOL Commit();
+
+	static INT MeshDataSize( const UMesh* Mesh );
+
+protected:
+	UMesh* Mesh;
+	FMeshReducer::FOptions Options;
+	FMeshReductionStats Stats;
+	UBOOL bReduced;
+};
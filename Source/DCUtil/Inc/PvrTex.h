@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Engine.h"
+
+//
+// In-process PowerVR texture encoder. Replaces the external pvrtex tool:
+// takes an RGBA8888 image and produces twiddled 16bpp or VQ-compressed
+// texture data in the layout PVRDrv uploads directly.
+//
+class FPvrTexEncoder
+{
+public:
+	static constexpr INT CodebookEntries = 256;
+	static constexpr INT CodebookBytes = CodebookEntries * 4 * sizeof(_WORD);
+	static constexpr INT MaxVQIterations = 16;
+
+	// Bump whenever the encoded output changes, it keys the conversion cache.
+	static constexpr INT Version = 1;
+
+	static UBOOL IsPvrFormat( ETextureFormat Fmt );
+	static void Encode( const FColor* Src, INT USize, INT VSize, ETextureFormat Fmt, TArray<BYTE>& OutData );
+	static INT TwiddleIndex( INT U, INT V, INT USize, INT VSize );
+
+protected:
+	static void EncodeTwiddled( const FColor* Src, INT USize, INT VSize, UBOOL bAlpha, TArray<BYTE>& OutData );
+	static void EncodeVQ( const FColor* Src, INT USize, INT VSize, UBOOL bAlpha, TArray<BYTE>& OutData );
+};
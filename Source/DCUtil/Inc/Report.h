@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Engine.h"
+
+//
+// Predicts how much memory a map needs on Dreamcast once it is loaded, from
+// everything that comes in with it, broken down by package and class.
+// Each object is charged to the pool it ends up in at runtime: texture data
+// lives in video RAM once PVRDrv has uploaded it, and sound samples live in
+// AICA RAM once AICADrv has registered them.
+//
+class FMemoryReport
+{
+public:
+	enum EPool
+	{
+		POOL_Main,
+		POOL_Video,
+		POOL_Sound,
+		POOL_MAX
+	};
+
+	enum ECategory
+	{
+		CAT_Texture,
+		CAT_Sound,
+		CAT_Music,
+		CAT_Mesh,
+		CAT_Model,
+		CAT_LightMap,
+		CAT_Script,
+		CAT_Object,
+		CAT_MAX
+	};
+
+	// Dreamcast memory sizes.
+	static const INT PoolBudget[POOL_MAX];
+	static const char* const PoolNames[POOL_MAX];
+	static const char* const CategoryNames[CAT_MAX];
+
+	// One package and class pair.
+	struct FEntry
+	{
+		FName Package;
+		UClass* Class;
+		INT Count;
+		INT Bytes[CAT_MAX][POOL_MAX];
+	};
+
+	void AddObject( UObject* Obj );
+	void WriteJson( FILE* F, const char* MapName ) const;
+	void WriteCsv( FILE* F ) const;
+	INT GetTotal( EPool Pool ) const;
+	UBOOL FitsBudget() const;
+
+protected:
+	FEntry& FindEntry( UObject* Obj );
+	void AddTexture( FEntry& Entry, UTexture* Texture );
+	void AddSound( FEntry& Entry, USound* Sound );
+	void AddModel( FEntry& Entry, UModel* Model );
+	static INT CountBytes( UObject* Obj );
+
+	TArray<FEntry> Entries;
+};
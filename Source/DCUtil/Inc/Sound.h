@@ -1,10 +1,46 @@
 #pragma once
 
 #include "Engine.h"
+#include "JobPool.h"
 
-class FSoundCompressor
+//
+// Resamples a sound to its target rate and encodes it as mono 4-bit Yamaha
+// ADPCM, the AICA_SM_ADPCM_LS format AICADrv plays directly.
+//
+class FSoundCompressor : public FConvertJob
 {
 public:
-	static UBOOL CompressUSound( USound* Sound );
-};
+	// Bump whenever the encoded output changes, it keys the conversion cache.
+	static constexpr INT Version = 2;
+
+	// Output rate for sounds that don't match a rule in Rates, overridden with SNDRATE=.
+	static INT DefaultRate;
+
+	// Per-sound target rates, matched against the path name, a trailing * matches any suffix.
+	struct FRateRule
+	{
+		const char* Pattern;
+		INT Rate;
+	};
+	static const FRateRule Rates[];
+
+	static FSoundCompressor* CompressUSound( USound* Sound );
+	static INT GetTargetRate( USound* Sound );
 
+	// FConvertJob interface.
+	void Encode();
+	UBOOL Commit();
+
+protected:
+	FSoundCompressor( USound* InSound, INT InTargetRate );
+
+	static UBOOL DecodeWav( TArray<BYTE>& Wav, TArray<FLOAT>& OutSamples, INT& OutRate );
+	static void Resample( const TArray<FLOAT>& In, INT InRate, TArray<FLOAT>& Out, INT OutRate );
+	static void EncodeAdpcm( const TArray<FLOAT>& Samples, TArray<BYTE>& OutData );
+	static void WriteAdpcmWav( const TArray<BYTE>& AdpcmData, INT Rate, TArray<BYTE>& OutWav );
+
+	USound* Sound;
+	INT TargetRate;
+	TArray<BYTE> Source;
+	TArray<BYTE> Compressed;
+};
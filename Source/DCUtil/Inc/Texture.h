@@ -1,32 +1,46 @@
 #pragma once
 
 #include "Engine.h"
+#include "JobPool.h"
 
-class FTextureConverter
+class FTextureConverter : public FConvertJob
 {
 public:
 	static constexpr INT MinTexSize = 8;
 	static constexpr INT MaxTexSize = 512;
 	static constexpr INT MaxMipLevel = 0;
 	static constexpr INT DropMips = 1;
-	static const char* Blacklist[];
 
-	static UBOOL AutoConvertTexture( UTexture* Tex );
+	static FTextureConverter* AutoConvertTexture( UTexture* Tex );
+	static UBOOL ShouldConvert( UTexture* Tex );
 	static UBOOL ShouldFlattenTexture( UTexture* Tex );
 	static void FlattenToSolidWhite( UTexture* Tex );
 
+	// FConvertJob interface.
+	void Encode();
+	UBOOL Commit();
+
 protected:
+	// Decoded source pixels for one mip, and the PVR data encoded from them.
+	struct FMipWork
+	{
+		TArray<FColor> Pixels;
+		INT USize;
+		INT VSize;
+		TArray<BYTE> Encoded;
+	};
+
 	FTextureConverter( UTexture* InTexture, const ETextureFormat InFormat );
-	void Convert();
+	void Prepare();
 
 protected:
-	void ExportMip( const FMipmap& Mip, const char* Filename );
-	void ConvertMip( FMipmap& Mip, const char* Filename );
+	void DecodeMip( const FMipmap& Mip, TArray<FColor>& OutPixels );
+	static void EncodeMip( FMipWork& Work, ETextureFormat Format );
 
 protected:
-	static constexpr const char* TempPngFile = "Temp.png";
-	static constexpr const char* TempPvrFile = "Temp.dt";
 	UTexture* Texture;
+	BYTE OldFormat;
+	TArray<FMipWork> MipWork;
 	ETextureFormat DstFormat;
 	INT DstColorBytes;
 	INT SrcColorBytes;
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Engine.h"
+
+//
+// What the shipped game actually does with each texture, found by loading
+// every map and script package once and walking the object reference graph
+// from the levels, the classes and the textures listed in the .int registry.
+// Replaces the hand-kept FTextureConverter blacklist.
+//
+class FTextureUsage
+{
+public:
+	enum EUsageFlags
+	{
+		USAGE_Used		= 0x01,	// Reached from a level, class or registry entry.
+		USAGE_Effect	= 0x02,	// Read by a realtime texture or a font, keep its format.
+	};
+
+	static void Build( const char* MapGlob, const char* ScriptGlob );
+	static void AddEffectSources( UObject* InPkg );
+	static UBOOL IsBuilt() { return bBuilt; }
+
+	static UBOOL IsEffectTarget( UTexture* Texture );
+	static UBOOL IsUnused( UTexture* Texture );
+	static INT GetLowLODDrop( UTexture* Texture );
+
+	static UBOOL bDropUnused;	// Leave unreached textures out of converted packages.
+
+protected:
+	struct FInfo
+	{
+		DWORD Flags;
+		INT Drop;	// Top mips no user ever samples, MAXINT until some use is seen.
+	};
+
+	static void LoadRoots( const char* MapGlob, const char* ScriptGlob, TArray<UObject*>& Roots );
+	static INT GetSlotDrop( UMesh* Mesh, INT Slot );
+	static INT GetSkinDrop( AActor* Actor, UTexture* Texture );
+	static void AddUse( UTexture* Texture, DWORD Flags, INT Drop );
+
+	static UBOOL bBuilt;
+	static TMap<UTexture*,FInfo> Infos;
+	static TMap<UPackage*,INT> UsedPackages;
+	static TMap<FName,INT> NamedPackages;	// Top packages of .int registry entries.
+};
@@ -75,7 +75,7 @@ public:
 		: m_Start(0), m_Order(ABC), m_Size(0) { }
 
 	strip(size_t Start, triangle_order Order, size_t Size, std::vector<size_t> Indices)
-		: m_Start(Start), m_Order(Order), m_Size(Size), m_Indices(Indices) { }
+		: m_Indices(Indices), m_Start(Start), m_Order(Order), m_Size(Size) { }
 
 	size_t Start() const						{ return m_Start; }
 	triangle_order Order() const				{ return m_Order; }
@@ -0,0 +1,126 @@
+/*=============================================================================
+	CacheBench.cpp: DCUtil memory cache replay benchmark
+
+	Replays a stream of FMemCache operations written by the game's
+	CACHERECORD command against a fresh cache, optionally of another size,
+	and reports hit rate and time spent in Get and Create.
+=============================================================================*/
+
+#include "DCUtilPrivate.h"
+
+// One recorded operation.
+struct FCacheOp
+{
+	BYTE Op;
+	QWORD Id;
+	INT A, B, C;
+};
+
+/*-----------------------------------------------------------------------------
+	BenchCache: Replay a CACHERECORD file
+-----------------------------------------------------------------------------*/
+
+UBOOL FDCUtil::BenchCache( const char* LogPath, INT CacheSize, INT MaxItems )
+{
+	guard(BenchCache);
+
+	FArchive* Ar = GFileManager->CreateFileReader( LogPath );
+	if( !Ar )
+		appErrorf( "Could not open '%s'", LogPath );
+	INT Magic = 0, RecordedSize = 0, RecordedItems = 0;
+	*Ar << Magic << RecordedSize << RecordedItems;
+	if( Magic != FMemCache::RECORD_MAGIC )
+		appErrorf( "'%s' is not a CACHERECORD file", LogPath );
+
+	// Read everything up front so file access stays out of the timing
+	TArray<FCacheOp> Ops;
+	while( !Ar->AtEnd() )
+	{
+		FCacheOp& Op = Ops( Ops.Add() );
+		*Ar << Op.Op << Op.Id << Op.A << Op.B << Op.C;
+	}
+	delete Ar;
+
+	if( CacheSize <= 0 )
+		CacheSize = RecordedSize;
+	if( MaxItems <= 0 )
+		MaxItems = RecordedItems;
+	printf( "Replaying %d cache operations from '%s'\n", Ops.Num(), LogPath );
+	printf( "- Recorded with %dK and %d items, replaying with %dK and %d items\n", RecordedSize / 1024, RecordedItems, CacheSize / 1024, MaxItems );
+
+	FMemCache Cache;
+	Cache.Init( CacheSize, MaxItems );
+
+	// Last recorded Create of each id, to create it again when a smaller
+	// cache misses where the recorded one hit
+	TMap<QWORD,INT> LastCreate;
+
+	INT NumGets = 0, NumHits = 0, NumCreates = 0, NumSkipped = 0, NumMissed = 0, NumTicks = 0;
+	DOUBLE GetTime = 0.0, CreateTime = 0.0, TickTime = 0.0;
+	for( INT i = 0; i < Ops.Num(); ++i )
+	{
+		const FCacheOp& Op = Ops(i);
+		FCacheItem* Item = nullptr;
+		DWORD Start = appCycles();
+		switch( Op.Op )
+		{
+			case FMemCache::CACHEOP_Get:
+				NumGets++;
+				if( Cache.Get( Op.Id, Item ) )
+				{
+					NumHits++;
+					Item->Unlock();
+					GetTime += ( appCycles() - Start ) * GSecondsPerCycle;
+					break;
+				}
+				GetTime += ( appCycles() - Start ) * GSecondsPerCycle;
+
+				// The recorded miss is followed by its own Create, a recorded hit isn't
+				if( i + 1 < Ops.Num() && Ops(i + 1).Op == FMemCache::CACHEOP_Create && Ops(i + 1).Id == Op.Id )
+					break;
+				if( INT* iCreate = LastCreate.Find( Op.Id ) )
+				{
+					const FCacheOp& Create = Ops(*iCreate);
+					NumMissed++;
+					Start = appCycles();
+					Cache.Create( Op.Id, Item, Create.A, Create.B, Create.C );
+					Item->Unlock();
+					CreateTime += ( appCycles() - Start ) * GSecondsPerCycle;
+				}
+				break;
+			case FMemCache::CACHEOP_Create:
+				LastCreate.Set( Op.Id, i );
+				// A bigger cache may still hold what the recorded one had to create again
+				if( Cache.Get( Op.Id, Item ) )
+				{
+					NumSkipped++;
+					Item->Unlock();
+					break;
+				}
+				NumCreates++;
+				Cache.Create( Op.Id, Item, Op.A, Op.B, Op.C );
+				Item->Unlock();
+				CreateTime += ( appCycles() - Start ) * GSecondsPerCycle;
+				break;
+			case FMemCache::CACHEOP_Tick:
+				NumTicks++;
+				Cache.Tick();
+				TickTime += ( appCycles() - Start ) * GSecondsPerCycle;
+				break;
+			case FMemCache::CACHEOP_Flush:
+				Cache.Flush( Op.Id, Op.A );
+				break;
+			default:
+				appErrorf( "Bad cache operation %d at %d", Op.Op, i );
+		}
+	}
+
+	printf( "- %d gets, %d hits (%.1f%%), %.3f usec each\n", NumGets, NumHits, NumGets ? 100.0 * NumHits / NumGets : 0.0, NumGets ? 1000000.0 * GetTime / NumGets : 0.0 );
+	printf( "- %d creates, %d already cached, %d more for recorded hits, %.3f usec each\n", NumCreates, NumSkipped, NumMissed, NumCreates + NumMissed ? 1000000.0 * CreateTime / ( NumCreates + NumMissed ) : 0.0 );
+	printf( "- %d ticks, %.3f usec each\n", NumTicks, NumTicks ? 1000000.0 * TickTime / NumTicks : 0.0 );
+	Cache.Exec( "CACHESTATS", *GWarn );
+	Cache.Exit( 1 );
+	return 1;
+
+	unguard;
+}
@@ -0,0 +1,82 @@
+#include "ConvertCache.h"
+#include <stdio.h>
+
+char FConvertCache::Dir[1024] = { 0 };
+
+// Marks a cache file, bump the version if the file layout changes.
+static const DWORD CacheFileTag = 0x43544344; // 'DCTC'
+static const DWORD CacheFileVersion = 1;
+
+//
+// Enable the cache in the given directory, or disable it with a null or empty one.
+//
+void FConvertCache::Init( const char* InDir )
+{
+	guard(FConvertCache::Init);
+
+	Dir[0] = 0;
+	if( !InDir || !InDir[0] )
+		return;
+
+	if( !GFileManager->MakeDirectory( InDir, 1 ) )
+		appErrorf( "Can't create conversion cache directory '%s'", InDir );
+	appStrncpy( Dir, InDir, ARRAY_COUNT(Dir) );
+
+	unguard;
+}
+
+void FConvertCache::GetPath( QWORD Key, char* OutPath, INT MaxLen )
+{
+	snprintf( OutPath, MaxLen, "%s/%016llX.dcc", Dir, (unsigned long long)Key );
+}
+
+UBOOL FConvertCache::Load( QWORD Key, TArray<BYTE>& OutPayload )
+{
+	if( !IsEnabled() )
+		return 0;
+
+	char Path[1100];
+	GetPath( Key, Path, sizeof(Path) );
+	FILE* F = fopen( Path, "rb" );
+	if( !F )
+		return 0;
+
+	DWORD Header[3] = { 0 };
+	UBOOL Result = 0;
+	if( fread( Header, sizeof(Header), 1, F ) == 1 && Header[0] == CacheFileTag && Header[1] == CacheFileVersion )
+	{
+		OutPayload.Empty( Header[2] );
+		OutPayload.Add( Header[2] );
+		Result = Header[2] == 0 || fread( &OutPayload(0), Header[2], 1, F ) == 1;
+	}
+	fclose( F );
+
+	if( !Result )
+		OutPayload.Empty();
+	return Result;
+}
+
+void FConvertCache::Store( QWORD Key, const TArray<BYTE>& Payload )
+{
+	if( !IsEnabled() )
+		return;
+
+	// Write under a name unique to this call, then rename, so concurrent
+	// stores of the same key and interrupted runs never leave a torn entry
+	char Path[1100], TempPath[1200];
+	GetPath( Key, Path, sizeof(Path) );
+	snprintf( TempPath, sizeof(TempPath), "%s.%p.tmp", Path, (const void*)&Payload );
+
+	FILE* F = fopen( TempPath, "wb" );
+	if( !F )
+		return;
+
+	const DWORD Header[3] = { CacheFileTag, CacheFileVersion, (DWORD)Payload.Num() };
+	UBOOL Ok = fwrite( Header, sizeof(Header), 1, F ) == 1;
+	if( Ok && Payload.Num() )
+		Ok = fwrite( &Payload(0), Payload.Num(), 1, F ) == 1;
+	Ok = ( fclose( F ) == 0 ) && Ok;
+
+	if( !Ok || rename( TempPath, Path ) != 0 )
+		remove( TempPath );
+}
@@ -2,8 +2,12 @@
 
 #include "Engine.h"
 #include "Texture.h"
+#include "TextureUsage.h"
 #include "Mesh.h"
 #include "Sound.h"
+#include "JobPool.h"
+#include "ConvertCache.h"
+#include "Report.h"
 
 template<class T>
 class FSimpleArray
@@ -60,7 +64,7 @@ class FDCUtil
 public:
 
 	void InitEngine();
-	void Main();
+	INT Main();
 	void HandleError( const char* Exception );
 	void ExitEngine();
 
@@ -72,11 +76,16 @@ private:
 	UBOOL ConvertMusicPkg( const FString& PkgPath, UPackage* Pkg );
 	UBOOL ConvertMeshPkg( const FString& PkgPath, UPackage* Pkg );
 	UBOOL ConvertMapPkg( const FString& PkgPath, UPackage* Pkg );
+	UBOOL ReportMapPkg( const FString& PkgPath, UPackage* Pkg, UBOOL bCsv, const char* OutPath );
+	UBOOL BenchCache( const char* LogPath, INT CacheSize, INT MaxItems );
+	void CompressPackages( const char* Path );
+	UBOOL CompressPackage( const FString& PkgPath );
 	void CommitChanges();
 	void CommitChanges( const FSimpleArray<FString>& ChangedNames, const FSimpleArray<UPackage*>& ChangedPtrs );
 
 private:
 	UEngine* Engine = nullptr;
+	FJobPool* Jobs = nullptr;
 	FSimpleArray<FString> LoadedPackageNames;
 	FSimpleArray<UPackage*> LoadedPackagePtrs;
 	FSimpleArray<FString> ChangedPackageNames;
@@ -86,4 +95,5 @@ private:
 	FSimpleArray<UPalette*> UnrefPalettes;
 	DWORD TotalPrevSize = 0;
 	DWORD TotalNewSize = 0;
+	INT CompressBlock = 0;
 };
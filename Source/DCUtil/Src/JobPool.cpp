@@ -0,0 +1,148 @@
+#include <pthread.h>
+
+#include "JobPool.h"
+
+struct FJobPool::FState
+{
+	pthread_t* Threads;
+	pthread_mutex_t Mutex;
+	pthread_cond_t WorkReady;
+	pthread_cond_t WorkDone;
+};
+
+FJobPool::FJobPool( INT InNumThreads )
+:	NumThreads( Max( InNumThreads, 0 ) )
+,	State( new FState )
+,	NextJob( 0 )
+,	NumPending( 0 )
+,	bExit( 0 )
+{
+	State->Threads = nullptr;
+	pthread_mutex_init( &State->Mutex, nullptr );
+	pthread_cond_init( &State->WorkReady, nullptr );
+	pthread_cond_init( &State->WorkDone, nullptr );
+
+	if( NumThreads > 0 )
+	{
+		State->Threads = new pthread_t[NumThreads];
+		for( INT i = 0; i < NumThreads; ++i )
+			if( pthread_create( &State->Threads[i], nullptr, &ThreadEntry, this ) != 0 )
+				appErrorf( "Failed to create worker thread %d", i );
+	}
+}
+
+FJobPool::~FJobPool()
+{
+	Flush();
+
+	pthread_mutex_lock( &State->Mutex );
+	bExit = 1;
+	pthread_cond_broadcast( &State->WorkReady );
+	pthread_mutex_unlock( &State->Mutex );
+
+	for( INT i = 0; i < NumThreads; ++i )
+		pthread_join( State->Threads[i], nullptr );
+	delete[] State->Threads;
+
+	pthread_cond_destroy( &State->WorkDone );
+	pthread_cond_destroy( &State->WorkReady );
+	pthread_mutex_destroy( &State->Mutex );
+	delete State;
+}
+
+void* FJobPool::ThreadEntry( void* Arg )
+{
+	((FJobPool*)Arg)->WorkerLoop();
+	return nullptr;
+}
+
+void FJobPool::RunJob( FConvertJob* Job )
+{
+	// Errors can't be raised from a worker, so just flag them for Flush.
+	try
+	{
+		Job->Encode();
+	}
+	catch( ... )
+	{
+		Job->bFailed = 1;
+	}
+}
+
+void FJobPool::WorkerLoop()
+{
+	pthread_mutex_lock( &State->Mutex );
+	for( ;; )
+	{
+		while( !bExit && NextJob >= Jobs.Num() )
+			pthread_cond_wait( &State->WorkReady, &State->Mutex );
+		if( bExit )
+			break;
+
+		FConvertJob* Job = Jobs(NextJob++);
+		pthread_mutex_unlock( &State->Mutex );
+
+		RunJob( Job );
+
+		pthread_mutex_lock( &State->Mutex );
+		if( --NumPending == 0 )
+			pthread_cond_signal( &State->WorkDone );
+	}
+	pthread_mutex_unlock( &State->Mutex );
+}
+
+void FJobPool::Submit( FConvertJob* Job )
+{
+	guard(FJobPool::Submit);
+
+	verify( Job );
+	if( NumThreads == 0 )
+	{
+		RunJob( Job );
+		Jobs.AddItem( Job );
+		return;
+	}
+
+	pthread_mutex_lock( &State->Mutex );
+	Jobs.AddItem( Job );
+	NumPending++;
+	pthread_cond_signal( &State->WorkReady );
+	pthread_mutex_unlock( &State->Mutex );
+
+	unguard;
+}
+
+//
+// Wait for every submitted job, then commit them in the order they were submitted
+// so the output doesn't depend on thread scheduling.
+//
+FConvertStats FJobPool::Flush()
+{
+	guard(FJobPool::Flush);
+
+	pthread_mutex_lock( &State->Mutex );
+	while( NumPending > 0 )
+		pthread_cond_wait( &State->WorkDone, &State->Mutex );
+	TArray<FConvertJob*> Done = Jobs;
+	Jobs.Empty();
+	NextJob = 0;
+	pthread_mutex_unlock( &State->Mutex );
+
+	FConvertStats Stats;
+	for( INT i = 0; i < Done.Num(); ++i )
+	{
+		FConvertJob* Job = Done(i);
+		if( Job->bFailed )
+			appErrorf( "Conversion job %d failed", i );
+		if( Job->Commit() )
+			Stats.NumChanged++;
+		if( Job->bCacheHit )
+			Stats.NumCached++;
+		Stats.OldSize += Job->OldSize;
+		Stats.NewSize += Job->NewSize;
+		delete Job;
+	}
+	return Stats;
+
+	unguard;
+}
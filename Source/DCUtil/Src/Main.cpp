@@ -183,77 +183,77 @@ UBOOL FDCUtil::ConvertTexturePkg( const FString& PkgPath, UPackage* Pkg )
 	// Process textures directly without intermediate collection to avoid lazy loader issues
 	UBOOL Changed = false;
 
+	// Effect sources in packages the usage analysis didn't load
+	FTextureUsage::AddEffectSources( Pkg );
+
 	// First pass: collect palettes
-	for( TObjectIterator<UTexture> It; It; ++It )
+	for( TPackageObjectIterator<UTexture> It( Pkg ); It; ++It )
 	{
-		if( It->IsIn( Pkg ) )
+		if( It->Palette && It->Palette->IsIn( Pkg ) )
 		{
-			if( It->Palette && It->Palette->IsIn( Pkg ) )
+			if( !( It->bRealtime || It->bParametric ) )
 			{
-				if( !( It->bRealtime || It->bParametric ) )
+				// Check if already in the array
+				UBOOL AlreadyIn = false;
+				for( INT k = 0; k < UnrefPalettes.Num(); k++ )
 				{
-					// Check if already in the array
-					UBOOL AlreadyIn = false;
-					for( INT k = 0; k < UnrefPalettes.Num(); k++ )
+					if( UnrefPalettes(k) == It->Palette )
 					{
-						if( UnrefPalettes(k) == It->Palette )
-						{
-							AlreadyIn = true;
-							break;
-						}
+						AlreadyIn = true;
+						break;
 					}
-					if( !AlreadyIn )
-						UnrefPalettes.Add( It->Palette );
 				}
+				if( !AlreadyIn )
+					UnrefPalettes.Add( It->Palette );
 			}
 		}
 	}
 
 	// Second pass: convert textures
-	for( TObjectIterator<UTexture> It; It; ++It )
+	for( TPackageObjectIterator<UTexture> It( Pkg ); It; ++It )
 	{
-		if( It->IsIn( Pkg ) )
+		UTexture* Tex = *It;
+		if( FTextureUsage::IsUnused( Tex ) )
 		{
-			UTexture* Tex = *It;
-			const BYTE OldFmt = Tex->Format;
+			// Nothing the game loads reaches it, leave it out of the saved package
 			INT OldSize = 0;
 			for( INT j=0; j<Tex->Mips.Num(); j++ ) OldSize += Tex->Mips(j).DataArray.Num();
-			UBOOL Modified = 0;
-
-			const UBOOL bFlatten = FTextureConverter::ShouldFlattenTexture( Tex );
-			if( bFlatten )
-			{
-				FTextureConverter::FlattenToSolidWhite( Tex );
-				DWORD NewSize = 0;
-				for( INT j=0; j<Tex->Mips.Num(); j++ ) NewSize += Tex->Mips(j).DataArray.Num();
-				printf( "- Flattened '%s' to solid white (%d -> %d bytes)\n", Tex->GetName(), OldSize, NewSize );
-				Modified = 1;
-			}
-			else if( FTextureConverter::AutoConvertTexture( Tex ) )
-			{
-				DWORD NewSize = 0;
-				for( INT j=0; j<Tex->Mips.Num(); j++ ) NewSize += Tex->Mips(j).DataArray.Num();
-				if( OldFmt != Tex->Format )
-					printf( "- Converted '%s' from %d to %d (%d -> %d bytes)\n", Tex->GetName(), OldFmt, Tex->Format, OldSize, NewSize );
-				else
-					printf( "- Converted '%s' (%d -> %d bytes)\n", Tex->GetName(), OldSize, NewSize );
-				Modified = 1;
-			}
-
-			if( Modified )
-			{
-				DWORD NewSize = 0;
-				for( INT j=0; j<Tex->Mips.Num(); j++ ) NewSize += Tex->Mips(j).DataArray.Num();
-				Changed = true;
-				TotalPrevSize += OldSize;
-				TotalNewSize += NewSize;
-			}
-
-			if( Tex->Palette )
-				UnrefPalettes.RemoveItem( Tex->Palette );
+			Tex->ClearFlags( RF_Standalone );
+			printf( "- Dropped unused '%s' (%d bytes)\n", Tex->GetName(), OldSize );
+			Changed = true;
+			TotalPrevSize += OldSize;
+		}
+		else if( FTextureConverter::ShouldFlattenTexture( Tex ) )
+		{
+			INT OldSize = 0;
+			for( INT j=0; j<Tex->Mips.Num(); j++ ) OldSize += Tex->Mips(j).DataArray.Num();
+			FTextureConverter::FlattenToSolidWhite( Tex );
+			DWORD NewSize = 0;
+			for( INT j=0; j<Tex->Mips.Num(); j++ ) NewSize += Tex->Mips(j).DataArray.Num();
+			printf( "- Flattened '%s' to solid white (%d -> %d bytes)\n", Tex->GetName(), OldSize, NewSize );
+			Changed = true;
+			TotalPrevSize += OldSize;
+			TotalNewSize += NewSize;
+		}
+		else if( FTextureConverter* Job = FTextureConverter::AutoConvertTexture( Tex ) )
+		{
+			Jobs->Submit( Job );
 		}
 	}
 
+	const FConvertStats Stats = Jobs->Flush();
+	if( Stats.NumCached )
+		printf( "- %d conversions taken from the cache\n", Stats.NumCached );
+	if( Stats.NumChanged )
+		Changed = true;
+	TotalPrevSize += Stats.OldSize;
+	TotalNewSize += Stats.NewSize;
+
+	// Palettes still referenced after conversion must stay
+	for( TPackageObjectIterator<UTexture> It( Pkg ); It; ++It )
+		if( It->Palette )
+			UnrefPalettes.RemoveItem( It->Palette );
+
 	return Changed;
 	unguard;
 
@@ -265,24 +265,22 @@ UBOOL FDCUtil::ConvertSoundPkg( const FString& PkgPath, UPackage* Pkg )
 
 	printf( "Compressing sounds in '%s'\n", Pkg->GetName() );
 
-	UBOOL Changed = false;
-	for( TObjectIterator<USound> It; It; ++It )
+	for( TPackageObjectIterator<USound> It( Pkg ); It; ++It )
 	{
-		if( It->IsIn( Pkg ) && It->Data.Num() )
+		if( It->Data.Num() )
 		{
-            const DWORD OldSize = It->Data.Num();
-			if( FSoundCompressor::CompressUSound( *It ) )
-			{
-				DWORD NewSize = It->Data.Num();
-				Changed = true;
-				printf( "- Compressed '%s' (%u -> %u bytes)\n", It->GetName(), OldSize, NewSize );
-				TotalPrevSize += OldSize;
-				TotalNewSize += NewSize;
-			}
+			if( FSoundCompressor* Job = FSoundCompressor::CompressUSound( *It ) )
+				Jobs->Submit( Job );
 		}
 	}
 
-	return Changed;
+	const FConvertStats Stats = Jobs->Flush();
+	if( Stats.NumCached )
+		printf( "- %d conversions taken from the cache\n", Stats.NumCached );
+	TotalPrevSize += Stats.OldSize;
+	TotalNewSize += Stats.NewSize;
+
+	return Stats.NumChanged > 0;
 	unguard;
 }
 
@@ -293,10 +291,10 @@ UBOOL FDCUtil::ConvertMusicPkg(const FString &PkgPath, UPackage *Pkg)
 	printf( "Nuking music in '%s'\n", Pkg->GetName() );
 
 	UBOOL Changed = false;
-	for( TObjectIterator<UMusic> It; It; ++It )
+	for( TPackageObjectIterator<UMusic> It( Pkg ); It; ++It )
 	{
 		// just nuke for now
-		if( It->IsIn( Pkg ) && It->Data.Num() )
+		if( It->Data.Num() )
 		{
 			const DWORD Size = It->Data.Num();
 			printf( "- Nuking '%s' (%u bytes)\n", It->GetName(), Size );
@@ -319,11 +317,8 @@ UBOOL FDCUtil::ConvertMeshPkg( const FString& PkgPath, UPackage* Pkg )
 
 	// Get all meshes in this package first to avoid lazy loader issues with TObjectIterator
 	TArray<UMesh*> PackageMeshes;
-	for( TObjectIterator<UMesh> It; It; ++It )
-	{
-		if( It->IsIn( Pkg ) )
-			PackageMeshes.AddItem( *It );
-	}
+	for( TPackageObjectIterator<UMesh> It( Pkg ); It; ++It )
+		PackageMeshes.AddItem( *It );
 
 	UBOOL Changed = false;
 	for( INT i = 0; i < PackageMeshes.Num(); i++ )
@@ -335,13 +330,9 @@ UBOOL FDCUtil::ConvertMeshPkg( const FString& PkgPath, UPackage* Pkg )
 		Mesh->Tris.Num();   // Load triangles
 		Mesh->Connects.Num(); // Load connectivity
 
-		// Check if this is one of biggest meshes to nuke
+		// Check if this is one of biggest meshes to nuke, player models are packed instead
 		FString MeshName = Mesh->GetName();
-		UBOOL ShouldNuke = (MeshName == TEXT("FCommando") ||
-						   MeshName == TEXT("SGirl") ||
-						   MeshName == TEXT("Commando") ||
-						   MeshName == TEXT("Boss") ||
-						   MeshName == TEXT("TrophyMale1") ||
+		UBOOL ShouldNuke = (MeshName == TEXT("TrophyMale1") ||
 						   MeshName == TEXT("TrophyBoss") ||
 						   MeshName == TEXT("TrophyFemale1") ||
 						   MeshName == TEXT("WHHand") ||
@@ -377,11 +368,6 @@ UBOOL FDCUtil::ConvertMeshPkg( const FString& PkgPath, UPackage* Pkg )
 		}
 		else
 		{
-			// Calculate mesh size before reduction
-			INT OldSize = 0;
-			for( INT j=0; j<Mesh->Tris.Num(); j++ ) OldSize += sizeof(FMeshTri);
-			for( INT j=0; j<Mesh->FrameVerts * Mesh->AnimFrames; j++ ) OldSize += sizeof(FMeshVert);
-
 			// Apply mesh reduction for Dreamcast optimization (frames only)
 			FMeshReducer::FOptions ReduceOptions;
 			ReduceOptions.PositionTolerance = 0.01f;     // Conservative vertex reduction
@@ -395,40 +381,20 @@ UBOOL FDCUtil::ConvertMeshPkg( const FString& PkgPath, UPackage* Pkg )
 			ReduceOptions.UVToleranceBytes = 15.0f;      // Allow frame error
 			ReduceOptions.NormalAngleToleranceDeg = 15.0f; // Allow frame error
 			ReduceOptions.MaxMeshletVertices = 15.0f;    // Allow frame error
+			ReduceOptions.PackTolerance = 0.5f;          // Packed frames may move a vertex half a unit
 
-
-			FMeshReductionStats Stats;
-			const UBOOL MeshReduced = FMeshReducer::Reduce( Mesh, ReduceOptions, &Stats );
-
-			// Calculate new size after reduction
-			INT NewSize = 0;
-			for( INT j=0; j<Mesh->Tris.Num(); j++ ) NewSize += sizeof(FMeshTri);
-			for( INT j=0; j<Mesh->FrameVerts * Mesh->AnimFrames; j++ ) NewSize += sizeof(FMeshVert);
-
-			if( MeshReduced )
-			{
-				printf( "- %s: REDUCED %d -> %d verts, %d -> %d tris, %d -> %d frames (%d -> %d bytes)\n",
-					Mesh->GetName(),
-					Stats.OriginalVerts, Stats.ReducedVerts,
-					Stats.OriginalTriangles, Stats.ReducedTriangles,
-					Stats.OriginalFrames, Stats.ReducedFrames,
-					OldSize, NewSize );
-
-				TotalPrevSize += OldSize;
-				TotalNewSize += NewSize;
-				Changed = true;
-			}
-			else
-			{
-				printf( "- %s: %d verts, %d tris, %d frames (%d bytes) - no reduction needed\n",
-					Mesh->GetName(), Mesh->FrameVerts, Mesh->Tris.Num(), Mesh->AnimFrames, OldSize );
-
-				TotalPrevSize += OldSize;
-				TotalNewSize += OldSize;
-			}
+			Jobs->Submit( new FMeshReduceJob( Mesh, ReduceOptions ) );
 		}
 	}
 
+	const FConvertStats Stats = Jobs->Flush();
+	if( Stats.NumCached )
+		printf( "- %d conversions taken from the cache\n", Stats.NumCached );
+	if( Stats.NumChanged )
+		Changed = true;
+	TotalPrevSize += Stats.OldSize;
+	TotalNewSize += Stats.NewSize;
+
 	return Changed;
 	unguard;
 
@@ -459,20 +425,17 @@ void FDCUtil::CommitChanges( const FSimpleArray<FString>& ChangedNames, const FS
 	{
 		UPackage* Pkg = ChangedPtrs(i);
 		// Force load all lazy data in this package
-		for( TObjectIterator<UObject> It; It; ++It )
+		for( TPackageObjectIterator<UObject> It( Pkg ); It; ++It )
 		{
-			if( It->IsIn( Pkg ) )
+			// Touch the object to ensure it's fully loaded from any lazy arrays
+			It->GetClass();
+			It->GetName();
+			// For textures, ensure mip data is loaded
+			if( UTexture* Tex = Cast<UTexture>(*It) )
 			{
-				// Touch the object to ensure it's fully loaded from any lazy arrays
-				It->GetClass();
-				It->GetName();
-				// For textures, ensure mip data is loaded
-				if( UTexture* Tex = Cast<UTexture>(*It) )
+				for( INT j = 0; j < Tex->Mips.Num(); j++ )
 				{
-					for( INT j = 0; j < Tex->Mips.Num(); j++ )
-					{
-						Tex->Mips(j).DataArray.Num(); // Force load mip data
-					}
+					Tex->Mips(j).DataArray.Num(); // Force load mip data
 				}
 			}
 		}
@@ -571,6 +534,10 @@ void FDCUtil::CommitChanges( const FSimpleArray<FString>& ChangedNames, const FS
 				continue;
 			}
 
+			// Store it as compressed blocks if -compress was given
+			if( CompressBlock && !CompressPackageFile( *PkgName, CompressBlock ) )
+				printf( "  WARNING: Failed to compress %s\n", *PkgName );
+
 			// Get new file size after saving
 			// Use absolute path to avoid path resolution issues
 			char AbsPath[512];
@@ -621,6 +588,41 @@ void FDCUtil::CommitChanges()
 	CommitChanges( ChangedPackageNames, ChangedPackagePtrs );
 }
 
+UBOOL FDCUtil::CompressPackage( const FString& PkgPath )
+{
+	guard(CompressPackage);
+	INT OldSize = GFileManager->FileSize( *PkgPath );
+	if( !CompressPackageFile( *PkgPath, CompressBlock ) )
+	{
+		printf( "  ERROR: Failed to compress %s\n", *PkgPath );
+		return 0;
+	}
+	INT NewSize = GFileManager->FileSize( *PkgPath );
+	printf( "  %s: %d -> %d bytes\n", *PkgPath, OldSize, NewSize );
+	TotalPrevSize += OldSize;
+	TotalNewSize += NewSize;
+	return 1;
+	unguard;
+}
+
+void FDCUtil::CompressPackages( const char* Path )
+{
+	guard(CompressPackages);
+	if( const char* Glob = appStrchr( Path, '*' ) )
+	{
+		FString BasePath = FString( Path ).Left( Glob - Path );
+		TArray<FString> Files = appFindFiles( Path );
+		for( TArray<FString>::TIterator It( Files ); It; ++It )
+			CompressPackage( BasePath + **It );
+	}
+	else
+	{
+		CompressPackage( FString( Path ) );
+	}
+	printf( "Total size change: %u -> %u\n", TotalPrevSize, TotalNewSize );
+	unguard;
+}
+
 //
 // Handle an error.
 //
@@ -672,18 +674,46 @@ int CleanUpOnExit(int ErrorLevel)
 //
 // Actual main function.
 //
-void FDCUtil::Main( )
+INT FDCUtil::Main( )
 {
 	guard(Main);
 
+	INT ErrorLevel = 0;
 	GIsRunning = 1;
 
 	char Temp[2048] = { 0 };
 	const char* Cmd = appCmdLine();
 	FString PkgPath;
 	UPackage* Pkg = nullptr;
+
+	// Encode work runs on a pool of -jobs=N worker threads; without it everything stays on this thread
+	INT NumJobs = 0;
+	Parse( Cmd, "JOBS=", NumJobs );
+	Jobs = new FJobPool( NumJobs > 1 ? NumJobs : 0 );
+	if( Jobs->GetNumThreads() )
+		printf( "Using %d worker threads\n", Jobs->GetNumThreads() );
+
+	// Converted payloads are cached by content hash under CACHE=<dir>, -NOCACHE turns it off
+	char CacheDir[1024] = "DCUtilCache";
+	Parse( Cmd, "CACHE=", CacheDir, sizeof( CacheDir ) - 1 );
+	FConvertCache::Init( ParseParam( Cmd, "NOCACHE" ) ? nullptr : CacheDir );
+
+	// Sounds without a rule in FSoundCompressor::Rates are resampled to SNDRATE=<hz>
+	Parse( Cmd, "SNDRATE=", FSoundCompressor::DefaultRate );
+
+	// Saved packages are stored as compressed blocks of BLOCK=<bytes> with -compress
+	if( ParseParam( Cmd, "COMPRESS" ) )
+		CompressBlock = PACKAGE_COMPRESSED_BLOCK;
+	Parse( Cmd, "BLOCK=", CompressBlock );
 	if( Parse( Cmd, "CVTUTX=", Temp, sizeof( Temp ) - 1 ) )
 	{
+		// Find out what every map and script package uses before touching textures
+		char MapGlob[1024] = "../Maps/*.unr";
+		char ScriptGlob[1024] = "../System/*.u";
+		Parse( Cmd, "MAPS=", MapGlob, sizeof( MapGlob ) - 1 );
+		Parse( Cmd, "SCRIPTS=", ScriptGlob, sizeof( ScriptGlob ) - 1 );
+		FTextureUsage::bDropUnused = ParseParam( Cmd, "DROPUNUSED" );
+		FTextureUsage::Build( MapGlob, ScriptGlob );
 
 		// Process texture packages - collect all changed packages then save them together
 		char Path[2048];
@@ -839,13 +869,51 @@ void FDCUtil::Main( )
 			CommitChanges( LocalChangedNames, LocalChangedPtrs );
 		}
 	}
+	else if( Parse( Cmd, "REPORT=", Temp, sizeof( Temp ) - 1 ) )
+	{
+		// Memory budget report for one map, JSON unless FORMAT=CSV, to OUT=<file> or stdout
+		if( !appStrcmp( Temp, "*" ) )
+			appErrorf( "REPORT takes a single map." );
+		ParsePackageArg( Temp, nullptr );
+		char Format[16] = "JSON";
+		char OutPath[1024] = "";
+		Parse( Cmd, "FORMAT=", Format, sizeof( Format ) - 1 );
+		Parse( Cmd, "OUT=", OutPath, sizeof( OutPath ) - 1 );
+		// Over budget exits non-zero so build scripts can gate on it
+		if( !ReportMapPkg( LoadedPackageNames(0), LoadedPackagePtrs(0), !appStricmp( Format, "CSV" ), OutPath ) )
+			ErrorLevel = 1;
+	}
+	else if( Parse( Cmd, "CACHEBENCH=", Temp, sizeof( Temp ) - 1 ) )
+	{
+		// Replay a CACHERECORD file, in a cache of SIZE=<bytes> and ITEMS=<n> if given
+		INT CacheSize = 0, MaxItems = 0;
+		Parse( Cmd, "SIZE=", CacheSize );
+		Parse( Cmd, "ITEMS=", MaxItems );
+		BenchCache( Temp, CacheSize, MaxItems );
+	}
+	else if( Parse( Cmd, "COMPRESS=", Temp, sizeof( Temp ) - 1 ) )
+	{
+		// Rewrite packages as compressed blocks, in place
+		if( !CompressBlock )
+			CompressBlock = PACKAGE_COMPRESSED_BLOCK;
+		printf( "Compressing packages in %dK blocks\n", CompressBlock / 1024 );
+		CompressPackages( Temp );
+	}
 	else
 	{
-		printf( "Usage: dctool CVTUTX=<TEXPKG> | CVTUAX=<SOUNDPKG> | CVTUMX=<MUSPKG> | CVTUMH=<UMESHPKG> | CVTUNR=<MAPPKG>\n" );
+		printf( "Usage: dctool CVTUTX=<TEXPKG> | CVTUAX=<SOUNDPKG> | CVTUMX=<MUSPKG> | CVTUMH=<UMESHPKG> | CVTUNR=<MAPPKG> [-jobs=N] [CACHE=<DIR> | -nocache] [SNDRATE=<HZ>] [-compress [BLOCK=<BYTES>]]\n" );
+		printf( "       dctool CVTUTX=<TEXPKG> [MAPS=<MAPGLOB>] [SCRIPTS=<SCRIPTGLOB>] [-dropunused]\n" );
+		printf( "       dctool REPORT=<MAPPKG> [FORMAT=JSON|CSV] [OUT=<FILE>]\n" );
+		printf( "       dctool CACHEBENCH=<CACHERECORD FILE> [SIZE=<BYTES>] [ITEMS=<N>]\n" );
+		printf( "       dctool COMPRESS=<PKG> [BLOCK=<BYTES>]\n" );
 	}
 
+	delete Jobs;
+	Jobs = nullptr;
+
 	GIsRunning = 0;
 
+	return ErrorLevel;
 	unguard;
 }
 
@@ -896,7 +964,7 @@ int main( int argc, const char** argv )
 	// Start main loop.
 	GIsGuarded=1;
 	DCUtil.InitEngine();
-	DCUtil.Main();
+	ErrorLevel = DCUtil.Main();
 	DCUtil.ExitEngine();
 	GIsGuarded=0;
 
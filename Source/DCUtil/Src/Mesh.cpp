@@ -1,4 +1,6 @@
+#include "tri_stripper.h"
 #include "Mesh.h"
+#include "ConvertCache.h"
 
 namespace
 {
@@ -753,19 +755,269 @@ static UBOOL ReduceKeyframes( UMesh* Mesh, FLOAT FrameTolerance, const TArray<FL
 	return 1;
 }
 
+// Vertex cache optimization scoring, after Tom Forsyth's "Linear-Speed
+// Vertex Cache Optimisation". The modelled cache is an LRU a bit larger
+// than the FIFO being targeted, which works well for any small cache.
+const INT ForsythCacheSize = 32;
+const FLOAT ForsythCacheDecayPower = 1.5f;
+const FLOAT ForsythLastTriScore = 0.75f;
+const FLOAT ForsythValenceBoostScale = 2.0f;
+const FLOAT ForsythValenceBoostPower = 0.5f;
+
+static FLOAT ForsythVertexScore( INT CachePosition, INT RemainingTris )
+{
+	if( RemainingTris == 0 )
+		return -1.0f;
+
+	FLOAT Score = 0.0f;
+	if( CachePosition >= 0 )
+	{
+		// The last triangle's vertices get a fixed score so the next one
+		// doesn't just reuse the same edge
+		if( CachePosition < 3 )
+			Score = ForsythLastTriScore;
+		else
+			Score = appPow( 1.0f - (FLOAT)( CachePosition - 3 ) / ( ForsythCacheSize - 3 ), ForsythCacheDecayPower );
+	}
+
+	// Favour vertices with few triangles left, to finish them off
+	return Score + ForsythValenceBoostScale * appPow( (FLOAT)RemainingTris, -ForsythValenceBoostPower );
+}
+
+//
+// Reorder Tris for the post-transform vertex cache, then renumber vertices
+// in order of first use so GetFrame walks them linearly. Only keeps the
+// result if it lowers the ACMR.
+//
+static UBOOL OptimizeVertexCache( UMesh* Mesh, INT CacheSize )
+{
+	const INT NumTris = Mesh->Tris.Num();
+	const INT NumVerts = Mesh->FrameVerts;
+	if( NumTris < 2 || NumVerts <= 0 )
+		return 0;
+
+	// Triangles using each vertex, the live ones kept at the front of each list
+	TArray<INT> Remaining, FirstTri, VertTris;
+	Remaining.AddZeroed( NumVerts );
+	FirstTri.AddZeroed( NumVerts );
+	VertTris.Add( NumTris * 3 );
+	for( INT i = 0; i < NumTris; i++ )
+		for( INT j = 0; j < 3; j++ )
+			Remaining( Mesh->Tris(i).iVertex[j] )++;
+	for( INT v = 1; v < NumVerts; v++ )
+		FirstTri(v) = FirstTri(v - 1) + Remaining(v - 1);
+	{
+		TArray<INT> Fill;
+		Fill.AddZeroed( NumVerts );
+		for( INT i = 0; i < NumTris; i++ )
+			for( INT j = 0; j < 3; j++ )
+			{
+				const INT v = Mesh->Tris(i).iVertex[j];
+				VertTris( FirstTri(v) + Fill(v)++ ) = i;
+			}
+	}
+
+	TArray<INT> CachePosition;
+	TArray<FLOAT> VertScore, TriScore;
+	TArray<BYTE> Emitted;
+	CachePosition.Add( NumVerts );
+	VertScore.Add( NumVerts );
+	TriScore.AddZeroed( NumTris );
+	Emitted.AddZeroed( NumTris );
+	for( INT v = 0; v < NumVerts; v++ )
+	{
+		CachePosition(v) = -1;
+		VertScore(v) = ForsythVertexScore( -1, Remaining(v) );
+	}
+	for( INT i = 0; i < NumTris; i++ )
+		for( INT j = 0; j < 3; j++ )
+			TriScore(i) += VertScore( Mesh->Tris(i).iVertex[j] );
+
+	INT Cache[ForsythCacheSize + 3];
+	INT CacheCount = 0;
+	TArray<INT> Order;
+	Order.Empty( NumTris );
+	INT BestTri = -1;
+	INT ScanStart = 0;
+	while( Order.Num() < NumTris )
+	{
+		// Nothing adjacent to the cache, take the best of the rest
+		if( BestTri < 0 )
+		{
+			FLOAT BestScore = -1.0f;
+			while( Emitted( ScanStart ) )
+				ScanStart++;
+			for( INT i = ScanStart; i < NumTris; i++ )
+			{
+				if( !Emitted(i) && TriScore(i) > BestScore )
+				{
+					BestScore = TriScore(i);
+					BestTri = i;
+				}
+			}
+		}
+
+		// Emit it and take it off its vertices' lists
+		const FMeshTri& Tri = Mesh->Tris( BestTri );
+		Order.AddItem( BestTri );
+		Emitted( BestTri ) = 1;
+		for( INT j = 0; j < 3; j++ )
+		{
+			const INT v = Tri.iVertex[j];
+			INT* List = &VertTris( FirstTri(v) );
+			for( INT k = 0; k < Remaining(v); k++ )
+			{
+				if( List[k] == BestTri )
+				{
+					List[k] = List[Remaining(v) - 1];
+					List[Remaining(v) - 1] = BestTri;
+					Remaining(v)--;
+					break;
+				}
+			}
+		}
+
+		// Move its vertices to the front of the cache
+		INT NewCache[ForsythCacheSize + 3];
+		INT NewCount = 0;
+		for( INT j = 0; j < 3; j++ )
+		{
+			UBOOL bDuplicate = 0;
+			for( INT k = 0; k < NewCount; k++ )
+				bDuplicate |= NewCache[k] == Tri.iVertex[j];
+			if( !bDuplicate )
+				NewCache[NewCount++] = Tri.iVertex[j];
+		}
+		for( INT k = 0; k < CacheCount; k++ )
+		{
+			const INT v = Cache[k];
+			if( v != Tri.iVertex[0] && v != Tri.iVertex[1] && v != Tri.iVertex[2] )
+				NewCache[NewCount++] = v;
+		}
+
+		// Rescore everything that was or is in the cache, and pick the next
+		// triangle from the ones touching it
+		for( INT k = 0; k < NewCount; k++ )
+		{
+			const INT v = NewCache[k];
+			CachePosition(v) = k < ForsythCacheSize ? k : -1;
+			const FLOAT NewScore = ForsythVertexScore( CachePosition(v), Remaining(v) );
+			const FLOAT Delta = NewScore - VertScore(v);
+			VertScore(v) = NewScore;
+			for( INT t = 0; t < Remaining(v); t++ )
+				TriScore( VertTris( FirstTri(v) + t ) ) += Delta;
+		}
+		CacheCount = Min( NewCount, ForsythCacheSize );
+		appMemcpy( Cache, NewCache, CacheCount * sizeof(INT) );
+
+		BestTri = -1;
+		FLOAT BestScore = -1.0f;
+		for( INT k = 0; k < CacheCount; k++ )
+		{
+			const INT v = Cache[k];
+			for( INT t = 0; t < Remaining(v); t++ )
+			{
+				const INT i = VertTris( FirstTri(v) + t );
+				if( TriScore(i) > BestScore )
+				{
+					BestScore = TriScore(i);
+					BestTri = i;
+				}
+			}
+		}
+	}
+
+	// Renumber vertices by first use, unused ones keep their order at the end
+	TArray<INT> NewIndex;
+	NewIndex.Add( NumVerts );
+	for( INT v = 0; v < NumVerts; v++ )
+		NewIndex(v) = -1;
+	INT NextIndex = 0;
+	for( INT i = 0; i < NumTris; i++ )
+		for( INT j = 0; j < 3; j++ )
+		{
+			const INT v = Mesh->Tris( Order(i) ).iVertex[j];
+			if( NewIndex(v) < 0 )
+				NewIndex(v) = NextIndex++;
+		}
+	for( INT v = 0; v < NumVerts; v++ )
+		if( NewIndex(v) < 0 )
+			NewIndex(v) = NextIndex++;
+
+	TArray<FMeshTri> NewTris;
+	NewTris.Add( NumTris );
+	for( INT i = 0; i < NumTris; i++ )
+	{
+		NewTris(i) = Mesh->Tris( Order(i) );
+		for( INT j = 0; j < 3; j++ )
+			NewTris(i).iVertex[j] = NewIndex( NewTris(i).iVertex[j] );
+	}
+
+	const FLOAT OldACMR = FMeshReducer::ComputeACMR( Mesh, CacheSize );
+	ExchangeArray( (TArray<FMeshTri>&)Mesh->Tris, NewTris );
+	if( FMeshReducer::ComputeACMR( Mesh, CacheSize ) >= OldACMR )
+	{
+		ExchangeArray( (TArray<FMeshTri>&)Mesh->Tris, NewTris );
+		return 0;
+	}
+
+	TArray<FMeshVert> NewVerts;
+	NewVerts.Add( Mesh->Verts.Num() );
+	for( INT f = 0; f < Mesh->AnimFrames; f++ )
+		for( INT v = 0; v < NumVerts; v++ )
+			NewVerts( f * NumVerts + NewIndex(v) ) = Mesh->Verts( f * NumVerts + v );
+	ExchangeArray( (TArray<FMeshVert>&)Mesh->Verts, NewVerts );
+
+	RebuildConnectivity( Mesh );
+	return 1;
+}
+
 } // namespace
 
+FLOAT FMeshReducer::ComputeACMR( const UMesh* Mesh, INT CacheSize )
+{
+	if( Mesh->Tris.Num() == 0 || CacheSize <= 0 )
+		return 0.0f;
+
+	TArray<INT> Fifo;
+	Fifo.Add( CacheSize );
+	for( INT k = 0; k < CacheSize; k++ )
+		Fifo(k) = -1;
+
+	INT Misses = 0, Head = 0;
+	for( INT i = 0; i < Mesh->Tris.Num(); i++ )
+	{
+		for( INT j = 0; j < 3; j++ )
+		{
+			const INT v = Mesh->Tris(i).iVertex[j];
+			UBOOL bHit = 0;
+			for( INT k = 0; k < CacheSize && !bHit; k++ )
+				bHit = Fifo(k) == v;
+			if( !bHit )
+			{
+				Misses++;
+				Fifo( Head ) = v;
+				Head = ( Head + 1 ) % CacheSize;
+			}
+		}
+	}
+	return (FLOAT)Misses / Mesh->Tris.Num();
+}
+
 UBOOL FMeshReducer::Reduce( UMesh* Mesh, const FOptions& Options, FMeshReductionStats* OutStats )
 {
 	guard(FMeshReducer::Reduce);
 
-	if( Mesh == nullptr )
+	// Packed frames can't be reduced any further, see FMeshPacker
+	if( Mesh == nullptr || Mesh->PackedFrames.Num() )
 	{
 		return 0;
 	}
 
+	// MeshName is left to the caller, GetPathName isn't safe to call off the main thread
 	FMeshReductionStats Stats;
-	Stats.MeshName = Mesh->GetPathName();
+	if( OutStats )
+		Stats.MeshName = OutStats->MeshName;
 	Stats.OriginalVerts = Mesh->FrameVerts;
 	Stats.OriginalTriangles = Mesh->Tris.Num();
 	Stats.OriginalFrames = Mesh->AnimFrames;
@@ -809,12 +1061,19 @@ UBOOL FMeshReducer::Reduce( UMesh* Mesh, const FOptions& Options, FMeshReduction
 
 	const UBOOL bReducedFrames = ReduceKeyframes( Mesh, FrameToleranceUnits, PerVertexToleranceSq.Num() ? &PerVertexToleranceSq : nullptr );
 
+	// LOD meshes draw from Faces, and their vertex order is the collapse order
+	UBOOL bReordered = 0;
+	Stats.OriginalACMR = ComputeACMR( Mesh, Options.VertexCacheSize );
+	if( !Mesh->IsA( ULodMesh::StaticClass() ) )
+		bReordered = OptimizeVertexCache( Mesh, Options.VertexCacheSize );
+	Stats.ReducedACMR = ComputeACMR( Mesh, Options.VertexCacheSize );
+
 	Stats.ReducedVerts = Mesh->FrameVerts;
 	Stats.ReducedTriangles = Mesh->Tris.Num();
 	Stats.ReducedFrames = Mesh->AnimFrames;
 	Stats.ReducedVerts = Mesh->FrameVerts;
 	Stats.ReducedFrames = Mesh->AnimFrames;
-	Stats.bChanged = bReducedVertices | bReducedFrames | bRemovedTris;
+	Stats.bChanged = bReducedVertices | bReducedFrames | bRemovedTris | bReordered;
 
 	if( OutStats )
 	{
@@ -825,3 +1084,409 @@ UBOOL FMeshReducer::Reduce( UMesh* Mesh, const FOptions& Options, FMeshReduction
 	unguard;
 }
 
+
+/*-----------------------------------------------------------------------------
+	FMeshStripifier.
+-----------------------------------------------------------------------------*/
+
+//
+// Triangles sharing a texture and set of flags, with their corners as
+// indices into the group's own unique wedges.
+//
+struct FStripGroup
+{
+	DWORD PolyFlags;
+	INT TextureIndex;
+	TArray<FMeshWedge> Wedges;
+	TMap<DWORD,INT> WedgeMap;
+	TArray<INT> Corners;
+
+	void AddTriangle( const FMeshWedge& W0, const FMeshWedge& W1, const FMeshWedge& W2 )
+	{
+		// Degenerate triangles draw nothing and only confuse the stripper
+		if( W0.iVertex == W1.iVertex || W1.iVertex == W2.iVertex || W2.iVertex == W0.iVertex )
+			return;
+		AddCorner( W0 );
+		AddCorner( W1 );
+		AddCorner( W2 );
+	}
+	void AddCorner( const FMeshWedge& Wedge )
+	{
+		const DWORD Key = *(const DWORD*)&Wedge;
+		INT* Found = WedgeMap.Find( Key );
+		if( !Found )
+		{
+			WedgeMap.Set( Key, Wedges.Num() );
+			Wedges.AddItem( Wedge );
+			Corners.AddItem( Wedges.Num() - 1 );
+		}
+		else Corners.AddItem( *Found );
+	}
+};
+
+//
+// Rotation invariant key for a wound triangle, 21 bits per wedge index.
+//
+static QWORD StripTriangleKey( QWORD A, QWORD B, QWORD C )
+{
+	if( B < A && B < C )
+		return ( B << 42 ) | ( C << 21 ) | A;
+	if( C < A && C < B )
+		return ( C << 42 ) | ( A << 21 ) | B;
+	return ( A << 42 ) | ( B << 21 ) | C;
+}
+
+static FStripGroup& FindStripGroup( TArray<FStripGroup>& Groups, DWORD PolyFlags, INT TextureIndex )
+{
+	for( INT i = 0; i < Groups.Num(); i++ )
+		if( Groups(i).PolyFlags == PolyFlags && Groups(i).TextureIndex == TextureIndex )
+			return Groups(i);
+	FStripGroup* Group = new( Groups )FStripGroup;
+	Group->PolyFlags = PolyFlags;
+	Group->TextureIndex = TextureIndex;
+	return *Group;
+}
+
+//
+// Append one strip to the mesh, ticking its triangles off Expected. Fails if
+// a triangle wasn't expected, or comes out wound the other way.
+//
+static UBOOL AddStrip( UMesh* Mesh, const FStripGroup& Group, const triangle_stripper::index* Indices, INT NumWedges, TMap<QWORD,INT>& Expected, FMeshReductionStats& Stats )
+{
+	for( INT i = 0; i < NumWedges - 2; i++ )
+	{
+		QWORD A = Indices[i], B = Indices[i + 1], C = Indices[i + 2];
+		if( i & 1 )
+			Exchange( A, B );
+		INT* Count = Expected.Find( StripTriangleKey( A, B, C ) );
+		if( !Count || *Count == 0 )
+			return 0;
+		(*Count)--;
+	}
+
+	FMeshStrip* Strip = new( Mesh->Strips )FMeshStrip;
+	Strip->PolyFlags = Group.PolyFlags;
+	Strip->TextureIndex = Group.TextureIndex;
+	Strip->FirstWedge = Mesh->StripWedges.Num();
+	Strip->NumWedges = NumWedges;
+	for( INT i = 0; i < NumWedges; i++ )
+		Mesh->StripWedges.AddItem( Group.Wedges( Indices[i] ) );
+
+	Stats.NumStrips++;
+	Stats.StripTriangles += NumWedges - 2;
+	Stats.StripWedges += NumWedges;
+	return 1;
+}
+
+//
+// Strip one group into the mesh, checking every triangle comes out exactly
+// once. Triangles the stripper leaves as a list become one strip each.
+//
+static UBOOL StripGroup( UMesh* Mesh, const FStripGroup& Group, FMeshReductionStats& Stats )
+{
+	if( Group.Wedges.Num() >= ( 1 << 21 ) )
+		return 0;
+
+	TMap<QWORD,INT> Expected;
+	triangle_stripper::indices Corners;
+	Corners.reserve( Group.Corners.Num() );
+	for( INT i = 0; i < Group.Corners.Num(); i += 3 )
+	{
+		const QWORD Key = StripTriangleKey( Group.Corners(i), Group.Corners(i + 1), Group.Corners(i + 2) );
+		INT* Count = Expected.Find( Key );
+		Expected.Set( Key, Count ? *Count + 1 : 1 );
+		for( INT j = 0; j < 3; j++ )
+			Corners.push_back( Group.Corners(i + j) );
+	}
+
+	triangle_stripper::primitive_vector Primitives;
+	triangle_stripper::tri_stripper Stripper( Corners );
+	Stripper.SetCacheSize( FMeshStripifier::CacheSize );
+	Stripper.SetMinStripSize( 2 );
+	Stripper.Strip( &Primitives );
+
+	for( size_t p = 0; p < Primitives.size(); p++ )
+	{
+		const triangle_stripper::primitive_group& Prim = Primitives[p];
+		const INT Num = Prim.Indices.size();
+		if( Prim.Type == triangle_stripper::TRIANGLE_STRIP )
+		{
+			if( Num >= 3 && !AddStrip( Mesh, Group, &Prim.Indices[0], Num, Expected, Stats ) )
+				return 0;
+		}
+		else for( INT i = 0; i + 2 < Num; i += 3 )
+		{
+			if( !AddStrip( Mesh, Group, &Prim.Indices[i], 3, Expected, Stats ) )
+				return 0;
+		}
+	}
+
+	// Anything the stripper dropped would go missing on screen
+	for( TMap<QWORD,INT>::TIterator It( Expected ); It; ++It )
+		if( It.Value() )
+			return 0;
+	return 1;
+}
+
+UBOOL FMeshStripifier::Build( UMesh* Mesh, FMeshReductionStats* OutStats )
+{
+	guard(FMeshStripifier::Build);
+
+	FMeshReductionStats Stats;
+	Mesh->StripWedges.Empty();
+	Mesh->Strips.Empty();
+
+	// Group the visible triangles, invisible ones only carry weapon coordinates
+	TArray<FStripGroup> Groups;
+	if( Mesh->IsA( ULodMesh::StaticClass() ) )
+	{
+		ULodMesh* LodMesh = (ULodMesh*)Mesh;
+		for( INT i = 0; i < LodMesh->Faces.Num(); i++ )
+		{
+			const FMeshFace& Face = LodMesh->Faces(i);
+			const FMeshMaterial& Material = LodMesh->Materials( Face.MaterialIndex );
+			if( Material.PolyFlags & PF_Invisible )
+				continue;
+			FStripGroup& Group = FindStripGroup( Groups, Material.PolyFlags, Material.TextureIndex );
+			Group.AddTriangle( LodMesh->Wedges( Face.iWedge[0] ), LodMesh->Wedges( Face.iWedge[1] ), LodMesh->Wedges( Face.iWedge[2] ) );
+		}
+	}
+	else
+	{
+		for( INT i = 0; i < Mesh->Tris.Num(); i++ )
+		{
+			const FMeshTri& Tri = Mesh->Tris(i);
+			if( Tri.PolyFlags & PF_Invisible )
+				continue;
+			FStripGroup& Group = FindStripGroup( Groups, Tri.PolyFlags, Tri.TextureIndex );
+			FMeshWedge W[3];
+			for( INT j = 0; j < 3; j++ )
+			{
+				W[j].iVertex = Tri.iVertex[j];
+				W[j].TexUV = Tri.Tex[j];
+			}
+			Group.AddTriangle( W[0], W[1], W[2] );
+		}
+	}
+
+	UBOOL bOk = Groups.Num() > 0;
+	for( INT i = 0; i < Groups.Num() && bOk; i++ )
+		if( Groups(i).Corners.Num() )
+			bOk = StripGroup( Mesh, Groups(i), Stats );
+
+	// Strips only pay off if they share vertices, otherwise keep drawing triangles
+	if( !bOk || Stats.StripWedges >= Stats.StripTriangles * 3 )
+	{
+		Mesh->StripWedges.Empty();
+		Mesh->Strips.Empty();
+		Stats.NumStrips = Stats.StripTriangles = Stats.StripWedges = 0;
+	}
+
+	if( OutStats )
+	{
+		OutStats->NumStrips = Stats.NumStrips;
+		OutStats->StripTriangles = Stats.StripTriangles;
+		OutStats->StripWedges = Stats.StripWedges;
+	}
+	return Mesh->Strips.Num() > 0;
+	unguard;
+}
+
+//
+// Pack every frame against its own bounding box. Gives up, leaving Verts
+// alone, if any vertex would move further than Tolerance in the world or
+// the packed frames wouldn't be smaller.
+//
+UBOOL FMeshPacker::Pack( UMesh* Mesh, FLOAT Tolerance, FMeshReductionStats* OutStats )
+{
+	guard(FMeshPacker::Pack);
+
+	const INT FrameVerts = Mesh->FrameVerts;
+	const INT NumFrames = Mesh->AnimFrames;
+	if( Tolerance <= 0.0f || Mesh->PackedFrames.Num() || FrameVerts <= 0 || NumFrames <= 0
+	||	Mesh->Verts.Num() != FrameVerts * NumFrames )
+		return 0;
+	if( FrameVerts * NumFrames * 3 + NumFrames * (INT)sizeof(FMeshPackedFrame) >= Mesh->Verts.Num() * (INT)sizeof(FMeshVert) )
+		return 0;
+
+	FVector WorldScale( Abs( Mesh->Scale.X ), Abs( Mesh->Scale.Y ), Abs( Mesh->Scale.Z ) );
+	TArray<FMeshPackedFrame> Frames( NumFrames );
+	TArray<BYTE> Packed( FrameVerts * NumFrames * 3 );
+	FLOAT MaxError = 0.0f;
+	for( INT f = 0; f < NumFrames; f++ )
+	{
+		const FMeshVert* Src = &Mesh->Verts( f * FrameVerts );
+		FVector Min = Src[0].Vector(), Max = Src[0].Vector();
+		for( INT i = 1; i < FrameVerts; i++ )
+		{
+			const FVector V = Src[i].Vector();
+			Min.X = ::Min( Min.X, V.X ); Min.Y = ::Min( Min.Y, V.Y ); Min.Z = ::Min( Min.Z, V.Z );
+			Max.X = ::Max( Max.X, V.X ); Max.Y = ::Max( Max.Y, V.Y ); Max.Z = ::Max( Max.Z, V.Z );
+		}
+		FMeshPackedFrame& Frame = Frames(f);
+		Frame.Min = Min;
+		Frame.Step = (Max - Min) / 255.0f;
+
+		BYTE* Dst = &Packed( f * FrameVerts * 3 );
+		for( INT i = 0; i < FrameVerts; i++, Dst += 3 )
+		{
+			FVector V = Src[i].Vector();
+			for( INT a = 0; a < 3; a++ )
+			{
+				const FLOAT Step = Frame.Step.Component(a);
+				const FLOAT Offset = V.Component(a) - Min.Component(a);
+				Dst[a] = Step > 0.0f ? (BYTE)Clamp( appRound( Offset / Step ), 0, 255 ) : 0;
+				MaxError = ::Max( MaxError, Abs( Dst[a] * Step - Offset ) * WorldScale.Component(a) );
+			}
+		}
+		if( MaxError > Tolerance )
+			return 0;
+	}
+
+	ExchangeArray( Mesh->PackedFrames, Frames );
+	ExchangeArray( (TArray<BYTE>&)Mesh->PackedVerts, Packed );
+	Mesh->Verts.Empty();
+
+	if( OutStats )
+	{
+		OutStats->bPacked = 1;
+		OutStats->PackError = MaxError;
+	}
+	return 1;
+	unguard;
+}
+
+FMeshReduceJob::FMeshReduceJob( UMesh* InMesh, const FMeshReducer::FOptions& InOptions )
+:	Mesh( InMesh )
+,	Options( InOptions )
+,	bReduced( 0 )
+{
+	// Pull in everything lazy now, the worker must not touch the linker
+	Mesh->Verts.Load();
+	Mesh->Tris.Load();
+	Mesh->Connects.Load();
+	Mesh->VertLinks.Load();
+
+	Stats.MeshName = Mesh->GetPathName();
+	OldSize = MeshDataSize( Mesh );
+}
+
+INT FMeshReduceJob::MeshDataSize( const UMesh* Mesh )
+{
+	return Mesh->Tris.Num() * sizeof(FMeshTri) + Mesh->Verts.Num() * sizeof(FMeshVert)
+		+ Mesh->PackedVerts.Num() + Mesh->PackedFrames.Num() * sizeof(FMeshPackedFrame)
+		+ Mesh->StripWedges.Num() * sizeof(FMeshWedge) + Mesh->Strips.Num() * sizeof(FMeshStrip);
+}
+
+//
+// Everything Reduce and the stripifier can touch, in cache payload order.
+// Lazy arrays go through their TArray base so they serialize inline.
+//
+static void SerializeReducedMesh( FArchive& Ar, UMesh* Mesh, FMeshReductionStats& Stats )
+{
+	Ar << Stats.NumStrips << Stats.StripTriangles << Stats.StripWedges;
+	Ar << Mesh->StripWedges << Mesh->Strips;
+	Ar << Stats.OriginalVerts << Stats.OriginalTriangles << Stats.OriginalFrames;
+	Ar << Stats.ReducedVerts << Stats.ReducedTriangles << Stats.ReducedFrames;
+	Ar << Stats.bChanged << Stats.OriginalACMR << Stats.ReducedACMR;
+	if( Stats.bChanged )
+	{
+		Ar << Mesh->FrameVerts << Mesh->AnimFrames;
+		Ar << (TArray<FMeshVert>&)Mesh->Verts << (TArray<FMeshTri>&)Mesh->Tris;
+		for( INT i = 0; i < Mesh->AnimSeqs.Num(); i++ )
+			Ar << Mesh->AnimSeqs(i).StartFrame << Mesh->AnimSeqs(i).NumFrames << Mesh->AnimSeqs(i).Rate;
+		Ar << (TArray<FMeshVertConnect>&)Mesh->Connects << (TArray<INT>&)Mesh->VertLinks;
+		Ar << Mesh->BoundingBoxes << Mesh->BoundingSpheres;
+		Ar << Mesh->BoundingBox << Mesh->BoundingSphere;
+	}
+
+	// Packing goes last, it empties Verts
+	Ar << Stats.bPacked << Stats.PackError;
+	if( Stats.bPacked )
+	{
+		Ar << Mesh->PackedFrames << (TArray<BYTE>&)Mesh->PackedVerts;
+		if( Ar.IsLoading() )
+			Mesh->Verts.Empty();
+	}
+}
+
+void FMeshReduceJob::Encode()
+{
+	FConvertKey Key( "MSH", FMeshReducer::Version );
+	Key.Update( &Options, sizeof(Options) );
+	Key.Update( &Mesh->FrameVerts, sizeof(INT) );
+	Key.Update( &Mesh->AnimFrames, sizeof(INT) );
+	Key.Update( (TArray<FMeshVert>&)Mesh->Verts );
+	Key.Update( (TArray<FMeshTri>&)Mesh->Tris );
+	for( INT i = 0; i < Mesh->AnimSeqs.Num(); i++ )
+	{
+		const FMeshAnimSeq& Seq = Mesh->AnimSeqs(i);
+		Key.Update( &Seq.StartFrame, sizeof(INT) );
+		Key.Update( &Seq.NumFrames, sizeof(INT) );
+		Key.Update( &Seq.Rate, sizeof(FLOAT) );
+	}
+	if( Mesh->IsA( ULodMesh::StaticClass() ) )
+	{
+		ULodMesh* LodMesh = (ULodMesh*)Mesh;
+		Key.Update( LodMesh->Faces );
+		Key.Update( LodMesh->Wedges );
+		Key.Update( LodMesh->Materials );
+	}
+
+	TArray<BYTE> Payload;
+	if( FConvertCache::Load( Key.Get(), Payload ) )
+	{
+		FBufferReader Ar( Payload );
+		SerializeReducedMesh( Ar, Mesh, Stats );
+		bReduced = Stats.bChanged;
+		bCacheHit = 1;
+		return;
+	}
+
+	bReduced = FMeshReducer::Reduce( Mesh, Options, &Stats );
+	FMeshStripifier::Build( Mesh, &Stats );
+	FMeshPacker::Pack( Mesh, Options.PackTolerance, &Stats );
+
+	if( FConvertCache::IsEnabled() )
+	{
+		FBufferWriter Ar( Payload );
+		SerializeReducedMesh( Ar, Mesh, Stats );
+		FConvertCache::Store( Key.Get(), Payload );
+	}
+}
+
+UBOOL FMeshReduceJob::Commit()
+{
+	NewSize = MeshDataSize( Mesh );
+	if( Stats.ReducedACMR != Stats.OriginalACMR )
+	{
+		printf( "- %s: reordered for the vertex cache, ACMR %.3f -> %.3f\n",
+			Mesh->GetName(), Stats.OriginalACMR, Stats.ReducedACMR );
+	}
+	if( Stats.NumStrips )
+	{
+		printf( "- %s: %d strips, %d tris in %d strip verts (%.2f per tri)\n",
+			Mesh->GetName(), Stats.NumStrips, Stats.StripTriangles, Stats.StripWedges,
+			(FLOAT)Stats.StripWedges / Stats.StripTriangles );
+	}
+	if( Stats.bPacked )
+	{
+		printf( "- %s: packed %d frames to 3 bytes a vertex, max error %.3f\n",
+			Mesh->GetName(), Mesh->PackedFrames.Num(), Stats.PackError );
+	}
+	if( bReduced )
+	{
+		printf( "- %s: REDUCED %d -> %d verts, %d -> %d tris, %d -> %d frames (%d -> %d bytes)\n",
+			Mesh->GetName(),
+			Stats.OriginalVerts, Stats.ReducedVerts,
+			Stats.OriginalTriangles, Stats.ReducedTriangles,
+			Stats.OriginalFrames, Stats.ReducedFrames,
+			OldSize, NewSize );
+	}
+	else
+	{
+		printf( "- %s: %d verts, %d tris, %d frames (%d bytes) - no reduction needed\n",
+			Mesh->GetName(), Mesh->FrameVerts, Mesh->Tris.Num(), Mesh->AnimFrames, OldSize );
+	}
+	return bReduced || Stats.NumStrips || Stats.bPacked;
+}
@@ -0,0 +1,370 @@
+#include "PvrTex.h"
+
+namespace
+{
+
+// Number of floats in a VQ training vector: 4 texels of RGBA.
+static constexpr INT VQDim = 16;
+
+// Alpha gets a heavier weight so masked and opaque texels never end up sharing a code.
+static constexpr FLOAT VQAlphaWeight = 4.0f;
+
+// Larger than any possible block distance.
+static constexpr FLOAT VQMaxDist = 1.e30f;
+
+// A unique 2x2 block (texels in twiddled order) and the number of times it occurs.
+struct FVQBlock
+{
+	QWORD Key;
+	INT Count;
+};
+
+static INT Compare( const FVQBlock& A, const FVQBlock& B )
+{
+	return A.Key < B.Key ? -1 : A.Key > B.Key ? 1 : 0;
+}
+
+static inline _WORD PackTexel( const FColor& C, UBOOL bAlpha )
+{
+	if( bAlpha )
+		return ((C.A & 0x80) << 8) | ((C.R & 0xF8) << 7) | ((C.G & 0xF8) << 2) | ((C.B & 0xF8) >> 3);
+	else
+		return ((C.R & 0xF8) << 8) | ((C.G & 0xFC) << 3) | ((C.B & 0xF8) >> 3);
+}
+
+static inline void UnpackTexel( _WORD T, UBOOL bAlpha, FLOAT* Out )
+{
+	if( bAlpha )
+	{
+		Out[0] = ((T >> 10) & 0x1F) * (255.0f / 31.0f);
+		Out[1] = ((T >> 5) & 0x1F) * (255.0f / 31.0f);
+		Out[2] = (T & 0x1F) * (255.0f / 31.0f);
+		Out[3] = (T & 0x8000) ? 255.0f * VQAlphaWeight : 0.0f;
+	}
+	else
+	{
+		Out[0] = ((T >> 11) & 0x1F) * (255.0f / 31.0f);
+		Out[1] = ((T >> 5) & 0x3F) * (255.0f / 63.0f);
+		Out[2] = (T & 0x1F) * (255.0f / 31.0f);
+		Out[3] = 0.0f;
+	}
+}
+
+static inline _WORD PackVector( const FLOAT* V, UBOOL bAlpha )
+{
+	if( bAlpha )
+	{
+		const INT R = Clamp( appRound( V[0] * (31.0f / 255.0f) ), 0, 31 );
+		const INT G = Clamp( appRound( V[1] * (31.0f / 255.0f) ), 0, 31 );
+		const INT B = Clamp( appRound( V[2] * (31.0f / 255.0f) ), 0, 31 );
+		const INT A = V[3] >= 127.5f * VQAlphaWeight ? 0x8000 : 0;
+		return A | (R << 10) | (G << 5) | B;
+	}
+	else
+	{
+		const INT R = Clamp( appRound( V[0] * (31.0f / 255.0f) ), 0, 31 );
+		const INT G = Clamp( appRound( V[1] * (63.0f / 255.0f) ), 0, 63 );
+		const INT B = Clamp( appRound( V[2] * (31.0f / 255.0f) ), 0, 31 );
+		return (R << 11) | (G << 5) | B;
+	}
+}
+
+static inline void UnpackBlock( QWORD Key, UBOOL bAlpha, FLOAT* Out )
+{
+	for( INT i = 0; i < 4; ++i )
+		UnpackTexel( (_WORD)( Key >> ( i * 16 ) ), bAlpha, Out + i * 4 );
+}
+
+// Squared distance with an early out once it exceeds Limit.
+static inline FLOAT BlockDistSq( const FLOAT* A, const FLOAT* B, FLOAT Limit )
+{
+	FLOAT Sum = 0.0f;
+	for( INT i = 0; i < VQDim; i += 4 )
+	{
+		for( INT j = i; j < i + 4; ++j )
+			Sum += Square( A[j] - B[j] );
+		if( Sum >= Limit )
+			break;
+	}
+	return Sum;
+}
+
+static INT FindNearestCode( const FLOAT* Vec, const TArray<FLOAT>& Codes, INT NumCodes, FLOAT* OutDistSq )
+{
+	INT Best = 0;
+	FLOAT BestDist = VQMaxDist;
+	for( INT c = 0; c < NumCodes; ++c )
+	{
+		const FLOAT Dist = BlockDistSq( Vec, &Codes( c * VQDim ), BestDist );
+		if( Dist < BestDist )
+		{
+			BestDist = Dist;
+			Best = c;
+		}
+	}
+	if( OutDistSq )
+		*OutDistSq = BestDist;
+	return Best;
+}
+
+//
+// Weighted k-means over the unique blocks. Seeds with a greedy farthest-point pass
+// so the result is deterministic, then runs Lloyd iterations until assignments settle.
+//
+static void TrainCodebook( const TArray<FVQBlock>& Unique, const TArray<FLOAT>& Vectors, INT NumCodes, TArray<FLOAT>& OutCodes )
+{
+	const INT NumUnique = Unique.Num();
+	OutCodes.Empty();
+	OutCodes.AddZeroed( NumCodes * VQDim );
+
+	// Seed: most frequent block first, then repeatedly the block with the worst weighted error.
+	TArray<FLOAT> MinDist;
+	MinDist.Add( NumUnique );
+	INT Seed = 0;
+	for( INT i = 1; i < NumUnique; ++i )
+		if( Unique(i).Count > Unique(Seed).Count )
+			Seed = i;
+	for( INT i = 0; i < NumUnique; ++i )
+		MinDist(i) = VQMaxDist;
+	for( INT c = 0; c < NumCodes; ++c )
+	{
+		appMemcpy( &OutCodes( c * VQDim ), &Vectors( Seed * VQDim ), VQDim * sizeof(FLOAT) );
+		FLOAT WorstError = -1.0f;
+		for( INT i = 0; i < NumUnique; ++i )
+		{
+			const FLOAT Dist = BlockDistSq( &Vectors( i * VQDim ), &OutCodes( c * VQDim ), MinDist(i) );
+			if( Dist < MinDist(i) )
+				MinDist(i) = Dist;
+			const FLOAT Error = MinDist(i) * Unique(i).Count;
+			if( Error > WorstError )
+			{
+				WorstError = Error;
+				Seed = i;
+			}
+		}
+	}
+
+	// Refine.
+	TArray<INT> Assignment;
+	Assignment.Add( NumUnique );
+	for( INT i = 0; i < NumUnique; ++i )
+		Assignment(i) = INDEX_NONE;
+	TArray<FLOAT> Sums;
+	TArray<INT> Weights;
+	for( INT Iter = 0; Iter < FPvrTexEncoder::MaxVQIterations; ++Iter )
+	{
+		Sums.Empty();
+		Sums.AddZeroed( NumCodes * VQDim );
+		Weights.Empty();
+		Weights.AddZeroed( NumCodes );
+
+		INT Changed = 0;
+		INT WorstBlock = 0;
+		FLOAT WorstError = -1.0f;
+		for( INT i = 0; i < NumUnique; ++i )
+		{
+			FLOAT Dist;
+			const FLOAT* Vec = &Vectors( i * VQDim );
+			const INT Code = FindNearestCode( Vec, OutCodes, NumCodes, &Dist );
+			if( Code != Assignment(i) )
+			{
+				Assignment(i) = Code;
+				Changed++;
+			}
+			const INT W = Unique(i).Count;
+			FLOAT* Sum = &Sums( Code * VQDim );
+			for( INT j = 0; j < VQDim; ++j )
+				Sum[j] += Vec[j] * W;
+			Weights(Code) += W;
+			if( Dist * W > WorstError )
+			{
+				WorstError = Dist * W;
+				WorstBlock = i;
+			}
+		}
+
+		if( !Changed )
+			break;
+
+		for( INT c = 0; c < NumCodes; ++c )
+		{
+			FLOAT* Code = &OutCodes( c * VQDim );
+			if( Weights(c) )
+			{
+				const FLOAT InvWeight = 1.0f / Weights(c);
+				for( INT j = 0; j < VQDim; ++j )
+					Code[j] = Sums( c * VQDim + j ) * InvWeight;
+			}
+			else
+			{
+				// Dead code, move it onto the worst represented block.
+				appMemcpy( Code, &Vectors( WorstBlock * VQDim ), VQDim * sizeof(FLOAT) );
+			}
+		}
+	}
+}
+
+} // namespace
+
+UBOOL FPvrTexEncoder::IsPvrFormat( ETextureFormat Fmt )
+{
+	return Fmt == TEXF_EXT_ARGB1555_TWID || Fmt == TEXF_EXT_ARGB1555_VQ
+		|| Fmt == TEXF_EXT_RGB565_TWID || Fmt == TEXF_EXT_RGB565_VQ;
+}
+
+//
+// PowerVR twiddled order: the low bits of both coordinates are interleaved with V
+// in the even bits, the remaining high bits of the longer side are appended on top.
+//
+INT FPvrTexEncoder::TwiddleIndex( INT U, INT V, INT USize, INT VSize )
+{
+	const INT MinSize = Min( USize, VSize );
+	INT Result = 0;
+	INT Bits = 0;
+	for( ; ( 1 << Bits ) < MinSize; ++Bits )
+	{
+		Result |= ( ( V >> Bits ) & 1 ) << ( 2 * Bits );
+		Result |= ( ( U >> Bits ) & 1 ) << ( 2 * Bits + 1 );
+	}
+	if( USize > VSize )
+		Result |= ( U >> Bits ) << ( 2 * Bits );
+	else if( VSize > USize )
+		Result |= ( V >> Bits ) << ( 2 * Bits );
+	return Result;
+}
+
+void FPvrTexEncoder::Encode( const FColor* Src, INT USize, INT VSize, ETextureFormat Fmt, TArray<BYTE>& OutData )
+{
+	guard(FPvrTexEncoder::Encode);
+
+	verify( Src );
+	if( ( USize & ( USize - 1 ) ) || ( VSize & ( VSize - 1 ) ) || USize < 2 || VSize < 2 )
+		appErrorf( "Can't encode %dx%d texture, sizes must be powers of two", USize, VSize );
+
+	switch( Fmt )
+	{
+		case TEXF_EXT_ARGB1555_TWID: EncodeTwiddled( Src, USize, VSize, 1, OutData ); break;
+		case TEXF_EXT_ARGB1555_VQ: EncodeVQ( Src, USize, VSize, 1, OutData ); break;
+		case TEXF_EXT_RGB565_TWID: EncodeTwiddled( Src, USize, VSize, 0, OutData ); break;
+		case TEXF_EXT_RGB565_VQ: EncodeVQ( Src, USize, VSize, 0, OutData ); break;
+		default:
+			appErrorf( "Can't encode format %d", Fmt );
+	}
+
+	unguard;
+}
+
+void FPvrTexEncoder::EncodeTwiddled( const FColor* Src, INT USize, INT VSize, UBOOL bAlpha, TArray<BYTE>& OutData )
+{
+	OutData.Empty( USize * VSize * sizeof(_WORD) );
+	OutData.Add( USize * VSize * sizeof(_WORD) );
+	_WORD* Dst = (_WORD*)&OutData(0);
+	for( INT V = 0; V < VSize; ++V )
+		for( INT U = 0; U < USize; ++U )
+			Dst[TwiddleIndex( U, V, USize, VSize )] = PackTexel( Src[V * USize + U], bAlpha );
+}
+
+//
+// VQ layout: a 256 entry codebook of twiddled 2x2 blocks followed by one byte
+// per block, with the block indices themselves in twiddled order.
+//
+void FPvrTexEncoder::EncodeVQ( const FColor* Src, INT USize, INT VSize, UBOOL bAlpha, TArray<BYTE>& OutData )
+{
+	const INT BlocksU = USize / 2;
+	const INT BlocksV = VSize / 2;
+	const INT NumBlocks = BlocksU * BlocksV;
+
+	// Gather blocks in index order.
+	TArray<QWORD> BlockKeys;
+	BlockKeys.Add( NumBlocks );
+	for( INT BV = 0; BV < BlocksV; ++BV )
+	{
+		for( INT BU = 0; BU < BlocksU; ++BU )
+		{
+			QWORD Key = 0;
+			for( INT DV = 0; DV < 2; ++DV )
+				for( INT DU = 0; DU < 2; ++DU )
+				{
+					const _WORD Texel = PackTexel( Src[( BV * 2 + DV ) * USize + BU * 2 + DU], bAlpha );
+					Key |= (QWORD)Texel << ( TwiddleIndex( DU, DV, 2, 2 ) * 16 );
+				}
+			BlockKeys( TwiddleIndex( BU, BV, BlocksU, BlocksV ) ) = Key;
+		}
+	}
+
+	// Collapse identical blocks.
+	TArray<FVQBlock> Unique;
+	Unique.Add( NumBlocks );
+	for( INT i = 0; i < NumBlocks; ++i )
+	{
+		Unique(i).Key = BlockKeys(i);
+		Unique(i).Count = 1;
+	}
+	Sort( &Unique(0), Unique.Num() );
+	INT NumUnique = 1;
+	for( INT i = 1; i < Unique.Num(); ++i )
+	{
+		if( Unique(i).Key == Unique(NumUnique - 1).Key )
+			Unique(NumUnique - 1).Count++;
+		else
+			Unique(NumUnique++) = Unique(i);
+	}
+	Unique.Remove( NumUnique, Unique.Num() - NumUnique );
+
+	TArray<FLOAT> Vectors;
+	Vectors.Add( NumUnique * VQDim );
+	for( INT i = 0; i < NumUnique; ++i )
+		UnpackBlock( Unique(i).Key, bAlpha, &Vectors( i * VQDim ) );
+
+	// Build the codebook, either straight from the unique blocks or by training.
+	TArray<_WORD> Codebook;
+	Codebook.AddZeroed( CodebookEntries * 4 );
+	TArray<INT> UniqueCode;
+	UniqueCode.Add( NumUnique );
+	if( NumUnique <= CodebookEntries )
+	{
+		for( INT i = 0; i < NumUnique; ++i )
+		{
+			for( INT t = 0; t < 4; ++t )
+				Codebook( i * 4 + t ) = (_WORD)( Unique(i).Key >> ( t * 16 ) );
+			UniqueCode(i) = i;
+		}
+	}
+	else
+	{
+		TArray<FLOAT> Codes;
+		TrainCodebook( Unique, Vectors, CodebookEntries, Codes );
+
+		// Quantize the codes, then match against what will actually be stored.
+		for( INT c = 0; c < CodebookEntries; ++c )
+		{
+			QWORD Key = 0;
+			for( INT t = 0; t < 4; ++t )
+			{
+				Codebook( c * 4 + t ) = PackVector( &Codes( c * VQDim + t * 4 ), bAlpha );
+				Key |= (QWORD)Codebook( c * 4 + t ) << ( t * 16 );
+			}
+			UnpackBlock( Key, bAlpha, &Codes( c * VQDim ) );
+		}
+		for( INT i = 0; i < NumUnique; ++i )
+			UniqueCode(i) = FindNearestCode( &Vectors( i * VQDim ), Codes, CodebookEntries, nullptr );
+	}
+
+	OutData.Empty( CodebookBytes + NumBlocks );
+	OutData.Add( CodebookBytes + NumBlocks );
+	appMemcpy( &OutData(0), &Codebook(0), CodebookBytes );
+	for( INT i = 0; i < NumBlocks; ++i )
+	{
+		// Binary search the sorted unique list for this block.
+		INT Lo = 0, Hi = NumUnique - 1;
+		while( Lo < Hi )
+		{
+			const INT Mid = ( Lo + Hi ) / 2;
+			if( Unique(Mid).Key < BlockKeys(i) )
+				Lo = Mid + 1;
+			else
+				Hi = Mid;
+		}
+		OutData( CodebookBytes + i ) = (BYTE)UniqueCode(Lo);
+	}
+}
@@ -0,0 +1,297 @@
+/*=============================================================================
+	Report.cpp: DCUtil memory budget report
+
+	Loads a map with everything it pulls in and predicts what it will take in
+	each of the Dreamcast's memory pools, so maps that don't fit are caught
+	before they are booted.
+=============================================================================*/
+
+#include "DCUtilPrivate.h"
+
+const INT FMemoryReport::PoolBudget[POOL_MAX] = { 16 * 1024 * 1024, 8 * 1024 * 1024, 2 * 1024 * 1024 };
+const char* const FMemoryReport::PoolNames[POOL_MAX] = { "main", "video", "sound" };
+const char* const FMemoryReport::CategoryNames[CAT_MAX] = { "texture", "sound", "music", "mesh", "model", "lightmap", "script", "object" };
+
+// Sounds longer than this are streamed by AICADrv from the WAV in main RAM.
+static const INT MaxAicaSamples = 65534;
+
+//
+// Archive for counting the dynamic memory an object owns, like the one
+// behind OBJ LIST. Lazy arrays only count once loaded.
+//
+class FArchiveReportCount : public FArchive
+{
+public:
+	FArchiveReportCount( UObject* Src )
+	:	Num( 0 )
+	{
+		Src->Serialize( *this );
+	}
+	void CountBytes( SIZE_T InNum, SIZE_T InMax )
+	{
+		Num += InNum;
+	}
+	SIZE_T Num;
+};
+
+static UObject* GetOutermost( UObject* Obj )
+{
+	while( Obj->GetOuter() )
+		Obj = Obj->GetOuter();
+	return Obj;
+}
+
+INT FMemoryReport::CountBytes( UObject* Obj )
+{
+	FArchiveReportCount Count( Obj );
+	return Obj->GetClass()->GetPropertiesSize() + Count.Num;
+}
+
+FMemoryReport::FEntry& FMemoryReport::FindEntry( UObject* Obj )
+{
+	const FName Package = GetOutermost( Obj )->GetFName();
+	for( INT i = 0; i < Entries.Num(); i++ )
+		if( Entries(i).Package == Package && Entries(i).Class == Obj->GetClass() )
+			return Entries(i);
+
+	FEntry* Entry = new( Entries )FEntry;
+	appMemzero( Entry, sizeof(FEntry) );
+	Entry->Package = Package;
+	Entry->Class = Obj->GetClass();
+	return *Entry;
+}
+
+//
+// Textures are uploaded from their base mip and the system RAM copy dropped,
+// VQ textures as they are and everything else converted to 16 bits.
+//
+void FMemoryReport::AddTexture( FEntry& Entry, UTexture* Texture )
+{
+	INT MipBytes = 0;
+	for( INT i = 0; i < Texture->Mips.Num(); i++ )
+		MipBytes += Texture->Mips(i).DataArray.Num();
+	Entry.Bytes[CAT_Texture][POOL_Main] += CountBytes( Texture ) - MipBytes;
+
+	if( Texture->Mips.Num() == 0 )
+		return;
+	FMipmap& Base = Texture->Mips(0);
+	if( Texture->Format == TEXF_EXT_ARGB1555_VQ || Texture->Format == TEXF_EXT_RGB565_VQ )
+	{
+		Base.DataArray.Load();
+		Entry.Bytes[CAT_Texture][POOL_Video] += Base.DataArray.Num();
+	}
+	else
+	{
+		Entry.Bytes[CAT_Texture][POOL_Video] += Max( 8, Base.USize ) * Max( 8, Base.VSize ) * 2;
+	}
+}
+
+//
+// Registered sounds keep their samples in AICA RAM and drop the WAV, unless
+// they are too long and get streamed from it.
+//
+void FMemoryReport::AddSound( FEntry& Entry, USound* Sound )
+{
+	Sound->Data.Load();
+	Entry.Bytes[CAT_Sound][POOL_Main] += CountBytes( Sound ) - Sound->Data.Num();
+
+	FWaveModInfo WaveInfo;
+	if( !Sound->Data.Num() || !WaveInfo.ReadWaveInfo( Sound->Data ) )
+	{
+		Entry.Bytes[CAT_Sound][POOL_Main] += Sound->Data.Num();
+		return;
+	}
+	const INT Bits = *WaveInfo.pBitsPerSample;
+	const INT Samples = Bits == 4 ? WaveInfo.SampleDataSize * 2 : WaveInfo.SampleDataSize * 8 / Max( 8, Bits * *WaveInfo.pChannels );
+	if( Samples > MaxAicaSamples )
+		Entry.Bytes[CAT_Sound][POOL_Main] += Sound->Data.Num();
+	else
+		Entry.Bytes[CAT_Sound][POOL_Sound] += WaveInfo.SampleDataSize;
+}
+
+//
+// Low memory builds keep LightBits run-length coded, see
+// UModel::SerializeLightBits. Everything else in the model is BSP.
+//
+void FMemoryReport::AddModel( FEntry& Entry, UModel* Model )
+{
+	const INT Counted = Model->LightMap.Num() * sizeof(FLightMapIndex) + Model->LightBits.Num();
+	INT LightBytes = Model->LightMap.Num() * sizeof(FLightMapIndex);
+	if( Model->LightBitsRLE.Num() )
+		LightBytes += Model->LightBitsRLE.Num() + ( Model->LightBitsSize / LIGHTBITS_SEEK_SPACING + 1 ) * sizeof(FLightBitsSeek);
+	else
+		LightBytes += Model->LightBits.Num();
+
+	Entry.Bytes[CAT_Model][POOL_Main] += CountBytes( Model ) - Counted;
+	Entry.Bytes[CAT_LightMap][POOL_Main] += LightBytes;
+}
+
+void FMemoryReport::AddObject( UObject* Obj )
+{
+	guard(FMemoryReport::AddObject);
+
+	FEntry& Entry = FindEntry( Obj );
+	Entry.Count++;
+
+	if( UTexture* Texture = Cast<UTexture>( Obj ) )
+	{
+		AddTexture( Entry, Texture );
+	}
+	else if( USound* Sound = Cast<USound>( Obj ) )
+	{
+		AddSound( Entry, Sound );
+	}
+	else if( UMusic* Music = Cast<UMusic>( Obj ) )
+	{
+		// Low memory builds skip music data and stream it from disc
+		Entry.Bytes[CAT_Music][POOL_Main] += CountBytes( Music ) - Music->Data.Num();
+	}
+	else if( UMesh* Mesh = Cast<UMesh>( Obj ) )
+	{
+		// Lazy arrays come in with the first frame it's drawn
+		Mesh->Verts.Load();
+		Mesh->Tris.Load();
+		Mesh->Connects.Load();
+		Mesh->VertLinks.Load();
+		Mesh->PackedVerts.Load();
+		Entry.Bytes[CAT_Mesh][POOL_Main] += CountBytes( Mesh );
+	}
+	else if( UModel* Model = Cast<UModel>( Obj ) )
+	{
+		AddModel( Entry, Model );
+	}
+	else if( UStruct* Struct = Cast<UStruct>( Obj ) )
+	{
+		Entry.Bytes[CAT_Script][POOL_Main] += Struct->Script.Num();
+		Entry.Bytes[CAT_Object][POOL_Main] += CountBytes( Struct ) - Struct->Script.Num();
+	}
+	else
+	{
+		Entry.Bytes[CAT_Object][POOL_Main] += CountBytes( Obj );
+	}
+
+	unguard;
+}
+
+INT FMemoryReport::GetTotal( EPool Pool ) const
+{
+	INT Total = 0;
+	for( INT i = 0; i < Entries.Num(); i++ )
+		for( INT c = 0; c < CAT_MAX; c++ )
+			Total += Entries(i).Bytes[c][Pool];
+	return Total;
+}
+
+UBOOL FMemoryReport::FitsBudget() const
+{
+	for( INT p = 0; p < POOL_MAX; p++ )
+		if( GetTotal( (EPool)p ) > PoolBudget[p] )
+			return 0;
+	return 1;
+}
+
+void FMemoryReport::WriteJson( FILE* F, const char* MapName ) const
+{
+	fprintf( F, "{\n\t\"map\": \"%s\",\n\t\"fits\": %s,\n", MapName, FitsBudget() ? "true" : "false" );
+
+	fprintf( F, "\t\"pools\": [\n" );
+	for( INT p = 0; p < POOL_MAX; p++ )
+	{
+		fprintf( F, "\t\t{ \"name\": \"%s\", \"budget\": %d, \"total\": %d }%s\n",
+			PoolNames[p], PoolBudget[p], GetTotal( (EPool)p ), p < POOL_MAX - 1 ? "," : "" );
+	}
+	fprintf( F, "\t],\n" );
+
+	fprintf( F, "\t\"categories\": [\n" );
+	for( INT c = 0; c < CAT_MAX; c++ )
+	{
+		INT Totals[POOL_MAX] = { 0 };
+		for( INT i = 0; i < Entries.Num(); i++ )
+			for( INT p = 0; p < POOL_MAX; p++ )
+				Totals[p] += Entries(i).Bytes[c][p];
+		fprintf( F, "\t\t{ \"name\": \"%s\", \"main\": %d, \"video\": %d, \"sound\": %d }%s\n",
+			CategoryNames[c], Totals[POOL_Main], Totals[POOL_Video], Totals[POOL_Sound], c < CAT_MAX - 1 ? "," : "" );
+	}
+	fprintf( F, "\t],\n" );
+
+	fprintf( F, "\t\"objects\": [\n" );
+	UBOOL bFirst = 1;
+	for( INT i = 0; i < Entries.Num(); i++ )
+	{
+		const FEntry& Entry = Entries(i);
+		for( INT c = 0; c < CAT_MAX; c++ )
+		{
+			if( !Entry.Bytes[c][POOL_Main] && !Entry.Bytes[c][POOL_Video] && !Entry.Bytes[c][POOL_Sound] )
+				continue;
+			fprintf( F, "%s\t\t{ \"package\": \"%s\", \"class\": \"%s\", \"category\": \"%s\", \"count\": %d, \"main\": %d, \"video\": %d, \"sound\": %d }",
+				bFirst ? "" : ",\n", *Entry.Package, Entry.Class->GetName(), CategoryNames[c], Entry.Count,
+				Entry.Bytes[c][POOL_Main], Entry.Bytes[c][POOL_Video], Entry.Bytes[c][POOL_Sound] );
+			bFirst = 0;
+		}
+	}
+	fprintf( F, "\n\t]\n}\n" );
+}
+
+void FMemoryReport::WriteCsv( FILE* F ) const
+{
+	fprintf( F, "package,class,category,count,main,video,sound\n" );
+	for( INT i = 0; i < Entries.Num(); i++ )
+	{
+		const FEntry& Entry = Entries(i);
+		for( INT c = 0; c < CAT_MAX; c++ )
+		{
+			if( !Entry.Bytes[c][POOL_Main] && !Entry.Bytes[c][POOL_Video] && !Entry.Bytes[c][POOL_Sound] )
+				continue;
+			fprintf( F, "%s,%s,%s,%d,%d,%d,%d\n", *Entry.Package, Entry.Class->GetName(), CategoryNames[c], Entry.Count,
+				Entry.Bytes[c][POOL_Main], Entry.Bytes[c][POOL_Video], Entry.Bytes[c][POOL_Sound] );
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------------
+	ReportMapPkg: Predict the runtime memory of a map package
+-----------------------------------------------------------------------------*/
+
+UBOOL FDCUtil::ReportMapPkg( const FString& PkgPath, UPackage* Pkg, UBOOL bCsv, const char* OutPath )
+{
+	guard(ReportMapPkg);
+
+	// Loading the level pulls in everything it references, across packages
+	ULevel* Level = LoadObject<ULevel>( Pkg, "MyLevel", nullptr, LOAD_NoFail, nullptr );
+	if( !Level )
+		return 0;
+
+	UPackage* Transient = UObject::GetTransientPackage();
+	FMemoryReport Report;
+	for( TObjectIterator<UObject> It; It; ++It )
+	{
+		UObject* Outermost = GetOutermost( *It );
+		if( Outermost == Transient || Outermost->GetFName() == FName("Editor") || Outermost->GetFName() == FName("DCUtil") )
+			continue;
+		Report.AddObject( *It );
+	}
+
+	FILE* F = OutPath[0] ? fopen( OutPath, "w" ) : stdout;
+	if( !F )
+		appErrorf( "Could not open '%s' for writing", OutPath );
+	if( bCsv )
+		Report.WriteCsv( F );
+	else
+		Report.WriteJson( F, Pkg->GetName() );
+	if( F != stdout )
+	{
+		fclose( F );
+		printf( "Wrote memory report for '%s' to '%s'\n", Pkg->GetName(), OutPath );
+	}
+
+	// Keep the verdict visible even when the report itself goes to stdout
+	for( INT p = 0; p < FMemoryReport::POOL_MAX; p++ )
+	{
+		const INT Total = Report.GetTotal( (FMemoryReport::EPool)p );
+		if( Total > FMemoryReport::PoolBudget[p] )
+			fprintf( stderr, "%s: %s RAM over budget, %d of %d bytes\n", Pkg->GetName(), FMemoryReport::PoolNames[p], Total, FMemoryReport::PoolBudget[p] );
+	}
+	return Report.FitsBudget();
+
+	unguard;
+}
@@ -1,88 +1,285 @@
 #include "Sound.h"
-#include <unistd.h>
-#include <stdlib.h>
+#include "ConvertCache.h"
 
-extern CORE_API void appCreateTempFilename( const char* Path, char* Result256 );
-extern CORE_API INT appUnlink( const char* Filename );
+INT FSoundCompressor::DefaultRate = 11025;
 
-static FString CreateTempFile( const char* Ext )
+// Sounds that need more than the default rate to stay intelligible, voice
+// and announcer lines mostly. Small effects stay at DefaultRate.
+const FSoundCompressor::FRateRule FSoundCompressor::Rates[] =
 {
-	char Temp[256] = {0};
-	appCreateTempFilename( ".", Temp );
-	FString Path = Temp;
-	Path += Ext;
-	return Path;
-}
+	{ "Announcer.*",		22050 },
+	{ "BossVoice.*",		22050 },
+	{ "Female1Voice.*",		22050 },
+	{ "Female2Voice.*",		22050 },
+	{ "Male1Voice.*",		22050 },
+	{ "Male2Voice.*",		22050 },
+	{ "UnrealShare.Intro.*",	22050 },
+};
 
-static FString SaveSoundToTempWav( USound* Sound )
+namespace
 {
-	if( !Sound || Sound->Data.Num() == 0 )
-		return "";
 
-	FString TempPath = CreateTempFile( ".wav" );
-	FILE* Out = fopen( TCHAR_TO_ANSI(*TempPath), "wb" );
-	if( !Out )
-		return "";
+// Yamaha ADPCM tables, as decoded by the AICA.
+const INT AdpcmDiffLookup[16] = { 1, 3, 5, 7, 9, 11, 13, 15, -1, -3, -5, -7, -9, -11, -13, -15 };
+const INT AdpcmIndexScale[16] = { 230, 230, 230, 230, 307, 409, 512, 614, 230, 230, 230, 230, 307, 409, 512, 614 };
+const INT AdpcmMinStep = 127;
+const INT AdpcmMaxStep = 24576;
+
+// Zero crossings on each side of the resampling kernel.
+const INT ResampleZeroCrossings = 16;
 
-	fwrite( &Sound->Data(0), 1, Sound->Data.Num(), Out );
-	fclose( Out );
-	return TempPath;
+const _WORD WAVE_FORMAT_YAMAHA_ADPCM = 0x0020;
+
+inline FLOAT Sinc( FLOAT X )
+{
+	if( Abs( X ) < 1e-6f )
+		return 1.0f;
+	X *= (FLOAT)PI;
+	return appSin( X ) / X;
 }
 
-static FString RunFfmpegAdpcm( const FString& InPath )
+inline FLOAT Blackman( FLOAT X )
 {
-	FString OutPath = CreateTempFile( ".adpcm.wav" );
-	char Cmd[1024];
-	appSprintf( Cmd, "ffmpeg -y -i \"%s\" -ac 1 -ar 11025 -f wav -acodec adpcm_yamaha \"%s\"", *InPath, *OutPath );
-	if( system( Cmd ) != 0 )
-		return "";
-	return OutPath;
+	// X in [-1,1]
+	const FLOAT T = (FLOAT)PI * ( X + 1.0f );
+	return 0.42f - 0.5f * appCos( T ) + 0.08f * appCos( 2.0f * T );
 }
 
-static UBOOL LoadAdpcmBack( USound* Sound, const FString& AdpcmPath )
+} // namespace
+
+//
+// Pick the output rate for a sound from the rule table. Main thread only,
+// it needs GetPathName.
+//
+INT FSoundCompressor::GetTargetRate( USound* Sound )
 {
-	FILE* In = fopen( TCHAR_TO_ANSI(*AdpcmPath), "rb" );
-	if( !In )
-		return 0;
-	fseek( In, 0, SEEK_END );
-	INT Size = ftell( In );
-	fseek( In, 0, SEEK_SET );
-	TArray<BYTE> Data;
-	Data.Add( Size );
-	if( fread( &Data(0), 1, Size, In ) != (size_t)Size )
+	const char* PathName = Sound->GetPathName();
+	for( INT i = 0; i < (INT)ARRAY_COUNT( Rates ); ++i )
 	{
-		fclose( In );
-		return 0;
+		char TempStr[1024];
+		appStrncpy( TempStr, Rates[i].Pattern, sizeof( TempStr ) );
+		char* Glob = appStrchr( TempStr, '*' );
+		if( Glob )
+		{
+			*Glob = 0;
+			if( appStrstr( PathName, TempStr ) == PathName )
+				return Rates[i].Rate;
+		}
+		else if( !appStricmp( PathName, TempStr ) )
+		{
+			return Rates[i].Rate;
+		}
 	}
-	fclose( In );
-
-	Sound->Data.Empty();
-	Sound->Data.Add( Data.Num() );
-	appMemcpy( &Sound->Data(0), &Data(0), Data.Num() );
-	Sound->FileType = FName("WAV");
-	Sound->OriginalSize = Sound->Data.Num();
-	Sound->Handle = nullptr;
-	return 1;
+	return DefaultRate;
 }
 
-UBOOL FSoundCompressor::CompressUSound( USound* Sound )
+//
+// Create a compression job for a sound. Only the source bytes are copied here,
+// decoding, resampling and encoding are left to Encode().
+//
+FSoundCompressor* FSoundCompressor::CompressUSound( USound* Sound )
 {
 	if( !Sound || Sound->Data.Num() == 0 )
-		return 0;
+		return nullptr;
+
+	return new FSoundCompressor( Sound, GetTargetRate( Sound ) );
+}
 
-	const FString Wav = SaveSoundToTempWav( Sound );
-	if( !appStrlen( *Wav ) )
+FSoundCompressor::FSoundCompressor( USound* InSound, INT InTargetRate )
+:	Sound( InSound )
+,	TargetRate( InTargetRate )
+,	Source( InSound->Data )
+{
+	OldSize = Source.Num();
+}
+
+//
+// Decode 8 or 16-bit PCM into mono floats in 16-bit sample range.
+// Anything else, including already compressed data, is rejected.
+//
+UBOOL FSoundCompressor::DecodeWav( TArray<BYTE>& Wav, TArray<FLOAT>& OutSamples, INT& OutRate )
+{
+	FWaveModInfo WaveInfo;
+	if( !WaveInfo.ReadWaveInfo( Wav ) )
 		return 0;
-	const FString Adpcm = RunFfmpegAdpcm( Wav );
-	if( !appStrlen( *Adpcm ) )
+
+	const INT Bits = *WaveInfo.pBitsPerSample;
+	const INT Channels = *WaveInfo.pChannels;
+	if( ( Bits != 8 && Bits != 16 ) || Channels < 1 )
 		return 0;
-	const UBOOL Result = LoadAdpcmBack( Sound, Adpcm );
-	if( Result )
+
+	const INT Frames = WaveInfo.SampleDataSize / ( Channels * Bits / 8 );
+	OutRate = *WaveInfo.pSamplesPerSec;
+	OutSamples.Empty( Frames );
+	OutSamples.Add( Frames );
+	for( INT i = 0; i < Frames; ++i )
+	{
+		FLOAT Sum = 0.0f;
+		for( INT c = 0; c < Channels; ++c )
+		{
+			if( Bits == 16 )
+			{
+				const BYTE* P = WaveInfo.SampleDataStart + ( i * Channels + c ) * 2;
+				Sum += (SWORD)( P[0] | ( P[1] << 8 ) );
+			}
+			else
+			{
+				Sum += ( (INT)WaveInfo.SampleDataStart[i * Channels + c] - 128 ) * 256;
+			}
+		}
+		OutSamples(i) = Sum / Channels;
+	}
+	return OutRate > 0 && Frames > 0;
+}
+
+//
+// Band-limited resampling with a Blackman-windowed sinc, cut off below the
+// lower of the two Nyquist frequencies.
+//
+void FSoundCompressor::Resample( const TArray<FLOAT>& In, INT InRate, TArray<FLOAT>& Out, INT OutRate )
+{
+	if( InRate == OutRate )
+	{
+		Out = In;
+		return;
+	}
+
+	const DOUBLE Step = (DOUBLE)InRate / OutRate;
+	const FLOAT Cutoff = 0.95f * Min( 1.0f, (FLOAT)OutRate / InRate );
+	const INT HalfWidth = (INT)appCeil( ResampleZeroCrossings / Cutoff );
+	const INT NumOut = (INT)( (QWORD)In.Num() * OutRate / InRate );
+
+	Out.Empty( NumOut );
+	Out.Add( NumOut );
+	for( INT i = 0; i < NumOut; ++i )
+	{
+		const DOUBLE Center = i * Step;
+		const INT First = Max( 0, (INT)appFloor( Center ) - HalfWidth + 1 );
+		const INT Last = Min( In.Num() - 1, (INT)appFloor( Center ) + HalfWidth );
+		FLOAT Sum = 0.0f, WeightSum = 0.0f;
+		for( INT j = First; j <= Last; ++j )
+		{
+			const FLOAT X = (FLOAT)( j - Center );
+			const FLOAT W = Cutoff * Sinc( Cutoff * X ) * Blackman( X / HalfWidth );
+			Sum += In(j) * W;
+			WeightSum += W;
+		}
+		Out(i) = WeightSum > SMALL_NUMBER ? Sum / WeightSum : 0.0f;
+	}
+}
+
+//
+// Encode to 4-bit Yamaha ADPCM, two samples per byte, first sample in the low
+// nibble. Each sample takes the code that lands the decoder closest to it.
+//
+void FSoundCompressor::EncodeAdpcm( const TArray<FLOAT>& Samples, TArray<BYTE>& OutData )
+{
+	const INT NumBytes = ( Samples.Num() + 1 ) / 2;
+	OutData.Empty( NumBytes );
+	OutData.AddZeroed( NumBytes );
+
+	INT Predictor = 0;
+	INT StepSize = AdpcmMinStep;
+	for( INT i = 0; i < NumBytes * 2; ++i )
 	{
-		Sound->OriginalSize = Sound->Data.Num();
+		const INT Sample = i < Samples.Num() ? Clamp( appRound( Samples(i) ), -32768, 32767 ) : 0;
+		const INT Sign = Sample < Predictor ? 8 : 0;
+
+		INT BestNibble = Sign, BestPredictor = Predictor, BestError = MAXINT;
+		for( INT Magnitude = 0; Magnitude < 8; ++Magnitude )
+		{
+			const INT Nibble = Sign | Magnitude;
+			const INT NewPredictor = Clamp( Predictor + StepSize * AdpcmDiffLookup[Nibble] / 8, -32768, 32767 );
+			const INT Error = Abs( Sample - NewPredictor );
+			if( Error < BestError )
+			{
+				BestNibble = Nibble;
+				BestPredictor = NewPredictor;
+				BestError = Error;
+			}
+		}
+
+		Predictor = BestPredictor;
+		StepSize = Clamp( ( StepSize * AdpcmIndexScale[BestNibble] ) >> 8, AdpcmMinStep, AdpcmMaxStep );
+		OutData(i / 2) |= BestNibble << ( ( i & 1 ) * 4 );
 	}
-	unlink( *Wav );
-	unlink( *Adpcm );
-	return Result;
 }
 
+//
+// Wrap the ADPCM data in a minimal mono RIFF/WAVE file for FWaveModInfo.
+//
+void FSoundCompressor::WriteAdpcmWav( const TArray<BYTE>& AdpcmData, INT Rate, TArray<BYTE>& OutWav )
+{
+	// WAVEFORMATEX without the struct padding
+	const DWORD FmtLen = 18;
+	const DWORD DataLen = AdpcmData.Num();
+	const DWORD PaddedDataLen = ( DataLen + 1 ) & ~1;
+
+	DWORD RiffID = mmioFOURCC('R','I','F','F'), WaveID = mmioFOURCC('W','A','V','E');
+	DWORD FmtID = mmioFOURCC('f','m','t',' '), DataID = mmioFOURCC('d','a','t','a');
+	DWORD RiffLen = 4 + 8 + FmtLen + 8 + PaddedDataLen, FmtChunkLen = FmtLen, DataChunkLen = DataLen;
+	_WORD FormatTag = WAVE_FORMAT_YAMAHA_ADPCM, Channels = 1, BlockAlign = 1, BitsPerSample = 4, ExtraSize = 0;
+	DWORD SamplesPerSec = Rate, AvgBytesPerSec = Rate / 2;
+
+	OutWav.Empty( 8 + RiffLen );
+	FBufferWriter Ar( OutWav );
+	Ar << RiffID << RiffLen << WaveID;
+	Ar << FmtID << FmtChunkLen;
+	Ar << FormatTag << Channels << SamplesPerSec << AvgBytesPerSec << BlockAlign << BitsPerSample << ExtraSize;
+	Ar << DataID << DataChunkLen;
+	if( DataLen )
+		Ar.Serialize( (void*)&AdpcmData(0), DataLen );
+	if( PaddedDataLen != DataLen )
+	{
+		BYTE Pad = 0;
+		Ar << Pad;
+	}
+}
+
+void FSoundCompressor::Encode()
+{
+	FConvertKey Key( "SND", Version );
+	Key.Update( &TargetRate, sizeof(TargetRate) );
+	Key.Update( Source );
+	if( FConvertCache::Load( Key.Get(), Compressed ) )
+	{
+		bCacheHit = 1;
+		return;
+	}
+
+	TArray<FLOAT> Samples;
+	INT SourceRate = 0;
+	if( !DecodeWav( Source, Samples, SourceRate ) )
+		return;
+
+	// Never resample up, it only costs memory
+	const INT Rate = Min( TargetRate, SourceRate );
+	TArray<FLOAT> Resampled;
+	Resample( Samples, SourceRate, Resampled, Rate );
+	if( Resampled.Num() == 0 )
+		return;
+
+	TArray<BYTE> AdpcmData;
+	EncodeAdpcm( Resampled, AdpcmData );
+	WriteAdpcmWav( AdpcmData, Rate, Compressed );
+
+	FConvertCache::Store( Key.Get(), Compressed );
+}
+
+UBOOL FSoundCompressor::Commit()
+{
+	if( Compressed.Num() == 0 )
+	{
+		NewSize = OldSize;
+		return 0;
+	}
+
+	ExchangeArray( Sound->Data, Compressed );
+	Sound->FileType = FName("WAV");
+	Sound->OriginalSize = Sound->Data.Num();
+	Sound->Handle = nullptr;
+
+	NewSize = Sound->Data.Num();
+	printf( "- Compressed '%s' (%u -> %u bytes)\n", Sound->GetName(), OldSize, NewSize );
+	return 1;
+}
@@ -1,7 +1,7 @@
 #include "Texture.h"
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include "stb_image_write.h"
-#include <stdlib.h>
+#include "PvrTex.h"
+#include "ConvertCache.h"
+#include "TextureUsage.h"
 
 // Log two function.
 static BYTE FLogTwo( INT V ) { BYTE R=0; while(V>1) { V>>=1; R++; } return R; }
@@ -24,39 +24,6 @@ static INT GColorBytes( ETextureFormat Fmt )
 	}
 }
 
-// HACK: It isn't possible to reliably determine which textures are referenced by fx
-// without loading all packages, which I can't be arsed to do, so
-const char* FTextureConverter::Blacklist[] =
-{
-	"DecayedS.Deco.Window",
-	"DecayedS.Light.dlaser1",
-	"DecayedS.Light.dlaser2",
-	"DecayedS.Floor.Aisle",
-	"Detail.paint2",
-	"genfluid.Water.*",
-	"genfluid.lava",
-	"genfluid.Lava1",
-	"genfluid.Lava2",
-	"genfluid.Lava2a",
-	"genfluid.Lava2b",
-	"genfluid.lava.*",
-	"genfluid.dnitro7",
-	"genfluid.Sky.gmist2",
-	"genfluid.Sky.gmist3",
-	"genfluid.Sky.BlueSky",
-	"GenFX.Gradient.L2",
-	"GenIn.Crystals.Cryst2",
-	"GenWarp.Sun128a",
-	"GenWarp.hullgry5",
-	"GenWarp.Disp11",
-	"GenWarp.glob128c",
-	"GenWarp.gw_rusty",
-	"GenWarp.gw_calcium",
-	"GenWarp.gw_algae",
-	"HubEffects.Lavab",
-	"UnrealI.MenuGfx.*"
-};
-
 namespace
 {
 
@@ -139,17 +106,32 @@ static void FlattenTextureToSolidWhiteInternal( UTexture* Texture )
 
 }
 
-UBOOL FTextureConverter::AutoConvertTexture( UTexture* InTexture )
+//
+// Whether AutoConvertTexture would make a job for a texture.
+//
+UBOOL FTextureConverter::ShouldConvert( UTexture* InTexture )
 {
-	verify( InTexture );
-
 	// Don't touch realtime textures
 	if( InTexture->bRealtime || InTexture->bParametric )
-		return false;
+		return 0;
 
 	// Don't touch textures that are very small
 	if( GColorBytes( (ETextureFormat)InTexture->Format ) * InTexture->USize * InTexture->VSize < 2300 )
-		return false;
+		return 0;
+
+	return 1;
+}
+
+//
+// Create a conversion job for a texture, or return null if it should be left alone.
+// The job has already done all its UObject work; only Encode() is left for a worker.
+//
+FTextureConverter* FTextureConverter::AutoConvertTexture( UTexture* InTexture )
+{
+	verify( InTexture );
+
+	if( !ShouldConvert( InTexture ) )
+		return nullptr;
 
 	ETextureFormat TargetFormat;
 	if( InTexture->Format == TEXF_P8 && InTexture->Palette )
@@ -157,10 +139,10 @@ UBOOL FTextureConverter::AutoConvertTexture( UTexture* InTexture )
 	else
 		TargetFormat = (ETextureFormat)InTexture->Format; // TODO: figure out what to do with lightmaps (they are combined at runtime)
 
-	FTextureConverter TexCvt( InTexture, TargetFormat );
-	TexCvt.Convert();
+	FTextureConverter* TexCvt = new FTextureConverter( InTexture, TargetFormat );
+	TexCvt->Prepare();
 
-	return true;
+	return TexCvt;
 }
 
 FTextureConverter::FTextureConverter( UTexture* InTexture, const ETextureFormat InFormat )
@@ -171,20 +153,24 @@ FTextureConverter::FTextureConverter( UTexture* InTexture, const ETextureFormat
 	verify( InTexture->Mips.Num() );
 
 	Texture = InTexture;
+	OldFormat = Texture->Format;
 	DstFormat = InFormat;
 	DstColorBytes = GColorBytes( InFormat );
 	SrcColorBytes = GColorBytes( (ETextureFormat)Texture->Format );
 	USize = Max( MinTexSize, Texture->USize );
 	VSize = Max( MinTexSize, Texture->VSize );
+
+	for( INT i = 0; i < Texture->Mips.Num(); ++i )
+		OldSize += Texture->Mips(i).DataArray.Num();
 }
 
-void FTextureConverter::Convert()
+void FTextureConverter::Prepare()
 {
-	// First, cut off the first N mip levels if needed
-	INT RealDropMips = Min( DropMips, Texture->Mips.Num() - 1 );
+	// First, cut off the first N mip levels if needed, more if it's never drawn at full detail
+	INT RealDropMips = Min( DropMips + FTextureUsage::GetLowLODDrop( Texture ), Texture->Mips.Num() - 1 );
 	if( RealDropMips > 0 )
 	{
-		INT DroppedSize = Max( USize >> DropMips, VSize >> DropMips );
+		INT DroppedSize = Max( USize >> RealDropMips, VSize >> RealDropMips );
 		while( DroppedSize > 1 && DroppedSize > MaxTexSize && RealDropMips < Texture->Mips.Num() - 1 )
 		{
 			RealDropMips++;
@@ -215,66 +201,129 @@ void FTextureConverter::Convert()
 	if( DstFormat == Texture->Format )
 		return;
 
-	// Do not convert format if texture is blacklisted
-	for( INT i = 0; i < ARRAY_COUNT( Blacklist ); ++i )
+	// Realtime textures and fonts read their sources as they are
+	if( FTextureUsage::IsEffectTarget( Texture ) )
+		return;
+
+	if( !FPvrTexEncoder::IsPvrFormat( DstFormat ) )
+		appErrorf( "Can't encode format %d", DstFormat );
+
+	// Decode here, the encoding itself is left to Encode()
+	MipWork.AddZeroed( Texture->Mips.Num() );
+	for( INT i = 0; i < Texture->Mips.Num(); ++i )
 	{
-		char TempStr[1024];
-		appStrncpy( TempStr, Blacklist[i], sizeof( TempStr ) );
-		char* Glob = appStrchr( TempStr, '*' );
-		if( Glob )
-		{
-			*Glob = 0;
-			if( appStrstr( Texture->GetPathName(), TempStr ) )
-				return;
-		}
-		else if ( !appStricmp( Texture->GetPathName(), TempStr ) )
-		{
-			return;
-		}
+		const FMipmap& Mip = Texture->Mips(i);
+		DecodeMip( Mip, MipWork(i).Pixels );
+		MipWork(i).USize = Mip.USize;
+		MipWork(i).VSize = Mip.VSize;
 	}
+}
 
-	// Convert and scale if needed
-	for( INT i = 0; i < Texture->Mips.Num(); ++i )
+void FTextureConverter::Encode()
+{
+	if( MipWork.Num() == 0 )
+		return;
+
+	FConvertKey Key( "TEX", FPvrTexEncoder::Version );
+	Key.Update( &DstFormat, sizeof(DstFormat) );
+	for( INT i = 0; i < MipWork.Num(); ++i )
+	{
+		Key.Update( &MipWork(i).USize, sizeof(INT) );
+		Key.Update( &MipWork(i).VSize, sizeof(INT) );
+		Key.Update( MipWork(i).Pixels );
+	}
+
+	TArray<BYTE> Payload;
+	if( FConvertCache::Load( Key.Get(), Payload ) )
 	{
-		FMipmap& Mip = Texture->Mips(i);
-		ExportMip( Mip, TempPngFile );
-		ConvertMip( Mip, TempPngFile );
+		FBufferReader Ar( Payload );
+		for( INT i = 0; i < MipWork.Num(); ++i )
+		{
+			Ar << MipWork(i).USize << MipWork(i).VSize << MipWork(i).Encoded;
+			MipWork(i).Pixels.Empty();
+		}
+		bCacheHit = 1;
+		return;
 	}
 
-	// Strip off palette, if there was any and it was from the same package
-	if( Texture->Palette && Texture->GetOuter() == Texture->Palette->GetOuter() )
-		Texture->Palette = nullptr;
+	for( INT i = 0; i < MipWork.Num(); ++i )
+		EncodeMip( MipWork(i), DstFormat );
 
-	// Update texture size in case mip 0 was upscaled
-	const FMipmap& Mip = Texture->Mips(0);
-	if( Texture->USize != Mip.USize )
+	if( FConvertCache::IsEnabled() )
 	{
-		Texture->USize = Mip.USize;
-		Texture->UBits = Mip.UBits;
-		USize = Mip.USize;
+		FBufferWriter Ar( Payload );
+		for( INT i = 0; i < MipWork.Num(); ++i )
+			Ar << MipWork(i).USize << MipWork(i).VSize << MipWork(i).Encoded;
+		FConvertCache::Store( Key.Get(), Payload );
 	}
-	if( Texture->VSize != Mip.VSize )
+}
+
+UBOOL FTextureConverter::Commit()
+{
+	if( MipWork.Num() )
 	{
-		Texture->VSize = Mip.VSize;
-		Texture->VBits = Mip.VBits;
-		VSize = Mip.VSize;
+		for( INT i = 0; i < MipWork.Num(); ++i )
+		{
+			FMipmap& Mip = Texture->Mips(i);
+			FMipWork& Work = MipWork(i);
+			ExchangeArray( Mip.DataArray, Work.Encoded );
+			if( Mip.USize != Work.USize )
+			{
+				Mip.USize = Work.USize;
+				Mip.UBits = FLogTwo(Work.USize);
+			}
+			if( Mip.VSize != Work.VSize )
+			{
+				Mip.VSize = Work.VSize;
+				Mip.VBits = FLogTwo(Work.VSize);
+			}
+		}
+
+		// Strip off palette, if there was any and it was from the same package
+		if( Texture->Palette && Texture->GetOuter() == Texture->Palette->GetOuter() )
+			Texture->Palette = nullptr;
+
+		// Update texture size in case mip 0 was upscaled
+		const FMipmap& Mip = Texture->Mips(0);
+		if( Texture->USize != Mip.USize )
+		{
+			Texture->USize = Mip.USize;
+			Texture->UBits = Mip.UBits;
+			USize = Mip.USize;
+		}
+		if( Texture->VSize != Mip.VSize )
+		{
+			Texture->VSize = Mip.VSize;
+			Texture->VBits = Mip.VBits;
+			VSize = Mip.VSize;
+		}
+
+		Texture->Format = DstFormat;
 	}
 
-	Texture->Format = DstFormat;
+	NewSize = 0;
+	for( INT i = 0; i < Texture->Mips.Num(); ++i )
+		NewSize += Texture->Mips(i).DataArray.Num();
+	if( OldFormat != Texture->Format )
+		printf( "- Converted '%s' from %d to %d (%d -> %d bytes)\n", Texture->GetName(), OldFormat, Texture->Format, OldSize, NewSize );
+	else
+		printf( "- Converted '%s' (%d -> %d bytes)\n", Texture->GetName(), OldSize, NewSize );
+
+	return true;
 }
 
-void FTextureConverter::ExportMip( const FMipmap& Mip, const char *Filename )
+void FTextureConverter::DecodeMip( const FMipmap& Mip, TArray<FColor>& OutPixels )
 {
 	// Convert to RGBA8888
-	FColor* OutData = new FColor[ Mip.USize * Mip.VSize ];
-	verify( OutData );
+	const DWORD SrcCount = Mip.USize * Mip.VSize;
+	OutPixels.Empty( SrcCount );
+	OutPixels.Add( SrcCount );
 
 	if( Texture->Format == TEXF_P8 )
 	{
 		const FColor* Palette = &Texture->Palette->Colors(0);
-		const DWORD SrcCount = Mip.USize * Mip.VSize;
 		const BYTE* Src = &Mip.DataArray(0);
-		FColor* Dst = OutData;
+		FColor* Dst = &OutPixels(0);
 		for( DWORD i = 0; i < SrcCount; ++i, ++Src, ++Dst )
 		{
 			*Dst = Palette[*Src];
@@ -283,9 +332,8 @@ void FTextureConverter::ExportMip( const FMipmap& Mip, const char *Filename )
 	}
 	else if( Texture->Format == TEXF_RGBA8 )
 	{
-		const DWORD SrcCount = Mip.USize * Mip.VSize;
 		const FColor* Src = (const FColor*)&Mip.DataArray(0);
-		FColor* Dst = OutData;
+		FColor* Dst = &OutPixels(0);
 		for( DWORD i = 0; i < SrcCount; ++i, ++Src, ++Dst )
 		{
 			Dst->R = Src->R << 1;
@@ -296,93 +344,28 @@ void FTextureConverter::ExportMip( const FMipmap& Mip, const char *Filename )
 	}
 	else
 	{
-		appErrorf( "Can't export format %d", Texture->Format );
+		appErrorf( "Can't decode format %d", Texture->Format );
 	}
-
-	stbi_write_png( Filename, Mip.USize, Mip.VSize, 4, (const void*)OutData, Mip.USize * 4 );
-
-	delete OutData;
 }
 
-void FTextureConverter::ConvertMip( FMipmap &Mip, const char* Filename )
+void FTextureConverter::EncodeMip( FMipWork& Work, ETextureFormat Format )
 {
-	// get dest format name
-	const char* FormatArgs;
-	switch( DstFormat )
-	{
-		case TEXF_EXT_ARGB1555_TWID: FormatArgs = "-f ARGB1555"; break;
-		case TEXF_EXT_ARGB1555_VQ: FormatArgs = "-f ARGB1555 -c"; break;
-		case TEXF_EXT_RGB565_TWID: FormatArgs = "-f RGB565"; break;
-		case TEXF_EXT_RGB565_VQ: FormatArgs = "-f RGB565 -c"; break;
-		default:
-			appErrorf( "Can't use pvrtex for format %d", DstFormat );
-	}
-
-	// pvrtex is only available in executable form, so fuck it
-	const char* PvrtexPath = "pvrtex";
-
-	char Command[2048];
-#ifdef PLATFORM_WIN32
-	snprintf( Command, sizeof( Command ), "%s -i %s -o %s -r NEAR %s > NUL 2>&1", PvrtexPath, Filename, TempPvrFile, FormatArgs );
-#else
-	if( const char* KosBase = getenv( "KOS_BASE" ) )
-	{
-		snprintf( Command, sizeof( Command ), "%s/utils/pvrtex/pvrtex -i %s -o %s -r NEAR %s > /dev/null 2>&1", KosBase, Filename, TempPvrFile, FormatArgs );
-	}
-	else
+	// PVR can't sample anything smaller than MinTexSize, so upscale with nearest filtering
+	const INT NewUSize = Max<INT>( MinTexSize, Work.USize );
+	const INT NewVSize = Max<INT>( MinTexSize, Work.VSize );
+	if( NewUSize != Work.USize || NewVSize != Work.VSize )
 	{
-		snprintf( Command, sizeof( Command ), "%s -i %s -o %s -r NEAR %s > /dev/null 2>&1", PvrtexPath, Filename, TempPvrFile, FormatArgs );
-	}
-#endif
-	const INT Ret = system( Command );
-	if( Ret != 0 )
-		appErrorf( "pvrtex returned %d maybe KOS_BASE isn't set, source environ.sh", Ret );
-
-	// load dt file
-	FILE* f = fopen( TempPvrFile, "rb" );
-	verify( f );
-
-	DWORD Skip = 0;
-	DWORD Size = 0;
-
-	fread( &Skip, 4, 1, f ); // FourCC
-
-	fread( &Size, 4, 1, f ); // Size
-	verify( Size > 32 )
-;
-	fread( &Skip, 1, 1, f ); // Version
-	fread( &Skip, 1, 1, f ); // Header size
-	fread( &Skip, 1, 1, f ); // Codebook size
-	fread( &Skip, 1, 1, f ); // Palette size
-
-	_WORD NewUSize = 0;
-	_WORD NewVSize = 0;
-	DWORD TexType = 0;
-	fread( &NewUSize, 2, 1, f );
-	fread( &NewVSize, 2, 1, f );
-	fread( &TexType, 4, 1, f );
-
-	fread( &Skip, 4, 1, f );
-	fread( &Skip, 4, 1, f );
-	fread( &Skip, 4, 1, f );
-
-	Size -= 32;
-	Mip.DataArray.Add( Size );
-	fread( &Mip.DataArray(0), 1, Size, f );
-
-	fclose( f );
-
-	if( NewUSize != Mip.USize )
-	{
-		Mip.USize = NewUSize;
-		Mip.UBits = FLogTwo(NewUSize);
+		TArray<FColor> Scaled( NewUSize * NewVSize );
+		for( INT V = 0; V < NewVSize; ++V )
+			for( INT U = 0; U < NewUSize; ++U )
+				Scaled( V * NewUSize + U ) = Work.Pixels( ( V * Work.VSize / NewVSize ) * Work.USize + U * Work.USize / NewUSize );
+		ExchangeArray( Work.Pixels, Scaled );
+		Work.USize = NewUSize;
+		Work.VSize = NewVSize;
 	}
 
-	if( NewVSize != Mip.VSize )
-	{
-		Mip.VSize = NewVSize;
-		Mip.VBits = FLogTwo(NewVSize);
-	}
+	FPvrTexEncoder::Encode( &Work.Pixels(0), Work.USize, Work.VSize, Format, Work.Encoded );
+	Work.Pixels.Empty();
 }
 
 UBOOL FTextureConverter::ShouldFlattenTexture( UTexture* Tex )
@@ -0,0 +1,337 @@
+/*=============================================================================
+	TextureUsage.cpp: DCUtil texture usage analysis
+
+	Loads every map and script package once and walks the object reference
+	graph to find which textures the game can actually reach, which ones are
+	read by realtime textures and fonts and so must keep their format, and
+	which ones are only ever drawn on meshes at a reduced texture LOD.
+=============================================================================*/
+
+#include "TextureUsage.h"
+#include "Texture.h"
+
+UBOOL FTextureUsage::bBuilt = 0;
+UBOOL FTextureUsage::bDropUnused = 0;
+TMap<UTexture*,FTextureUsage::FInfo> FTextureUsage::Infos;
+TMap<UPackage*,INT> FTextureUsage::UsedPackages;
+TMap<FName,INT> FTextureUsage::NamedPackages;
+
+// Never drop more than this many mips for low LOD use.
+static const INT MaxLowLODDrop = 3;
+
+//
+// Archive collecting every object reference an object holds, the same way
+// garbage collection sees them.
+//
+class FArchiveCollectRefs : public FArchive
+{
+public:
+	FArchiveCollectRefs( UObject* Src, TArray<UObject*>& InRefs )
+	:	Refs( InRefs )
+	{
+		Src->Serialize( *this );
+	}
+	FArchive& operator<<( UObject*& Obj )
+	{
+		if( Obj )
+			Refs.AddItem( Obj );
+		return *this;
+	}
+	TArray<UObject*>& Refs;
+};
+
+static UPackage* GetTopPackage( UObject* Obj )
+{
+	while( Obj->GetOuter() )
+		Obj = Obj->GetOuter();
+	return Cast<UPackage>( Obj );
+}
+
+static void FindPackageFiles( const char* Glob, TArray<FString>& OutPaths )
+{
+	char Path[2048];
+	appStrncpy( Path, Glob, sizeof( Path ) );
+	if( char* Star = appStrchr( Path, '*' ) )
+	{
+		TArray<FString> Files = appFindFiles( Path );
+		*Star = 0;
+		for( INT i = 0; i < Files.Num(); ++i )
+			new( OutPaths )FString( FString( Path ) + Files(i) );
+	}
+	else
+	{
+		new( OutPaths )FString( Path );
+	}
+}
+
+//
+// Mips a mesh texture slot never samples. TextureLOD is the texel density the
+// editor measured for the slot relative to a full resolution skin, so a slot
+// at 0.5 never needs the top mip.
+//
+INT FTextureUsage::GetSlotDrop( UMesh* Mesh, INT Slot )
+{
+	if( Slot >= Mesh->TextureLOD.Num() || Mesh->TextureLOD(Slot) <= 0.0f )
+		return 0;
+	FLOAT Scale = Mesh->TextureLOD(Slot);
+	INT Drop = 0;
+	while( Scale * 2.0f <= 1.0f && Drop < MaxLowLODDrop )
+	{
+		Scale *= 2.0f;
+		Drop++;
+	}
+	return Drop;
+}
+
+//
+// Mips an actor's skin never samples, or 0 if the texture isn't one of its
+// skins. Skin covers every slot of the mesh, MultiSkins one slot each.
+//
+INT FTextureUsage::GetSkinDrop( AActor* Actor, UTexture* Texture )
+{
+	UMesh* Mesh = Actor->Mesh;
+	if( !Mesh )
+		return 0;
+
+	INT Drop = MAXINT;
+	if( Actor->Skin == Texture )
+		for( INT i = 0; i < Max( 1, Mesh->TextureLOD.Num() ); ++i )
+			Drop = Min( Drop, GetSlotDrop( Mesh, i ) );
+	for( INT i = 0; i < (INT)ARRAY_COUNT( Actor->MultiSkins ); ++i )
+		if( Actor->MultiSkins[i] == Texture )
+			Drop = Min( Drop, GetSlotDrop( Mesh, i ) );
+	return Drop != MAXINT ? Drop : 0;
+}
+
+void FTextureUsage::AddUse( UTexture* Texture, DWORD Flags, INT Drop )
+{
+	FInfo* Info = Infos.Find( Texture );
+	if( !Info )
+	{
+		FInfo NewInfo = { 0, MAXINT };
+		Info = &Infos.Set( Texture, NewInfo );
+	}
+	Info->Flags |= Flags;
+	Info->Drop = Min( Info->Drop, Drop );
+}
+
+//
+// Load everything the game can start from: each map's level, each class in
+// the script packages, and textures listed in the .int registry, which are
+// only ever loaded by name. Packages with registry entries are remembered,
+// since script builds names of their other textures at runtime.
+//
+void FTextureUsage::LoadRoots( const char* MapGlob, const char* ScriptGlob, TArray<UObject*>& Roots )
+{
+	guard(FTextureUsage::LoadRoots);
+
+	TArray<FString> Paths;
+	FindPackageFiles( MapGlob, Paths );
+	for( INT i = 0; i < Paths.Num(); ++i )
+	{
+		UObject* Pkg = UObject::LoadPackage( nullptr, *Paths(i), LOAD_NoWarn );
+		if( ULevel* Level = Pkg ? LoadObject<ULevel>( Pkg, "MyLevel", nullptr, LOAD_NoWarn, nullptr ) : nullptr )
+			Roots.AddItem( Level );
+		else
+			printf( "  WARNING: Could not load a level from '%s'\n", *Paths(i) );
+	}
+
+	Paths.Empty();
+	FindPackageFiles( ScriptGlob, Paths );
+	for( INT i = 0; i < Paths.Num(); ++i )
+	{
+		UObject* Pkg = UObject::LoadPackage( nullptr, *Paths(i), LOAD_NoWarn );
+		if( !Pkg )
+			continue;
+		for( TObjectIterator<UClass> It; It; ++It )
+			if( It->IsIn( Pkg ) )
+				Roots.AddItem( *It );
+	}
+
+	TArray<FRegistryObjectInfo> Registry;
+	UObject::GetRegistryObjects( Registry, UTexture::StaticClass(), nullptr, 0 );
+	for( INT i = 0; i < Registry.Num(); ++i )
+	{
+		// Skin packages: SetMultiSkin and friends load faces and parts by constructed name
+		char PkgName[NAME_SIZE];
+		appStrncpy( PkgName, *Registry(i).Object, ARRAY_COUNT( PkgName ) );
+		if( char* Dot = appStrchr( PkgName, '.' ) )
+			*Dot = 0;
+		NamedPackages.Set( FName( PkgName ), 1 );
+
+		if( UObject* Obj = UObject::StaticLoadObject( UTexture::StaticClass(), nullptr, *Registry(i).Object, nullptr, LOAD_NoWarn | LOAD_Quiet, nullptr ) )
+			Roots.AddItem( Obj );
+	}
+
+	unguard;
+}
+
+void FTextureUsage::Build( const char* MapGlob, const char* ScriptGlob )
+{
+	guard(FTextureUsage::Build);
+
+	printf( "Analyzing texture usage in '%s' and '%s'\n", MapGlob, ScriptGlob );
+
+	TArray<UObject*> Pending;
+	LoadRoots( MapGlob, ScriptGlob, Pending );
+
+	TMap<UObject*,INT> Visited;
+	for( INT i = 0; i < Pending.Num(); ++i )
+	{
+		Visited.Set( Pending(i), 1 );
+		if( UTexture* Texture = Cast<UTexture>( Pending(i) ) )
+			AddUse( Texture, USAGE_Used, 0 );
+	}
+
+	// Animation frames are drawn at whatever LOD the first frame is, settled below
+	TArray<UTexture*> AnimEdges;
+
+	while( Pending.Num() )
+	{
+		UObject* Obj = Pending.Pop();
+		TArray<UObject*> Refs;
+		FArchiveCollectRefs Collect( Obj, Refs );
+
+		UTexture* ObjTexture = Cast<UTexture>( Obj );
+		UMesh* ObjMesh = Cast<UMesh>( Obj );
+		AActor* ObjActor = Cast<AActor>( Obj );
+		UClass* ObjClass = Cast<UClass>( Obj );
+		if( ObjClass && ObjClass->IsChildOf( AActor::StaticClass() ) && ObjClass->Defaults.Num() )
+			ObjActor = ObjClass->GetDefaultActor();
+
+		for( INT i = 0; i < Refs.Num(); ++i )
+		{
+			UObject* Ref = Refs(i);
+			UTexture* Texture = Cast<UTexture>( Ref );
+
+			// Bump and detail maps are stripped from everything that gets converted
+			if( Texture && ObjTexture && FTextureConverter::ShouldConvert( ObjTexture )
+			&&	( Texture == ObjTexture->BumpMap || Texture == ObjTexture->DetailTexture ) )
+				continue;
+
+			if( !Visited.Find( Ref ) )
+			{
+				Visited.Set( Ref, 1 );
+				Pending.AddItem( Ref );
+			}
+			if( !Texture )
+				continue;
+
+			INT Drop = 0;
+			if( ObjMesh )
+			{
+				Drop = MAXINT;
+				for( INT j = 0; j < ObjMesh->Textures.Num(); ++j )
+					if( ObjMesh->Textures(j) == Texture )
+						Drop = Min( Drop, GetSlotDrop( ObjMesh, j ) );
+				if( Drop == MAXINT )
+					Drop = 0;
+			}
+			else if( ObjActor )
+			{
+				Drop = GetSkinDrop( ObjActor, Texture );
+			}
+			else if( ObjTexture && Texture == ObjTexture->AnimNext )
+			{
+				AnimEdges.AddItem( ObjTexture );
+				AnimEdges.AddItem( Texture );
+				Drop = MAXINT;
+			}
+			AddUse( Texture, USAGE_Used, Drop );
+		}
+	}
+
+	UBOOL bChanged = 1;
+	while( bChanged )
+	{
+		bChanged = 0;
+		for( INT i = 0; i < AnimEdges.Num(); i += 2 )
+		{
+			FInfo* From = Infos.Find( AnimEdges(i) );
+			FInfo* To = Infos.Find( AnimEdges(i + 1) );
+			if( From && To && From->Drop < To->Drop )
+			{
+				To->Drop = From->Drop;
+				bChanged = 1;
+			}
+		}
+	}
+
+	AddEffectSources( nullptr );
+
+	INT NumUsed = 0, NumEffect = 0, NumLowLOD = 0;
+	for( TMap<UTexture*,FInfo>::TIterator It( Infos ); It; ++It )
+	{
+		const FInfo& Info = It.Value();
+		if( Info.Flags & USAGE_Used )
+		{
+			NumUsed++;
+			if( UPackage* Pkg = GetTopPackage( It.Key() ) )
+				UsedPackages.Set( Pkg, 1 );
+		}
+		if( Info.Flags & USAGE_Effect )
+			NumEffect++;
+		if( Info.Drop > 0 && Info.Drop != MAXINT )
+			NumLowLOD++;
+	}
+	printf( "- %d textures used, %d effect sources, %d only used at low LOD\n", NumUsed, NumEffect, NumLowLOD );
+
+	bBuilt = 1;
+	unguard;
+}
+
+//
+// Realtime textures and fonts read their sources as they are, whether or not
+// anything reached them. Pass a package to scan one loaded after Build.
+//
+void FTextureUsage::AddEffectSources( UObject* InPkg )
+{
+	guard(FTextureUsage::AddEffectSources);
+
+	for( TObjectIterator<UObject> It; It; ++It )
+	{
+		if( InPkg && !It->IsIn( InPkg ) )
+			continue;
+		UTexture* Texture = Cast<UTexture>( *It );
+		if( !It->IsA( UFont::StaticClass() ) && !( Texture && ( Texture->bRealtime || Texture->bParametric ) ) )
+			continue;
+		TArray<UObject*> Refs;
+		FArchiveCollectRefs Collect( *It, Refs );
+		for( INT i = 0; i < Refs.Num(); ++i )
+			if( UTexture* Source = Cast<UTexture>( Refs(i) ) )
+				if( Source != Texture )
+					AddUse( Source, USAGE_Effect, 0 );
+	}
+
+	unguard;
+}
+
+UBOOL FTextureUsage::IsEffectTarget( UTexture* Texture )
+{
+	const FInfo* Info = Infos.Find( Texture );
+	return Info && ( Info->Flags & USAGE_Effect );
+}
+
+//
+// Only textures in packages something else was found to use count as unused,
+// and never in packages with .int registry entries. Script may still load
+// either kind by name, so dropping is opt-in with -dropunused.
+//
+UBOOL FTextureUsage::IsUnused( UTexture* Texture )
+{
+	if( !bBuilt || !bDropUnused || Texture->bRealtime || Texture->bParametric )
+		return 0;
+	const FInfo* Info = Infos.Find( Texture );
+	if( Info && ( Info->Flags & ( USAGE_Used | USAGE_Effect ) ) )
+		return 0;
+	UPackage* Pkg = GetTopPackage( Texture );
+	return Pkg && UsedPackages.Find( Pkg ) && !NamedPackages.Find( Pkg->GetFName() );
+}
+
+INT FTextureUsage::GetLowLODDrop( UTexture* Texture )
+{
+	const FInfo* Info = Infos.Find( Texture );
+	if( !Info || Info->Drop == MAXINT || ( Info->Flags & USAGE_Effect ) )
+		return 0;
+	return Info->Drop;
+}
@@ -147,6 +147,67 @@ struct FMeshMaterial
 	}
 };
 
+/*-----------------------------------------------------------------------------
+	Mesh triangle strips and packed frames.
+-----------------------------------------------------------------------------*/
+
+// Data built by DCUtil. A negative TextureLOD count on disk holds the format
+// version, see UMesh::SerializeExtra. 1 added strips, 2 packed frames.
+enum {MESH_EXTRA_VERSION = 2};
+
+// One triangle strip in UMesh::StripWedges, drawn with a single texture and
+// set of flags. Every other triangle is wound the other way, as usual.
+struct FMeshStrip
+{
+	DWORD		PolyFlags;		// Surface flags.
+	INT			TextureIndex;	// Source texture index.
+	INT			FirstWedge;		// First wedge in StripWedges.
+	INT			NumWedges;		// Number of wedges, triangles + 2.
+	friend FArchive &operator<<( FArchive& Ar, FMeshStrip& S )
+	{
+		return Ar << S.PolyFlags << S.TextureIndex << AR_INDEX(S.FirstWedge) << AR_INDEX(S.NumWedges);
+	}
+};
+
+// Bounds of one animation frame in UMesh::PackedVerts, where each vertex is
+// stored as three bytes, Min + Q * Step on each axis.
+struct FMeshPackedFrame
+{
+	FVector		Min;			// Smallest vertex in the frame.
+	FVector		Step;			// Size of one quantization step.
+	friend FArchive &operator<<( FArchive& Ar, FMeshPackedFrame& F )
+	{
+		return Ar << F.Min << F.Step;
+	}
+};
+
+// Decodes and interpolates two packed frames in one go, folding the lerp into
+// the dequantization: V = Base + Q1 * Scale1 + Q2 * Scale2.
+struct FMeshPackedLerp
+{
+	FVector		Base;
+	FVector		Scale1;
+	FVector		Scale2;
+	FMeshPackedLerp( const FMeshPackedFrame& F1, const FMeshPackedFrame& F2, FLOAT Alpha )
+	:	Base	( F1.Min + (F2.Min - F1.Min) * Alpha )
+	,	Scale1	( F1.Step * (1.0 - Alpha) )
+	,	Scale2	( F2.Step * Alpha )
+	{}
+	FVector Decode( const BYTE* Q1, const BYTE* Q2 ) const
+	{
+		return FVector
+		(
+			Base.X + Q1[0] * Scale1.X + Q2[0] * Scale2.X,
+			Base.Y + Q1[1] * Scale1.Y + Q2[1] * Scale2.Y,
+			Base.Z + Q1[2] * Scale1.Z + Q2[2] * Scale2.Z
+		);
+	}
+	FVector Decode( const BYTE* Q1 ) const
+	{
+		return FVector( Base.X + Q1[0] * Scale1.X, Base.Y + Q1[1] * Scale1.Y, Base.Z + Q1[2] * Scale1.Z );
+	}
+};
+
 /*-----------------------------------------------------------------------------
 	FMeshAnimNotify.
 -----------------------------------------------------------------------------*/
@@ -219,6 +280,10 @@ class ENGINE_API UMesh : public UPrimitive
 	TLazyArray<INT>					VertLinks;
 	TArray<UTexture*>				Textures;
 	TArray<FLOAT>					TextureLOD;
+	TArray<FMeshWedge>				StripWedges;	// Strip vertices, indexing the frame like Tris.
+	TArray<FMeshStrip>				Strips;			// Visible triangles as strips, if DCUtil built them.
+	TArray<FMeshPackedFrame>		PackedFrames;	// Per frame bounds of PackedVerts, if DCUtil packed Verts.
+	TLazyArray<BYTE>				PackedVerts;	// Quantized frames replacing Verts.
 
 	// Counts.
 	INT						FrameVerts;
@@ -290,6 +355,7 @@ class ENGINE_API UMesh : public UPrimitive
 		unguardSlow;
 	}
 	virtual void SetScale( FVector NewScale );
+	void SerializeExtra( FArchive& Ar );
 };
 
 /*-----------------------------------------------------------------------------
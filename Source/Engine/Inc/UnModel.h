@@ -15,6 +15,24 @@
 //
 enum {MAX_NODES  = 4096};
 enum {MAX_POINTS = 8192};
+
+//
+// Run-length coded LightBits. A negative LightBits count on disk holds the
+// format version, see UModel::SerializeLightBits.
+//
+enum {LIGHTBITS_RLE_VERSION = 1};
+enum {LIGHTBITS_SEEK_SPACING = 512};
+
+//
+// Entry into the LightBits runs for every LIGHTBITS_SEEK_SPACING uncompressed
+// bytes, so shadow bits for one surface can be expanded without the rest.
+//
+struct FLightBitsSeek
+{
+	INT RunOffset;	// Offset of the run in LightBitsRLE.
+	INT DataOffset;	// Uncompressed offset the run starts at.
+};
+
 class ENGINE_API UModel : public UPrimitive
 {
 #ifndef NODECALS
@@ -32,6 +50,8 @@ class ENGINE_API UModel : public UPrimitive
 	TTransArray<FBspSurf>	Surfs;
 	TArray<FLightMapIndex>	LightMap;
 	TArray<BYTE>			LightBits;
+	TArray<BYTE>			LightBitsRLE;
+	TArray<FLightBitsSeek>	LightBitsSeek;
 	TArray<FBox>			Bounds;
 	TArray<INT>				LeafHulls;
 	TArray<FLeaf>			Leaves;
@@ -43,16 +63,18 @@ class ENGINE_API UModel : public UPrimitive
 	INT						MoverLink;
 	INT						NumSharedSides;
 	INT						NumZones;
+	INT						LightBitsSize;
 	FZoneProperties			Zones[FBspNode::MAX_ZONES];
 
 	// Constructors.
 	UModel()
-	: RootOutside( 1 )
-	, Surfs( this )
+	: Nodes( this )
+	, Verts( this )
 	, Vectors( this )
 	, Points( this )
-	, Verts( this )
-	, Nodes( this )
+	, Surfs( this )
+	, RootOutside( 1 )
+	, LightBitsSize( 0 )
 	{
 		EmptyModel( 1, 0 );
 	}
@@ -92,6 +114,11 @@ class ENGINE_API UModel : public UPrimitive
 	UBOOL PotentiallyVisible( INT iLeaf1, INT iLeaf2 );
 	BYTE FastLineCheck( FVector End, FVector Start );
 
+	// UModel LightBits compression.
+	UBOOL CompressLightBits();
+	void DecompressLightBits();
+	BYTE* GetShadowBits( FMemStack& Mem, INT Offset, INT Size );
+
 	// UModel transactions.
 	void ModifySelectedSurfs( UBOOL UpdateMaster );
 	void ModifyAllSurfs( UBOOL UpdateMaster );
@@ -121,6 +148,10 @@ class ENGINE_API UModel : public UPrimitive
 		return &LightMap(Surf.iLightMap);
 		unguard;
 	}
+
+protected:
+	void SerializeLightBits( FArchive& Ar );
+	void BuildLightBitsSeek();
 };
 
 /*----------------------------------------------------------------------------
@@ -84,9 +84,9 @@ class ENGINE_API URenderDevice : public USubsystem
 	virtual void DrawStats( FSceneNode* Frame ) {}
 	virtual void SetSceneNode( FSceneNode* Frame ) {}
 	virtual void PrecacheTexture( FTextureInfo& Info, DWORD PolyFlags ) {}
+	virtual void DrawGouraudTriStrip( FSceneNode* Frame, FTextureInfo& Info, FTransTexture** Pts, INT NumPts, DWORD PolyFlags, FSpanBuffer* Span );
 
 	// Padding.
-	virtual void vtblPad0() {}
 	virtual void vtblPad1() {}
 	virtual void vtblPad2() {}
 	virtual void vtblPad3() {}
@@ -161,6 +161,7 @@ void ULodMesh::GetFrame
 
 	// Make sure any used lazy-loadable arrays are ready.
 	Verts.Load();
+	PackedVerts.Load();
 
 	AActor*	AnimOwner = NULL;
 
@@ -219,19 +220,45 @@ void ULodMesh::GetFrame
 
 		// Compute interpolation numbers.
 		FLOAT Alpha=0.0;
-		INT iFrameOffset1=0, iFrameOffset2=0;
+		INT iFrame1=0, iFrame2=0;
 		if( Seq )
 		{
 			FLOAT Frame   = ::Max(AnimOwner->AnimFrame,0.f) * Seq->NumFrames;
 			INT iFrame    = appFloor(Frame);
 			Alpha         = Frame - iFrame;
-			iFrameOffset1 = (Seq->StartFrame + ((iFrame + 0) % Seq->NumFrames)) * FrameVerts;
-			iFrameOffset2 = (Seq->StartFrame + ((iFrame + 1) % Seq->NumFrames)) * FrameVerts;
+			iFrame1       = Seq->StartFrame + ((iFrame + 0) % Seq->NumFrames);
+			iFrame2       = Seq->StartFrame + ((iFrame + 1) % Seq->NumFrames);
 		}
-		
+		INT iFrameOffset1 = iFrame1 * FrameVerts;
+		INT iFrameOffset2 = iFrame2 * FrameVerts;
 
+		if( PackedFrames.Num() )
+		{
+			// Decode and interpolate two packed frames, Alpha 0 only needs the first.
+			FMeshPackedLerp Lerp( PackedFrames(iFrame1), PackedFrames(iFrame2), Alpha );
+			const BYTE* Packed1 = &PackedVerts( iFrameOffset1 * 3 );
+			const BYTE* Packed2 = &PackedVerts( iFrameOffset2 * 3 );
+			if( Alpha <= 0.0f )
+			{
+				for( INT i=0; i<VertexNum; i++ )
+				{
+					CachedVerts[i] = Lerp.Decode( Packed1 + i*3 );
+					*ResultVerts = (CachedVerts[i] - Origin).TransformPointBy(Coords);
+					*(BYTE**)&ResultVerts += Size;
+				}
+			}
+			else
+			{
+				for( INT i=0; i<VertexNum; i++ )
+				{
+					CachedVerts[i] = Lerp.Decode( Packed1 + i*3, Packed2 + i*3 );
+					*ResultVerts = (CachedVerts[i] - Origin).TransformPointBy(Coords);
+					*(BYTE**)&ResultVerts += Size;
+				}
+			}
+		}
 		// Special case Alpha 0. 
-		if ( Alpha <= 0.0f)
+		else if ( Alpha <= 0.0f)
 		{
 			// Initialize a single frame.
 			FMeshVert* MeshVertex1 = &Verts( iFrameOffset1 );
@@ -270,7 +297,8 @@ void ULodMesh::GetFrame
 
 		// Compute tweening numbers.
 		FLOAT StartFrame = Seq ? (-1.0 / Seq->NumFrames) : 0.0;
-		INT iFrameOffset = Seq ? Seq->StartFrame * FrameVerts : 0;
+		INT iTweenFrame  = Seq ? Seq->StartFrame : 0;
+		INT iFrameOffset = iTweenFrame * FrameVerts;
 		FLOAT Alpha = 1.0 - AnimOwner->AnimFrame / FrameHdr->CachedFrame;
 
 		if( FrameHdr->CachedSeq!=AnimOwner->AnimSequence )
@@ -297,10 +325,20 @@ void ULodMesh::GetFrame
 			// now is the time to fill it out to the requested number.
 			if (VertexNum < VertsRequested )
 			{
-				FMeshVert* MeshVertex = &Verts( iFrameOffset );
-				for( INT i=VertexNum; i<VertsRequested; i++ )
+				if( PackedFrames.Num() )
+				{
+					FMeshPackedLerp Target( PackedFrames(iTweenFrame), PackedFrames(iTweenFrame), 0.0f );
+					const BYTE* Packed = &PackedVerts( iFrameOffset * 3 );
+					for( INT i=VertexNum; i<VertsRequested; i++ )
+						CachedVerts[i] = Target.Decode( Packed + i*3 );
+				}
+				else
 				{
-					CachedVerts[i]= FVector( MeshVertex[i].X, MeshVertex[i].Y, MeshVertex[i].Z );
+					FMeshVert* MeshVertex = &Verts( iFrameOffset );
+					for( INT i=VertexNum; i<VertsRequested; i++ )
+					{
+						CachedVerts[i]= FVector( MeshVertex[i].X, MeshVertex[i].Y, MeshVertex[i].Z );
+					}
 				}
 				VertexNum = VertsRequested;
 				LODRequest = VertexNum - SpecialVerts; 
@@ -317,6 +355,18 @@ void ULodMesh::GetFrame
 				*(BYTE**)&ResultVerts += Size;
 			}
 		}
+		else if( PackedFrames.Num() )
+		{
+			// Tween all points between cached value and the packed target.
+			FMeshPackedLerp Target( PackedFrames(iTweenFrame), PackedFrames(iTweenFrame), 0.0f );
+			const BYTE* Packed = &PackedVerts( iFrameOffset * 3 );
+			for( INT i=0; i<VertexNum; i++ )
+			{
+				CachedVerts[i] += (Target.Decode( Packed + i*3 ) - CachedVerts[i]) * Alpha;
+				*ResultVerts = (CachedVerts[i] - Origin).TransformPointBy(Coords);
+				*(BYTE**)&ResultVerts += Size;
+			}
+		}
 		else
 		{
 			// Tween all points between cached value and new one.
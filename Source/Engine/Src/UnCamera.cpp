@@ -193,6 +193,32 @@ void URenderDevice::Draw3DLine
 	unguard;
 }
 
+//
+// Draw a projected, unclipped triangle strip. Every other triangle is wound
+// the other way, devices that don't cull can send the vertices as they are.
+// This default just breaks it up into triangles for DrawGouraudPolygon.
+//
+void URenderDevice::DrawGouraudTriStrip
+(
+	FSceneNode*		Frame,
+	FTextureInfo&	Info,
+	FTransTexture**	Pts,
+	INT				NumPts,
+	DWORD			PolyFlags,
+	FSpanBuffer*	Span
+)
+{
+	guard(URenderDevice::DrawGouraudTriStrip);
+	for( INT i=0; i<NumPts-2; i++ )
+	{
+		FTransTexture* Tri[3] = { Pts[i], Pts[i+1], Pts[i+2] };
+		if( i & 1 )
+			Exchange( Tri[0], Tri[1] );
+		DrawGouraudPolygon( Frame, Info, Tri, 3, PolyFlags, Span );
+	}
+	unguard;
+}
+
 /*-----------------------------------------------------------------------------
 	UViewport object implementation.
 -----------------------------------------------------------------------------*/
@@ -1007,17 +1007,16 @@ void UActorChannel::ReplicateActor()
 			BYTE& Eval = RepEval(FieldCache->ConditionIndex);
 			if( Eval!=2 )
 			{
-				UObjectProperty* Op = Cast<UObjectProperty>(It);
 				for( INT Index=0; Index<It->ArrayDim; Index++ )
 				{
-					// Evaluate need to send the property.
-					INT Offset = It->Offset + Index*It->ElementSize;
-					BYTE* Src = (BYTE*)Actor + Offset;
-					if( Op && !Connection->PackageMap->CanSerializeObject(*(UObject**)Src) )
-					{
-						Src = NULL;
-					}
-					if( !It->Identical(CompareBin+Offset,Src) )
+					// Evaluate need to send the property, by the element's precomputed compare step.
+					const FPropertyOp& Op = ActorClass->ClassReps(It->RepIndex+Index).Op;
+					UBOOL Identical;
+					if( Op.Type==POP_Object && !Connection->PackageMap->CanSerializeObject(*(UObject**)((BYTE*)Actor+Op.Offset)) )
+						Identical = *(UObject**)(CompareBin+Op.Offset)==NULL;
+					else
+						Identical = Op.Identical( CompareBin, (BYTE*)Actor );
+					if( !Identical )
 					{
 						if( !(Eval & 2) )
 						{
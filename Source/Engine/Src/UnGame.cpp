@@ -863,9 +863,8 @@ ULevel* UGameEngine::LoadMap( const FURL& URL, UPendingLevel* Pending, const TMa
 	if( appStricmp(GLevel->GetOuter()->GetName(),TEXT("Entry"))!=0 )
 	{
 		Flush(0);
-		{for( TObjectIterator<AActor> It; It; ++It )
-			if( It->IsIn(GLevel->GetOuter()) )
-				It->SetFlags( RF_EliminateObject );}
+		{for( TPackageObjectIterator<AActor> It(GLevel->GetOuter()); It; ++It )
+			It->SetFlags( RF_EliminateObject );}
 		{for( INT i=0; i<GLevel->Actors.Num(); i++ )
 			if( GLevel->Actors(i) )
 				GLevel->Actors(i)->ClearFlags( RF_EliminateObject );}
@@ -37,7 +37,7 @@ void UMesh::Serialize( FArchive& Ar )
 	// Serialize this.
 	Ar << Verts;
 	Ar << Tris;
-	if( Tris.Num() )
+	if( Tris.Num() && Verts.Num() )
 		check(Tris(0).iVertex[0]<Verts.Num());
 	Ar << AnimSeqs;
 	Ar << Connects << BoundingBox << BoundingSphere << VertLinks << Textures;
@@ -49,10 +49,58 @@ void UMesh::Serialize( FArchive& Ar )
 	if( Ar.Ver()==65 )
 		{FLOAT F; Ar << F;}
 	if( Ar.Ver()>=66 )
-		Ar << TextureLOD;
+		SerializeExtra( Ar );
 
 	unguardobj;
 }
+
+//
+// TextureLOD is either a plain float array, or if DCUtil built strips or
+// packed the frames, a negative count holding MESH_EXTRA_VERSION followed by
+// that data and then TextureLOD itself.
+//
+void UMesh::SerializeExtra( FArchive& Ar )
+{
+	guard(UMesh::SerializeExtra);
+	if( Ar.IsLoading() )
+	{
+		INT Num;
+		Ar << AR_INDEX(Num);
+		StripWedges.Empty();
+		Strips.Empty();
+		PackedFrames.Empty();
+		if( Num >= 0 )
+		{
+			TextureLOD.Empty( Num );
+			TextureLOD.Add( Num );
+			for( INT i=0; i<Num; i++ )
+				Ar << TextureLOD(i);
+		}
+		else
+		{
+			if( -Num > MESH_EXTRA_VERSION )
+				appErrorf( "%s: Unknown mesh extra format %i", GetFullName(), -Num );
+			Ar << StripWedges << Strips;
+			if( -Num >= 2 )
+				Ar << PackedFrames << PackedVerts;
+			Ar << TextureLOD;
+		}
+	}
+	else if( Ar.IsSaving() && (Strips.Num() || PackedFrames.Num()) )
+	{
+		INT Version = -MESH_EXTRA_VERSION;
+		Ar << AR_INDEX(Version) << StripWedges << Strips << PackedFrames << PackedVerts << TextureLOD;
+	}
+	else if( Ar.IsSaving() )
+	{
+		Ar << TextureLOD;
+	}
+	else
+	{
+		Ar << StripWedges << Strips << PackedFrames << PackedVerts << TextureLOD;
+	}
+	unguard;
+}
 void UMesh::SetScale( FVector NewScale )
 {
 	Scale = NewScale;
@@ -527,9 +575,10 @@ void UMesh::GetFrame
 	Tris.Load();
 	Connects.Load();
 	VertLinks.Load();
+	PackedVerts.Load();
 
 #if ASM3DNOW
-	if( GIs3DNow )
+	if( GIs3DNow && !PackedFrames.Num() )
 	{
 		AMD3DGetFrame( ResultVerts, Size, Coords, Owner );
 		return;
@@ -581,33 +630,52 @@ void UMesh::GetFrame
 	{
 		// Compute interpolation numbers.
 		FLOAT Alpha=0.0;
-		INT iFrameOffset1=0, iFrameOffset2=0;
+		INT iFrame1=0, iFrame2=0;
 		if( Seq )
 		{
 			FLOAT Frame   = ::Max(AnimOwner->AnimFrame,0.f) * Seq->NumFrames;
 			INT iFrame    = appFloor(Frame);
 			Alpha         = Frame - iFrame;
-			iFrameOffset1 = (Seq->StartFrame + ((iFrame + 0) % Seq->NumFrames)) * FrameVerts;
-			iFrameOffset2 = (Seq->StartFrame + ((iFrame + 1) % Seq->NumFrames)) * FrameVerts;
+			iFrame1       = Seq->StartFrame + ((iFrame + 0) % Seq->NumFrames);
+			iFrame2       = Seq->StartFrame + ((iFrame + 1) % Seq->NumFrames);
 		}
+		INT iFrameOffset1 = iFrame1 * FrameVerts;
+		INT iFrameOffset2 = iFrame2 * FrameVerts;
 
-		// Interpolate two frames.
-		FMeshVert* MeshVertex1 = &Verts( iFrameOffset1 );
-		FMeshVert* MeshVertex2 = &Verts( iFrameOffset2 );
-		for( INT i=0; i<FrameVerts; i++ )
+		if( PackedFrames.Num() )
+		{
+			// Decode and interpolate two packed frames.
+			FMeshPackedLerp Lerp( PackedFrames(iFrame1), PackedFrames(iFrame2), Alpha );
+			const BYTE* Packed1 = &PackedVerts( iFrameOffset1 * 3 );
+			const BYTE* Packed2 = &PackedVerts( iFrameOffset2 * 3 );
+			for( INT i=0; i<FrameVerts; i++ )
+			{
+				CachedVerts[i] = Lerp.Decode( Packed1 + i*3, Packed2 + i*3 );
+				*ResultVerts = (CachedVerts[i] - Origin).TransformPointBy(Coords);
+				*(BYTE**)&ResultVerts += Size;
+			}
+		}
+		else
 		{
-			FVector V1( MeshVertex1[i].X, MeshVertex1[i].Y, MeshVertex1[i].Z );
-			FVector V2( MeshVertex2[i].X, MeshVertex2[i].Y, MeshVertex2[i].Z );
-			CachedVerts[i] = V1 + (V2-V1)*Alpha;
-			*ResultVerts = (CachedVerts[i] - Origin).TransformPointBy(Coords);
-			*(BYTE**)&ResultVerts += Size;
+			// Interpolate two frames.
+			FMeshVert* MeshVertex1 = &Verts( iFrameOffset1 );
+			FMeshVert* MeshVertex2 = &Verts( iFrameOffset2 );
+			for( INT i=0; i<FrameVerts; i++ )
+			{
+				FVector V1( MeshVertex1[i].X, MeshVertex1[i].Y, MeshVertex1[i].Z );
+				FVector V2( MeshVertex2[i].X, MeshVertex2[i].Y, MeshVertex2[i].Z );
+				CachedVerts[i] = V1 + (V2-V1)*Alpha;
+				*ResultVerts = (CachedVerts[i] - Origin).TransformPointBy(Coords);
+				*(BYTE**)&ResultVerts += Size;
+			}
 		}
 	}
 	else
 	{
 		// Compute tweening numbers.
 		FLOAT StartFrame = Seq ? (-1.0 / Seq->NumFrames) : 0.0;
-		INT iFrameOffset = Seq ? Seq->StartFrame * FrameVerts : 0;
+		INT iTweenFrame  = Seq ? Seq->StartFrame : 0;
+		INT iFrameOffset = iTweenFrame * FrameVerts;
 		FLOAT Alpha = 1.0 - AnimOwner->AnimFrame / CachedFrame;
 		if( CachedSeq!=AnimOwner->AnimSequence || Alpha<0.0 || Alpha>1.0)
 		{
@@ -617,13 +685,27 @@ void UMesh::GetFrame
 		}
 
 		// Tween all points.
-		FMeshVert* MeshVertex = &Verts( iFrameOffset );
-		for( INT i=0; i<FrameVerts; i++ )
+		if( PackedFrames.Num() )
+		{
+			FMeshPackedLerp Target( PackedFrames(iTweenFrame), PackedFrames(iTweenFrame), 0.0 );
+			const BYTE* Packed = &PackedVerts( iFrameOffset * 3 );
+			for( INT i=0; i<FrameVerts; i++ )
+			{
+				CachedVerts[i] += (Target.Decode( Packed + i*3 ) - CachedVerts[i]) * Alpha;
+				*ResultVerts = (CachedVerts[i] - Origin).TransformPointBy(Coords);
+				*(BYTE**)&ResultVerts += Size;
+			}
+		}
+		else
 		{
-			FVector V2( MeshVertex[i].X, MeshVertex[i].Y, MeshVertex[i].Z );
-			CachedVerts[i] += (V2 - CachedVerts[i]) * Alpha;
-			*ResultVerts = (CachedVerts[i] - Origin).TransformPointBy(Coords);
-			*(BYTE**)&ResultVerts += Size;
+			FMeshVert* MeshVertex = &Verts( iFrameOffset );
+			for( INT i=0; i<FrameVerts; i++ )
+			{
+				FVector V2( MeshVertex[i].X, MeshVertex[i].Y, MeshVertex[i].Z );
+				CachedVerts[i] += (V2 - CachedVerts[i]) * Alpha;
+				*ResultVerts = (CachedVerts[i] - Origin).TransformPointBy(Coords);
+				*(BYTE**)&ResultVerts += Size;
+			}
 		}
 
 		// Update cached frame.
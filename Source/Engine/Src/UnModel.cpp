@@ -306,7 +306,9 @@ void UModel::Serialize( FArchive& Ar )
 		Ar.Preload( Polys );
 	}
 
-	Ar << LightMap << LightBits << Bounds << LeafHulls << Leaves << Lights;
+	Ar << LightMap;
+	SerializeLightBits( Ar );
+	Ar << Bounds << LeafHulls << Leaves << Lights;
 	if( Ar.Ver()<=61 )//oldver
 	{
 		UObject* Tmp=NULL;
@@ -316,6 +318,176 @@ void UModel::Serialize( FArchive& Ar )
 
 	unguard;
 }
+
+//
+// LightBits are either a plain byte array, or if DCUtil compressed them, a
+// negative count holding the RLE version followed by the uncompressed size and
+// the runs. Low memory builds keep them compressed and expand them per surface
+// with GetShadowBits, everything else expands them here.
+//
+void UModel::SerializeLightBits( FArchive& Ar )
+{
+	guard(UModel::SerializeLightBits);
+	if( Ar.IsLoading() )
+	{
+		INT Num;
+		Ar << AR_INDEX(Num);
+		LightBitsRLE.Empty();
+		LightBitsSeek.Empty();
+		LightBitsSize = 0;
+		if( Num >= 0 )
+		{
+			LightBits.Empty( Num );
+			LightBits.Add( Num );
+			Ar.Serialize( &LightBits(0), Num );
+		}
+		else
+		{
+			if( -Num > LIGHTBITS_RLE_VERSION )
+				appErrorf( "%s: Unknown LightBits format %i", GetFullName(), -Num );
+			LightBits.Empty();
+			Ar << LightBitsSize << LightBitsRLE;
+			BuildLightBitsSeek();
+#ifndef PLATFORM_LOW_MEMORY
+			DecompressLightBits();
+#endif
+		}
+	}
+	else if( Ar.IsSaving() && LightBitsRLE.Num() )
+	{
+		INT Version = -LIGHTBITS_RLE_VERSION;
+		Ar << AR_INDEX(Version) << LightBitsSize << LightBitsRLE;
+	}
+	else Ar << LightBits;
+	unguard;
+}
+
+//
+// Decode one run at Runs(Pos), returning the offset of the next one.
+// Runs are 2 bytes, length then value, or 3 bytes when the 0x40 flag
+// extends the length to 14 bits. The 0x80 bit is ignored.
+//
+static inline INT DecodeLightBitsRun( const TArray<BYTE>& Runs, INT Pos, INT& Length, BYTE& Value )
+{
+	const BYTE Code = Runs(Pos++);
+	Length = Code & 0x3F;
+	if( Code & 0x40 )
+		Length = ( Length << 8 ) | Runs(Pos++);
+	Value = Runs(Pos++);
+	return Pos;
+}
+
+void UModel::BuildLightBitsSeek()
+{
+	guard(UModel::BuildLightBitsSeek);
+	LightBitsSeek.Empty( LightBitsSize / LIGHTBITS_SEEK_SPACING + 1 );
+	INT DataOffset = 0;
+	for( INT RunOffset=0; RunOffset<LightBitsRLE.Num(); )
+	{
+		INT Length;
+		BYTE Value;
+		INT NextRun = DecodeLightBitsRun( LightBitsRLE, RunOffset, Length, Value );
+		while( LightBitsSeek.Num()*LIGHTBITS_SEEK_SPACING < DataOffset+Length )
+		{
+			FLightBitsSeek& Seek = LightBitsSeek(LightBitsSeek.Add());
+			Seek.RunOffset  = RunOffset;
+			Seek.DataOffset = DataOffset;
+		}
+		DataOffset += Length;
+		RunOffset   = NextRun;
+	}
+	if( DataOffset != LightBitsSize )
+		appErrorf( "%s: Corrupt LightBits (%i of %i bytes)", GetFullName(), DataOffset, LightBitsSize );
+	unguard;
+}
+
+//
+// Replace LightBits with their run-length coding, if that's smaller.
+//
+UBOOL UModel::CompressLightBits()
+{
+	guard(UModel::CompressLightBits);
+	if( LightBitsRLE.Num() )
+		return 1;
+
+	TArray<BYTE> Runs;
+	for( INT i=0; i<LightBits.Num(); )
+	{
+		INT Length = 1;
+		while( i+Length<LightBits.Num() && LightBits(i+Length)==LightBits(i) && Length<0x3FFF )
+			Length++;
+		if( Length > 0x3F )
+		{
+			Runs.AddItem( 0x40 | (Length >> 8) );
+			Runs.AddItem( Length & 0xFF );
+		}
+		else Runs.AddItem( Length );
+		Runs.AddItem( LightBits(i) );
+		i += Length;
+	}
+	if( Runs.Num() >= LightBits.Num() )
+		return 0;
+
+	LightBitsSize = LightBits.Num();
+	ExchangeArray( LightBitsRLE, Runs );
+	LightBits.Empty();
+	BuildLightBitsSeek();
+	return 1;
+	unguard;
+}
+
+void UModel::DecompressLightBits()
+{
+	guard(UModel::DecompressLightBits);
+	if( !LightBitsRLE.Num() )
+		return;
+
+	LightBits.Empty( LightBitsSize );
+	LightBits.Add( LightBitsSize );
+	for( INT RunOffset=0, DataOffset=0; RunOffset<LightBitsRLE.Num(); )
+	{
+		INT Length;
+		BYTE Value;
+		RunOffset = DecodeLightBitsRun( LightBitsRLE, RunOffset, Length, Value );
+		appMemset( &LightBits(DataOffset), Value, Length );
+		DataOffset += Length;
+	}
+	LightBitsRLE.Empty();
+	LightBitsSeek.Empty();
+	LightBitsSize = 0;
+	unguard;
+}
+
+//
+// Return Size bytes of shadow bits at Offset. Compressed LightBits are
+// expanded into Mem, so the result lives until Mem is popped.
+//
+BYTE* UModel::GetShadowBits( FMemStack& Mem, INT Offset, INT Size )
+{
+	guard(UModel::GetShadowBits);
+	if( !LightBitsRLE.Num() )
+		return &LightBits(Offset);
+
+	check(Offset>=0 && Offset+Size<=LightBitsSize);
+	BYTE* Result = New<BYTE>(Mem,Size);
+	if( !Size )
+		return Result;
+	const FLightBitsSeek& Seek = LightBitsSeek(Offset / LIGHTBITS_SEEK_SPACING);
+	for( INT RunOffset=Seek.RunOffset, DataOffset=Seek.DataOffset; DataOffset<Offset+Size; )
+	{
+		INT Length;
+		BYTE Value;
+		RunOffset = DecodeLightBitsRun( LightBitsRLE, RunOffset, Length, Value );
+		const INT Start = Max( DataOffset, Offset );
+		const INT End   = Min( DataOffset+Length, Offset+Size );
+		if( End > Start )
+			appMemset( Result+Start-Offset, Value, End-Start );
+		DataOffset += Length;
+	}
+	return Result;
+	unguard;
+}
+
 void UModel::PostLoad()
 {
 	guard(UModel::PostLoad);
@@ -389,6 +561,9 @@ void UModel::EmptyModel( INT EmptySurfInfo, INT EmptyPolys )
 	Lights		.Empty();
 	LightMap	.Empty();
 	LightBits	.Empty();
+	LightBitsRLE.Empty();
+	LightBitsSeek.Empty();
+	LightBitsSize = 0;
 	Verts		.Empty();
 	if( EmptySurfInfo )
 	{
@@ -422,12 +597,13 @@ void UModel::EmptyModel( INT EmptySurfInfo, INT EmptyPolys )
 // Create a new model and allocate all objects needed for it.
 //
 UModel::UModel( ABrush* Owner, UBOOL InRootOutside )
-:	RootOutside	( InRootOutside )
-,	Surfs		( this )
+:	Nodes		( this )
+,	Verts		( this )
 ,	Vectors		( this )
 ,	Points		( this )
-,	Verts		( this )
-,	Nodes		( this )
+,	Surfs		( this )
+,	RootOutside	( InRootOutside )
+,	LightBitsSize( 0 )
 {
 	guard(UModel::UModel);
 	SetFlags( RF_Transactional );
@@ -368,7 +368,7 @@ void UPVRRenderDevice::Exit()
 
 	if( Compose )
 	{
-		appFree( Compose );
+		free( Compose );
 		Compose = NULL;
 	}
 	ComposeSize = 0;
@@ -682,6 +682,30 @@ void UPVRRenderDevice::DrawComplexSurface( FSceneNode* Frame, FSurfaceInfo& Surf
 	unguard;
 }
 
+// Gouraud polygons and mesh strips, submitted in order as one vertex strip.
+struct FDrawGouraudCallback : public FPVRRenderCallback
+{
+	pvr_poly_hdr_t Hdr;
+	FSceneNode* Frame;
+	TArray<FPVRClipVert> ClippedVerts;
+	
+	virtual void Execute() override
+	{
+		PVRHeaderSubmit( Hdr );
+		if( ClippedVerts.Num() >= 3 )
+		{
+			for( INT i = 0; i < ClippedVerts.Num(); i++ )
+			{
+				const FPVRClipVert& Vtx = ClippedVerts(i);
+				FLOAT SX, SY, SZ;
+				ProjectToScreenUE( Frame, Vtx.X, Vtx.Y, Vtx.Z, SX, SY, SZ );
+				const unsigned Flags = (i == ClippedVerts.Num() - 1) ? PVR_CMD_VERTEX_EOL : PVR_CMD_VERTEX;
+				PVRVertexSubmit( SX, SY, SZ, Vtx.U, Vtx.V, Vtx.ARGB, Flags );
+			}
+		}
+	}
+};
+
 void UPVRRenderDevice::DrawGouraudPolygon( FSceneNode* Frame, FTextureInfo& Info, FTransTexture** Pts, int NumPts, DWORD PolyFlags, FSpanBuffer* Span )
 {
 	guard(UPVRRenderDevice::DrawGouraudPolygon);
@@ -696,29 +720,6 @@ void UPVRRenderDevice::DrawGouraudPolygon( FSceneNode* Frame, FTextureInfo& Info
     pvr_poly_hdr_t Hdr; pvr_list_t List;
     BuildPolyHeader( this, PolyFlags, &Info, Hdr, List );
 
-	struct FDrawGouraudCallback : public FPVRRenderCallback
-	{
-		pvr_poly_hdr_t Hdr;
-		FSceneNode* Frame;
-		TArray<FPVRClipVert> ClippedVerts;
-		
-		virtual void Execute() override
-		{
-			PVRHeaderSubmit( Hdr );
-			if( ClippedVerts.Num() >= 3 )
-			{
-				for( INT i = 0; i < ClippedVerts.Num(); i++ )
-				{
-					const FPVRClipVert& Vtx = ClippedVerts(i);
-					FLOAT SX, SY, SZ;
-					ProjectToScreenUE( Frame, Vtx.X, Vtx.Y, Vtx.Z, SX, SY, SZ );
-					const unsigned Flags = (i == ClippedVerts.Num() - 1) ? PVR_CMD_VERTEX_EOL : PVR_CMD_VERTEX;
-					PVRVertexSubmit( SX, SY, SZ, Vtx.U, Vtx.V, Vtx.ARGB, Flags );
-				}
-			}
-		}
-	};
-
     {
         FPVRClipVert In[64]; FPVRClipVert Clipped[64];
         INT N = 0;
@@ -796,6 +797,90 @@ void UPVRRenderDevice::DrawGouraudPolygon( FSceneNode* Frame, FTextureInfo& Info
 	unguard;
 }
 
+//
+// Mesh strips go out as a single vertex strip, the PVR takes them natively
+// and doesn't cull, so the alternating winding doesn't matter. Strips that
+// reach the near plane are left to the per-triangle path to clip.
+//
+void UPVRRenderDevice::DrawGouraudTriStrip( FSceneNode* Frame, FTextureInfo& Info, FTransTexture** Pts, INT NumPts, DWORD PolyFlags, FSpanBuffer* Span )
+{
+	guard(UPVRRenderDevice::DrawGouraudTriStrip);
+
+	for( INT i = 0; i < NumPts; i++ )
+	{
+		if( Pts[i]->Point.Z <= 1.0f )
+		{
+			URenderDevice::DrawGouraudTriStrip( Frame, Info, Pts, NumPts, PolyFlags, Span );
+			return;
+		}
+	}
+
+	SetSceneNode( Frame );
+	SetBlend( PolyFlags );
+	SetTexture( Info, ( PolyFlags & PF_Masked ), 0 );
+
+	const UBOOL IsModulated = ( PolyFlags & PF_Modulated );
+
+	pvr_poly_hdr_t Hdr; pvr_list_t List;
+	BuildPolyHeader( this, PolyFlags, &Info, Hdr, List );
+
+	FDrawGouraudCallback* CB = new FDrawGouraudCallback;
+	CB->Hdr = Hdr;
+	CB->Frame = Frame;
+	CB->ClippedVerts.Empty( NumPts );
+	for( INT i = 0; i < NumPts; i++ )
+	{
+		FTransTexture* P = Pts[i];
+		FPVRClipVert& V = CB->ClippedVerts( CB->ClippedVerts.Add() );
+		V.X = P->Point.X; V.Y = P->Point.Y; V.Z = P->Point.Z;
+		V.U = P->U * TexInfo.UMult;
+		V.V = P->V * TexInfo.VMult;
+		if( IsModulated ) V.ARGB = 0xFFFFFFFFu; else {
+			const BYTE R = (BYTE)Clamp<INT>(appRound(P->Light.X * 255.f), 0, 255);
+			const BYTE G = (BYTE)Clamp<INT>(appRound(P->Light.Y * 255.f), 0, 255);
+			const BYTE B = (BYTE)Clamp<INT>(appRound(P->Light.Z * 255.f), 0, 255);
+			V.ARGB = (255u<<24) | (R<<16) | (G<<8) | (B);
+		}
+	}
+	if( List == PVR_LIST_OP_POLY )
+		GPVROPCallbacks.AddItem( CB );
+	else if( List == PVR_LIST_PT_POLY )
+		GPVRPTCallbacks.AddItem( CB );
+	else
+		GPVRTRCallbacks.AddItem( CB );
+
+	// Optional fog-only pass
+	if( (PolyFlags & (PF_RenderFog|PF_Translucent|PF_Modulated)) == PF_RenderFog )
+	{
+		pvr_poly_hdr_t FogHdr; pvr_list_t FogList;
+		BuildPolyHeader( this, PF_Highlighted, nullptr, FogHdr, FogList );
+
+		FDrawGouraudCallback* FogCB = new FDrawGouraudCallback;
+		FogCB->Hdr = FogHdr;
+		FogCB->Frame = Frame;
+		FogCB->ClippedVerts.Empty( NumPts );
+		for( INT i = 0; i < NumPts; i++ )
+		{
+			FTransTexture* P = Pts[i];
+			FPVRClipVert& V = FogCB->ClippedVerts( FogCB->ClippedVerts.Add() );
+			V.X = P->Point.X; V.Y = P->Point.Y; V.Z = P->Point.Z;
+			const BYTE A = (BYTE)Clamp<INT>(appRound(P->Fog.W * 255.f), 0, 255);
+			const BYTE R = (BYTE)Clamp<INT>(appRound(P->Fog.X * 255.f), 0, 255);
+			const BYTE G = (BYTE)Clamp<INT>(appRound(P->Fog.Y * 255.f), 0, 255);
+			const BYTE B = (BYTE)Clamp<INT>(appRound(P->Fog.Z * 255.f), 0, 255);
+			V.U = 0.f; V.V = 0.f; V.ARGB = (A<<24)|(R<<16)|(G<<8)|B;
+		}
+		if( FogList == PVR_LIST_OP_POLY )
+			GPVROPCallbacks.AddItem( FogCB );
+		else if( FogList == PVR_LIST_PT_POLY )
+			GPVRPTCallbacks.AddItem( FogCB );
+		else
+			GPVRTRCallbacks.AddItem( FogCB );
+	}
+
+	unguard;
+}
+
 void UPVRRenderDevice::DrawTile( FSceneNode* Frame, FTextureInfo& Texture, FLOAT X, FLOAT Y, FLOAT XL, FLOAT YL, FLOAT U, FLOAT V, FLOAT UL, FLOAT VL, FSpanBuffer* Span, FLOAT Z, FPlane Light, FPlane Fog, DWORD PolyFlags )
 {
 	guard(UPVRRenderDevice::DrawTile);
@@ -1593,12 +1593,17 @@ void FLightManager::SetupForSurf
 		guard(SetupNormalSurface);
 		Mover = NULL;
 
-		// Static lights.
-		BYTE* ShadowBase = &Model->LightBits(Index->DataOffset);
+		// Static lights. Compressed shadow bits are expanded into GMem until FinishSurf.
 		if( Index->iLightActors != INDEX_NONE )
-			for( INT i=0; Model->Lights(i+Index->iLightActors); i++,ShadowBase+=ShadowMaskSpace )
+		{
+			INT NumStaticLights = 0;
+			while( Model->Lights(NumStaticLights+Index->iLightActors) )
+				NumStaticLights++;
+			BYTE* ShadowBase = Model->GetShadowBits( GMem, Index->DataOffset, NumStaticLights*ShadowMaskSpace );
+			for( INT i=0; i<NumStaticLights; i++,ShadowBase+=ShadowMaskSpace )
 				if( AddLight( Mover, Model->Lights(i+Index->iLightActors) ) )
 					LastLight[-1].ShadowBits = ShadowBase;
+		}
 
 		// Dynamic lights.
 		for( FActorLink* Link=Draw->SurfLights; Link; Link=Link->Next )
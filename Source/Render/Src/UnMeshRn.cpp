@@ -264,6 +264,186 @@ void RenderSubsurface
 	High level mesh rendering.
 ------------------------------------------------------------------------------*/
 
+// Strip triangle flags from MarkStrips.
+enum {STRIP_Visible=1, STRIP_Clipped=2};
+
+//
+// Test the visibility of every strip triangle once, on the final (fattened)
+// vertex positions, the same way the per-triangle paths test theirs.
+// Returns flags per strip triangle in GMem, and sets NeedLight for every
+// vertex of a visible triangle so the caller lights and projects it.
+//
+static BYTE* MarkStrips
+(
+	FSceneNode*		Frame,
+	UMesh*			Mesh,
+	FTransTexture*	Samples,
+	DWORD			ExtraFlags,
+	BYTE*			NeedLight
+)
+{
+	guard(MarkStrips);
+	UBOOL CanStrip = (Frame->NearClip.W == 0.0);
+	INT NumTris = 0;
+	for( INT s=0; s<Mesh->Strips.Num(); s++ )
+		NumTris += Mesh->Strips(s).NumWedges - 2;
+	BYTE* TriFlags = NewZeroed<BYTE>(GMem,NumTris);
+	BYTE* Flags = TriFlags;
+	for( INT s=0; s<Mesh->Strips.Num(); s++ )
+	{
+		FMeshStrip& Strip = Mesh->Strips(s);
+		FMeshWedge* Wedges = &Mesh->StripWedges(Strip.FirstWedge);
+		DWORD PolyFlags = Strip.PolyFlags | ExtraFlags;
+		for( INT i=0; i<Strip.NumWedges-2; i++,Flags++ )
+		{
+			INT iVert[3] = { Wedges[i].iVertex, Wedges[i+1].iVertex, Wedges[i+2].iVertex };
+			if( i & 1 )
+				Exchange( iVert[0], iVert[1] );
+			FTransTexture* V[3] = { &Samples[iVert[0]], &Samples[iVert[1]], &Samples[iVert[2]] };
+			if
+			(	iVert[0]!=iVert[1]
+			&&	iVert[1]!=iVert[2]
+			&&	iVert[2]!=iVert[0]
+			&&	!(V[0]->Flags & V[1]->Flags & V[2]->Flags) )
+			{
+				FVector Normal = (V[0]->Point-V[1]->Point) ^ (V[2]->Point-V[0]->Point);
+				if( (PolyFlags & PF_TwoSided) || Frame->Mirror*(V[0]->Point|Normal)<0.0 )
+				{
+					*Flags = STRIP_Visible;
+					if( !CanStrip || (V[0]->Flags | V[1]->Flags | V[2]->Flags) )
+						*Flags |= STRIP_Clipped;
+					NeedLight[iVert[0]] = NeedLight[iVert[1]] = NeedLight[iVert[2]] = 1;
+				}
+			}
+		}
+	}
+	return TriFlags;
+	unguard;
+}
+
+//
+// Draw the precomputed strips of a mesh, with the triangle flags from
+// MarkStrips, once the vertices it asked for have been lit and projected.
+// Runs of visible triangles that need no clipping go to the device as one
+// strip, everything else is drawn per triangle through RenderSubsurface.
+//
+static void RenderStrips
+(
+	FSceneNode*		Frame,
+	UMesh*			Mesh,
+	FTransTexture*	Samples,
+	FSpanBuffer*	Span,
+	DWORD			ExtraFlags,
+	const BYTE*		TriFlags
+)
+{
+	guard(RenderStrips);
+	URenderDevice* RenDev = Frame->Viewport->RenDev;
+	for( INT s=0; s<Mesh->Strips.Num(); s++ )
+	{
+		FMemMark Mark(GMem);
+		FMeshStrip& Strip = Mesh->Strips(s);
+		FMeshWedge* Wedges = &Mesh->StripWedges(Strip.FirstWedge);
+
+		// Get texture.
+		DWORD PolyFlags = Strip.PolyFlags | ExtraFlags;
+		INT Index = Strip.TextureIndex;
+		FTextureInfo& Info = (Textures[Index] && !(PolyFlags & PF_Environment)) ? TextureInfo[Index] : EnvironmentInfo;
+		UScale = Info.UScale * Info.USize / 256.0;
+		VScale = Info.VScale * Info.VSize / 256.0;
+
+		// Copy the samples out, the same vertex can appear with different
+		// texture coords within one strip.
+		FTransTexture*  Verts = New<FTransTexture>(GMem,Strip.NumWedges);
+		FTransTexture** Pts   = New<FTransTexture*>(GMem,Strip.NumWedges);
+		for( INT i=0; i<Strip.NumWedges; i++ )
+		{
+			Verts[i]   = Samples[Wedges[i].iVertex];
+			Verts[i].U = Wedges[i].TexUV.U * UScale;
+			Verts[i].V = Wedges[i].TexUV.V * VScale;
+			if( PolyFlags & PF_Environment )
+				EnviroMap( Frame, Verts[i] );
+			if( PolyFlags & PF_Unlit )
+				Verts[i].Light = GUnlitColor;
+			Pts[i] = &Verts[i];
+		}
+
+		// Split into runs of visible, unclipped triangles.
+		INT RunStart = -1;
+		for( INT i=0; i<=Strip.NumWedges-2; i++ )
+		{
+			UBOOL Visible=0;
+			if( i < Strip.NumWedges-2 )
+			{
+				Visible = TriFlags[i] & STRIP_Visible;
+				if( TriFlags[i]==STRIP_Visible )
+				{
+					if( RunStart < 0 )
+						RunStart = i;
+					continue;
+				}
+			}
+
+			// Flush the current run.
+			if( RunStart >= 0 )
+			{
+				STAT(clock(GStat.MeshTmapTime));
+				RenDev->DrawGouraudTriStrip( Frame, Info, &Pts[RunStart], i+2-RunStart, PolyFlags, Span );
+				STAT(unclock(GStat.MeshTmapTime));
+				STAT(GStat.MeshSubCount++);
+				RunStart = -1;
+			}
+
+			// Clip and draw this one on its own.
+			if( Visible )
+			{
+				FTransTexture* Tri[6] = { Pts[i], Pts[i+1], Pts[i+2] };
+				if( i & 1 )
+					Exchange( Tri[0], Tri[1] );
+				if( Frame->Mirror == -1 )
+					Exchange( Tri[2], Tri[0] );
+				RenderSubsurface( Frame, Info, Span, Tri, PolyFlags, 0 );
+			}
+		}
+		TriFlags += Strip.NumWedges - 2;
+		Mark.Pop();
+	}
+	unguard;
+}
+
+//
+// Vertex normal of a mesh vertex, from the normals of the triangles using it.
+//
+static inline FPlane MeshVertNormal( UMesh* Mesh, FTransSample& Vert, INT iVert, FVector* TriNormals )
+{
+	FVector Norm(0,0,0);
+	FMeshVertConnect& Connect = Mesh->Connects(iVert);
+	for( INT k=0; k<Connect.NumVertTriangles; k++ )
+		Norm += TriNormals[Mesh->VertLinks(Connect.TriangleListOffset + k)];
+	return FPlane( Vert.Point, Norm * DivSqrtApprox(Norm.SizeSquared()) );
+}
+
+//
+// Compute a mesh vertex's normal and push it out along it.
+//
+static inline void FattenMeshVert( FSceneNode* Frame, UMesh* Mesh, FTransSample& Vert, INT iVert, FVector* TriNormals, FLOAT Fatness )
+{
+	Vert.Normal = MeshVertNormal( Mesh, Vert, iVert, TriNormals );
+	Vert.Point += Vert.Normal * Fatness;
+	Vert.ComputeOutcode( Frame );
+}
+
+//
+// Light a mesh vertex whose normal is set, and project it if it's in view.
+//
+static inline void LightMeshVert( FSceneNode* Frame, FTransSample& Vert, DWORD ExtraFlags )
+{
+	Vert.Light = GLightManager->Light( Vert, ExtraFlags );
+	Vert.Fog   = GLightManager->Fog  ( Vert, ExtraFlags );
+	if( !Vert.Flags )
+		Vert.Project( Frame );
+}
+
 //
 // Structure used by DrawMesh for sorting triangles.
 //
@@ -569,9 +749,31 @@ void URender::DrawMesh
 		ExtraFlags |= GLightManager->SetupForActor( Frame, Owner, LeafLights, Volumetrics );
 		STAT(unclock(GStat.MeshLightSetupTime));
 
-		// Perform all vertex lighting.
+		// Perform all vertex lighting. With strips, every vertex is fattened
+		// first and the strips pick the vertices to light, so their visibility
+		// is only tested once, on the final positions.
+		UBOOL UseStrips = Mesh->Strips.Num() && !Frame->Viewport->RenDev->SpanBased && (ExtraFlags & PF_Flat);
+		BYTE* StripTris = NULL;
 		guardSlow(Light);
-		for( INT i=0; i<VisibleTriangles; i++ )
+		if( UseStrips )
+		{
+			BYTE* NeedLight = NewZeroed<BYTE>(GMem,Mesh->FrameVerts);
+			if( Fatten )
+				for( INT i=0; i<Mesh->FrameVerts; i++ )
+					FattenMeshVert( Frame, Mesh, Samples[i], i, TriNormals, Fatness );
+			StripTris = MarkStrips( Frame, Mesh, Samples, ExtraFlags, NeedLight );
+			for( INT i=0; i<Mesh->FrameVerts; i++ )
+			{
+				if( NeedLight[i] )
+				{
+					FTransSample& Vert = Samples[i];
+					if( !Fatten )
+						Vert.Normal = MeshVertNormal( Mesh, Vert, i, TriNormals );
+					LightMeshVert( Frame, Vert, ExtraFlags );
+				}
+			}
+		}
+		else for( INT i=0; i<VisibleTriangles; i++ )
 		{
 			FMeshTri& Tri = *TriPool[i].Tri;
 			for( INT j=0; j<3; j++ )
@@ -580,41 +782,31 @@ void URender::DrawMesh
 				FTransSample& Vert = Samples[iVert];
 				if( Vert.Light.X == -1 )
 				{
-					// Compute vertex normal.
-					FVector Norm(0,0,0);
-					FMeshVertConnect& Connect = Mesh->Connects(iVert);
-					for( INT k=0; k<Connect.NumVertTriangles; k++ )
-						Norm += TriNormals[Mesh->VertLinks(Connect.TriangleListOffset + k)];
-					Vert.Normal = FPlane( Vert.Point, Norm * DivSqrtApprox(Norm.SizeSquared()) );
-
-					// Fatten it if desired.
 					if( Fatten )
-					{
-						Vert.Point += Vert.Normal * Fatness;
-						Vert.ComputeOutcode( Frame );
-					}
-
-					// Compute effect of each lightsource on this vertex.
-					Vert.Light = GLightManager->Light( Vert, ExtraFlags );
-					Vert.Fog   = GLightManager->Fog  ( Vert, ExtraFlags );
-
-					// Project it.
-					if( !Vert.Flags )
-						Vert.Project( Frame );
+						FattenMeshVert( Frame, Mesh, Vert, iVert, TriNormals, Fatness );
+					else
+						Vert.Normal = MeshVertNormal( Mesh, Vert, iVert, TriNormals );
+					LightMeshVert( Frame, Vert, ExtraFlags );
 				}
 			}
 		}
 		unguardSlow;
 
-		// Draw the triangles.
+		// Draw the triangles, from the strips if there are any. Strips leave out
+		// the invisible triangles, so those still go through the pool.
 		guardSlow(DrawVisible);
 		STAT(GStat.MeshPolyCount+=VisibleTriangles);
+		if( UseStrips )
+			RenderStrips( Frame, Mesh, Samples, SpanBuffer, ExtraFlags, StripTris );
 		for( INT i=0; i<VisibleTriangles; i++ )
 		{
 			// Set up the triangle.
 			FMeshTri& Tri = *TriPool[i].Tri;
 			if( !(Tri.PolyFlags & PF_Invisible) )
 			{
+				if( UseStrips )
+					continue;
+
 				// Get texture.
 				DWORD PolyFlags = Tri.PolyFlags | ExtraFlags;
 				INT Index = TriPool[i].Tri->TextureIndex;
@@ -596,19 +596,45 @@ void URender::DrawLodMesh
 		STAT(unclock(GStat.MeshLightSetupTime));
 
 	STAT(clock(GStat.MeshLightTime)); 
-	// Perform all vertex lighting.
+	// At full detail the precomputed strips cover the same faces. Fatten
+	// every vertex first so the strips test their visibility once, on the
+	// final positions, and light the vertices they pick.
 	INT i;
+	BYTE* StripTris = NULL;
+	UBOOL UseStrips = !DoLOD && Mesh->Strips.Num() && !SoftwareRendering;
+	if( UseStrips )
+	{
+		BYTE* NeedLight = NewZeroed<BYTE>(GMem,VertexSubset);
+		for( i=0; i<VertexSubset; i++ )
+		{
+			FTransSample& Vert = Samples[i];
+			Vert.Light.X = 0;
+			Vert.Normal  = FPlane( Vert.Point, Vert.Normal * DivSqrtApprox(Vert.Normal.SizeSquared()+0.001f) );
+			if( Fatten )
+			{
+				Vert.Point += Vert.Normal * Fatness;
+				Vert.ComputeOutcode( Frame );
+			}
+		}
+		StripTris = MarkStrips( Frame, Mesh, Samples, ExtraFlags, NeedLight );
+		for( i=0; i<VertexSubset; i++ )
+			if( NeedLight[i] )
+				Samples[i].Light.X = -1;
+	}
+
+	// Perform all vertex lighting.
 	for( i=0; i<VertexSubset; i++ )
 		{
 			FTransSample& Vert = Samples[i];
 			if( Vert.Light.X == -1 ) // Only light/project if part of a visible triangle.
 			{
 				// Efficiency warning: FPlane ctor has an implicit dot prodoct.
-				Vert.Normal = FPlane( Vert.Point, Vert.Normal * DivSqrtApprox(Vert.Normal.SizeSquared()+0.001f) );					
+				if( !UseStrips )
+					Vert.Normal = FPlane( Vert.Point, Vert.Normal * DivSqrtApprox(Vert.Normal.SizeSquared()+0.001f) );					
 					
 				// Fatten it if desired.
 				
-				if( Fatten )
+				if( Fatten && !UseStrips )
 				{
 					Vert.Point += Vert.Normal * Fatness;
 					Vert.ComputeOutcode( Frame );
@@ -634,7 +660,10 @@ void URender::DrawLodMesh
 		// Reset cached material indicator.
 		MatIndex = -1;
 		FTextureInfo* Info = NULL; 
-		for( i=0; i<FacePool.Num(); i++ )
+
+		if( UseStrips )
+			RenderStrips( Frame, Mesh, Samples, SpanBuffer, ExtraFlags, StripTris );
+		else for( i=0; i<FacePool.Num(); i++ )
 		{
 			// Set up the triangle.
 			FMeshFace &Face = *FacePool(i).Face;
@@ -0,0 +1,60 @@
+//=============================================================================
+/// Script interpreter microbenchmarks, timed by ScriptBenchCommandlet.
+///
+/// Each test runs Count iterations of one kind of script work and returns
+/// a value so the work can't be skipped.
+//=============================================================================
+class ScriptBench
+	expands Object
+	transient;
+
+var int Counter;
+var vector Position;
+
+/// Loops, branches and integer arithmetic on locals and instance variables.
+function int Loops( int Count )
+{
+	local int i, Sum;
+
+	for( i=0; i<Count; i++ )
+	{
+		Sum += i & 7;
+		if( Sum > 1000 )
+			Sum -= 1000;
+		Counter++;
+	}
+	return Sum;
+}
+
+/// Vector operators and functions on local and instance vectors.
+function float VectorMath( int Count )
+{
+	local int i;
+	local vector V, Dir;
+	local float Length;
+
+	Dir = vect(1,2,3);
+	for( i=0; i<Count; i++ )
+	{
+		V = Position + Dir * 0.5;
+		Length += VSize(V) + (V dot Dir);
+		Position = Normal(V + (V cross Dir));
+	}
+	return Length;
+}
+
+/// Callee for VirtualCalls.
+function int Add( int A, int B )
+{
+	return A + B;
+}
+
+/// Non-final function calls, resolved through the class's function hash.
+function int VirtualCalls( int Count )
+{
+	local int i, Sum;
+
+	for( i=0; i<Count; i++ )
+		Sum = Add( Sum, i ) & 65535;
+	return Sum;
+}
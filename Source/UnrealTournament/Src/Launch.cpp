@@ -17,8 +17,13 @@ Revision history:
 extern "C" {TCHAR THIS_PACKAGE[64]=TEXT("Launch");}
 
 // Memory allocator.
+#ifdef PLATFORM_POSIX
+#include "FMallocPool.h"
+FMallocPool Malloc;
+#else
 #include "FMallocAnsi.h"
 FMallocAnsi Malloc;
+#endif
 
 // Log file.
 #include "FOutputDeviceFile.h"
@@ -11,6 +11,7 @@ DEST_SYSTEM_DIR="${REPO_ROOT}/ut99pc/System"
 MESH_PATTERN="${1:-*.u}"
 TEX_PATTERN="${2:-../Textures/*.utx}"
 MAP_PATTERN="${3:-../Maps/Dig.unr}"
+JOBS="${JOBS:-$(nproc || echo 1)}"
 
 cmake -S "${REPO_ROOT}/Source" -B "${BUILD_DIR}" \
   -G "Unix Makefiles" \
@@ -43,7 +44,7 @@ cp "${OUTPUT_DIR}/DCUtil" "${DEST_SYSTEM_DIR}/"
 
 pushd "${DEST_SYSTEM_DIR}" >/dev/null
 export LD_LIBRARY_PATH="${DEST_SYSTEM_DIR}:${LD_LIBRARY_PATH:-}"
-./DCUtil -LOG "CVTUTX=${TEX_PATTERN}" 
+./DCUtil -LOG "CVTUTX=${TEX_PATTERN}" -jobs=${JOBS}
 #./DCUtil.bin "CVTUAX=../Sounds/*.uax"
 #./DCUtil.bin "CVTUMH=${MESH_PATTERN}"
 popd >/dev/null